@@ -0,0 +1,453 @@
+#ifndef LEARN_CPP_BENCHMARK_BENCHMARK_HPP
+#define LEARN_CPP_BENCHMARK_BENCHMARK_HPP
+
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "perf_counters.hpp"
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   A small benchmark harness shared by all bench_*.cpp programs.
+
+   Every benchmark is run `warmup` times untimed, then `repetitions` times
+   timed; the median, p99 (nearest rank), min and mean of the repetitions are
+   reported, per repetition and per item. Results can be written as JSON to
+   track regressions between releases.
+
+   Command line, parsed by BenchmarkOptions::parse:
+       --warmup=N  --reps=N  --cpu=N  --json=PATH  --filter=SUBSTRING
+       --perf
+   Other arguments are left to the benchmark itself (see args()).
+
+   --cpu pins the main thread, and so every thread it starts. Bodies that
+   start threads are run with run_parallel(), which lifts the pinning for
+   their duration; with run() they would all share the one cpu.
+
+   --perf also counts cycles, instructions, cache and branch misses and
+   context switches over the timed repetitions (PerfCounters), reported per
+   item. The counters that can not be opened are left out.
+ */
+struct BenchmarkOptions {
+    int warmup = 2;
+    int repetitions = 10;
+    // pin the main thread to this cpu, -1 means no pinning. Not applied
+    // to run_parallel().
+    int cpu = -1;
+    std::string json_path;
+    std::string filter;
+    bool perf = false;
+    // positional arguments, not starting with "--"
+    std::vector<std::string> args;
+
+    static BenchmarkOptions parse(int argc, char* argv[]) {
+        BenchmarkOptions options;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::string value;
+            if (match_(arg, "--warmup=", value)) {
+                options.warmup = std::atoi(value.c_str());
+            } else if (match_(arg, "--reps=", value)) {
+                options.repetitions = std::max(1, std::atoi(value.c_str()));
+            } else if (match_(arg, "--cpu=", value)) {
+                options.cpu = std::atoi(value.c_str());
+            } else if (match_(arg, "--json=", value)) {
+                options.json_path = value;
+            } else if (match_(arg, "--filter=", value)) {
+                options.filter = value;
+            } else if (arg == "--perf") {
+                options.perf = true;
+            } else {
+                options.args.push_back(arg);
+            }
+        }
+        return options;
+    }
+
+    /** The i-th positional argument as a number, or a default.
+     */
+    std::size_t arg(std::size_t i, std::size_t default_value) const {
+        if (i < args.size()) {
+            return std::strtoull(args[i].c_str(), nullptr, 10);
+        }
+        return default_value;
+    }
+
+   private:
+    static bool match_(const std::string& arg, const char* prefix,
+                       std::string& value) {
+        std::size_t n = std::strlen(prefix);
+        if (arg.compare(0, n, prefix) != 0) {
+            return false;
+        }
+        value = arg.substr(n);
+        return true;
+    }
+};
+
+struct BenchmarkResult {
+    std::string name;
+    // work done by one repetition, for per-item and throughput numbers.
+    std::size_t items = 1;
+    std::size_t bytes = 0;
+    // durations of the timed repetitions, sorted, in nanoseconds.
+    std::vector<double> samples_ns;
+    // summed over the timed repetitions, with --perf.
+    PerfCounters::Values counters;
+
+    BenchmarkResult& set_items(std::size_t n) {
+        items = n;
+        return *this;
+    }
+
+    BenchmarkResult& set_bytes(std::size_t n) {
+        bytes = n;
+        return *this;
+    }
+
+    double median_ns() const { return percentile_ns(50); }
+
+    double p99_ns() const { return percentile_ns(99); }
+
+    double min_ns() const { return samples_ns.front(); }
+
+    double mean_ns() const {
+        double sum = 0;
+        for (double s : samples_ns) {
+            sum += s;
+        }
+        return sum / samples_ns.size();
+    }
+
+    // nearest-rank percentile
+    double percentile_ns(double p) const {
+        std::size_t n = samples_ns.size();
+        std::size_t rank = static_cast<std::size_t>(p / 100.0 * n + 0.999999);
+        rank = std::min(std::max<std::size_t>(rank, 1), n);
+        return samples_ns[rank - 1];
+    }
+
+    double ns_per_item() const { return median_ns() / items; }
+
+    double mb_per_s() const {
+        return bytes == 0 ? 0 : bytes / (median_ns() * 1e-9) / (1 << 20);
+    }
+
+    bool has_counter(int i) const { return counters.available[i]; }
+
+    // mean over the repetitions
+    double counter_per_item(int i) const {
+        return counters.value[i] / samples_ns.size() / items;
+    }
+};
+
+/** Bind the calling thread to one cpu. Returns false if that failed.
+ */
+inline bool pin_to_cpu(int cpu) {
+    if (cpu < 0) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+/** Keep the compiler from optimizing away the computation of value.
+ */
+template <class T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Force pending writes to memory to be considered observable.
+ */
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+class BenchmarkRunner {
+   public:
+    BenchmarkRunner(std::string suite, BenchmarkOptions options)
+        : suite_(std::move(suite)), options_(std::move(options)) {
+        if (options_.cpu >= 0) {
+            CPU_ZERO(&unpinned_);
+            ::sched_getaffinity(0, sizeof(unpinned_), &unpinned_);
+            pinned_ = pin_to_cpu(options_.cpu);
+            if (!pinned_) {
+                std::cerr << "warning: can not pin to cpu " << options_.cpu
+                          << '\n';
+            }
+        }
+        if (options_.perf) {
+            perf_.reset(new PerfCounters());
+            if (!perf_->error().empty()) {
+                std::cerr << "warning: can not open perf counter "
+                          << perf_->error() << '\n';
+            }
+        }
+    }
+
+    ~BenchmarkRunner() {
+        if (!reported_) {
+            report();
+        }
+    }
+
+    const BenchmarkOptions& options() const { return options_; }
+
+    /** Time fn() as one repetition.
+     */
+    template <class Fn>
+    BenchmarkResult& run(const std::string& name, Fn fn) {
+        return run_with_setup(
+            name, []() { return 0; }, [&fn](int) { fn(); });
+    }
+
+    /** Time fn(setup()) as one repetition, setup() is not timed.
+     */
+    template <class Setup, class Fn>
+    BenchmarkResult& run_with_setup(const std::string& name, Setup setup,
+                                    Fn fn) {
+        results_.emplace_back();
+        BenchmarkResult& result = results_.back();
+        result.name = name;
+        if (!selected_(name)) {
+            return result;
+        }
+        for (int i = 0; i < options_.warmup; ++i) {
+            auto state = setup();
+            fn(state);
+        }
+        for (int i = 0; i < options_.repetitions; ++i) {
+            auto state = setup();
+            if (perf_) {
+                perf_->start();
+            }
+            auto start = std::chrono::steady_clock::now();
+            fn(state);
+            auto stop = std::chrono::steady_clock::now();
+            if (perf_) {
+                add_counters_(result.counters, perf_->stop());
+            }
+            result.samples_ns.push_back(
+                std::chrono::duration<double, std::nano>(stop - start)
+                    .count());
+        }
+        std::sort(result.samples_ns.begin(), result.samples_ns.end());
+        return result;
+    }
+
+    /** As run(), for a fn() that starts threads. They inherit the affinity
+        of the main thread, so --cpu is lifted while fn() runs.
+     */
+    template <class Fn>
+    BenchmarkResult& run_parallel(const std::string& name, Fn fn) {
+        return run_parallel_with_setup(
+            name, []() { return 0; }, [&fn](int) { fn(); });
+    }
+
+    template <class Setup, class Fn>
+    BenchmarkResult& run_parallel_with_setup(const std::string& name,
+                                             Setup setup, Fn fn) {
+        if (!pinned_) {
+            return run_with_setup(name, setup, fn);
+        }
+        ::sched_setaffinity(0, sizeof(unpinned_), &unpinned_);
+        struct Repin {
+            int cpu;
+            ~Repin() { pin_to_cpu(cpu); }
+        } repin{options_.cpu};
+        return run_with_setup(name, setup, fn);
+    }
+
+    /** Print a table to stdout, and write JSON if --json was given.
+     */
+    void report() {
+        reported_ = true;
+        std::cout << suite_ << " (" << options_.repetitions << " reps, "
+                  << options_.warmup << " warmup";
+        if (pinned_) {
+            std::cout << ", cpu " << options_.cpu;
+        }
+        std::cout << ")\n";
+        std::cout << std::left << std::setw(52) << "benchmark" << std::right
+                  << std::setw(14) << "median ns" << std::setw(14) << "p99 ns"
+                  << std::setw(12) << "ns/item" << std::setw(12) << "MB/s"
+                  << '\n';
+        for (const auto& r : results_) {
+            if (r.samples_ns.empty()) {
+                continue;
+            }
+            std::cout << std::left << std::setw(52) << r.name << std::right
+                      << std::fixed << std::setprecision(0) << std::setw(14)
+                      << r.median_ns() << std::setw(14) << r.p99_ns()
+                      << std::setprecision(2) << std::setw(12)
+                      << r.ns_per_item() << std::setw(12);
+            if (r.bytes != 0) {
+                std::cout << r.mb_per_s();
+            } else {
+                std::cout << "-";
+            }
+            std::cout << '\n';
+        }
+        if (perf_ && perf_->any_available()) {
+            report_counters_();
+        }
+        std::cout.unsetf(std::ios::fixed);
+        if (!options_.json_path.empty()) {
+            write_json_(options_.json_path);
+        }
+    }
+
+   private:
+    std::string suite_;
+    BenchmarkOptions options_;
+    // a deque, so that references returned by run() stay valid.
+    std::deque<BenchmarkResult> results_;
+    bool pinned_ = false;
+    // the affinity before --cpu, restored by run_parallel().
+    cpu_set_t unpinned_;
+    bool reported_ = false;
+    std::unique_ptr<PerfCounters> perf_;
+
+    static void add_counters_(PerfCounters::Values& sum,
+                              const PerfCounters::Values& v) {
+        for (int i = 0; i < PerfCounters::kCount; ++i) {
+            sum.value[i] += v.value[i];
+            sum.available[i] = v.available[i];
+        }
+    }
+
+    // per item, "-" for the counters that did not open.
+    void report_counters_() const {
+        std::cout << '\n' << std::left << std::setw(52) << "per item"
+                  << std::right;
+        for (int i = 0; i < PerfCounters::kCount; ++i) {
+            std::cout << std::setw(17) << PerfCounters::name(i);
+        }
+        std::cout << std::setw(8) << "IPC" << '\n';
+        for (const auto& r : results_) {
+            if (r.samples_ns.empty()) {
+                continue;
+            }
+            std::cout << std::left << std::setw(52) << r.name << std::right
+                      << std::fixed << std::setprecision(3);
+            for (int i = 0; i < PerfCounters::kCount; ++i) {
+                std::cout << std::setw(17);
+                if (r.has_counter(i)) {
+                    std::cout << r.counter_per_item(i);
+                } else {
+                    std::cout << "-";
+                }
+            }
+            std::cout << std::setw(8);
+            if (r.has_counter(PerfCounters::kCycles) &&
+                r.has_counter(PerfCounters::kInstructions) &&
+                r.counters.value[PerfCounters::kCycles] > 0) {
+                std::cout << std::setprecision(2)
+                          << r.counters.value[PerfCounters::kInstructions] /
+                                 r.counters.value[PerfCounters::kCycles];
+            } else {
+                std::cout << "-";
+            }
+            std::cout << '\n';
+        }
+    }
+
+    bool selected_(const std::string& name) const {
+        return options_.filter.empty() ||
+               name.find(options_.filter) != std::string::npos;
+    }
+
+    static std::string escape_(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out.push_back('\\');
+            }
+            out.push_back(c);
+        }
+        return out;
+    }
+
+    void write_json_(const std::string& path) const {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "warning: can not write " << path << '\n';
+            return;
+        }
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ",
+                      std::gmtime(&now));
+        out << std::setprecision(17);
+        out << "{\n";
+        out << "  \"suite\": \"" << escape_(suite_) << "\",\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << date << "\",\n";
+#if defined(__VERSION__)
+        out << "    \"compiler\": \"" << escape_(__VERSION__) << "\",\n";
+#endif
+#if defined(NDEBUG)
+        out << "    \"ndebug\": true,\n";
+#else
+        out << "    \"ndebug\": false,\n";
+#endif
+        out << "    \"cpu\": " << (pinned_ ? options_.cpu : -1) << ",\n";
+        out << "    \"warmup\": " << options_.warmup << ",\n";
+        out << "    \"repetitions\": " << options_.repetitions << "\n";
+        out << "  },\n";
+        out << "  \"benchmarks\": [";
+        bool first = true;
+        for (const auto& r : results_) {
+            if (r.samples_ns.empty()) {
+                continue;
+            }
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "    {\"name\": \"" << escape_(r.name) << "\""
+                << ", \"items\": " << r.items << ", \"bytes\": " << r.bytes
+                << ", \"median_ns\": " << r.median_ns()
+                << ", \"p99_ns\": " << r.p99_ns()
+                << ", \"min_ns\": " << r.min_ns()
+                << ", \"mean_ns\": " << r.mean_ns()
+                << ", \"ns_per_item\": " << r.ns_per_item()
+                << ", \"mb_per_s\": " << r.mb_per_s();
+            if (perf_) {
+                out << ", \"counters_per_item\": {";
+                const char* sep = "";
+                for (int i = 0; i < PerfCounters::kCount; ++i) {
+                    if (r.has_counter(i)) {
+                        out << sep << "\"" << PerfCounters::name(i)
+                            << "\": " << r.counter_per_item(i);
+                        sep = ", ";
+                    }
+                }
+                out << "}";
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
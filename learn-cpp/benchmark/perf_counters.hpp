@@ -0,0 +1,163 @@
+#ifndef LEARN_CPP_BENCHMARK_PERF_COUNTERS_HPP
+#define LEARN_CPP_BENCHMARK_PERF_COUNTERS_HPP
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   Hardware and software counters of the calling process (and the threads
+   it starts afterwards), read through perf_event_open(2).
+
+   Every counter is opened on its own, the hardware ones user space only,
+   so each one works or not independently: in a VM or a container without
+   a PMU the hardware counters fail to open and only the software one
+   (context switches) counts. available(i) tells which; nothing else
+   changes. With kernel.perf_event_paranoid above 2 none of them open.
+
+   When the kernel multiplexes more counters than the PMU has, a value is
+   scaled by time_enabled / time_running.
+ */
+class PerfCounters {
+   public:
+    enum Counter {
+        kCycles,
+        kInstructions,
+        kL1dMisses,
+        kLlcMisses,
+        kBranchMisses,
+        kContextSwitches,
+        kCount
+    };
+
+    struct Values {
+        double value[kCount] = {};
+        bool available[kCount] = {};
+    };
+
+    PerfCounters() {
+        open_(kCycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open_(kInstructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open_(kL1dMisses, PERF_TYPE_HW_CACHE,
+              PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        open_(kLlcMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open_(kBranchMisses, PERF_TYPE_HARDWARE,
+              PERF_COUNT_HW_BRANCH_MISSES);
+        open_(kContextSwitches, PERF_TYPE_SOFTWARE,
+              PERF_COUNT_SW_CONTEXT_SWITCHES);
+    }
+
+    ~PerfCounters() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    // not copyable
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    static const char* name(int i) {
+        static const char* const names[kCount] = {
+            "cycles",      "instructions", "l1d_misses",
+            "llc_misses",  "branch_misses", "context_switches"};
+        return names[i];
+    }
+
+    bool available(int i) const { return fds_[i] >= 0; }
+
+    /** True if at least one counter opened.
+     */
+    bool any_available() const {
+        for (int i = 0; i < kCount; ++i) {
+            if (available(i)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Why the first counter that failed did not open, empty if none.
+     */
+    const std::string& error() const { return error_; }
+
+    void start() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    /** The counts since start().
+     */
+    Values stop() {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        Values v;
+        for (int i = 0; i < kCount; ++i) {
+            v.available[i] = read_(fds_[i], v.value[i]);
+        }
+        return v;
+    }
+
+   private:
+    int fds_[kCount] = {-1, -1, -1, -1, -1, -1};
+    std::string error_;
+
+    void open_(int i, std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        // a context switch happens in the kernel
+        attr.exclude_kernel = type != PERF_TYPE_SOFTWARE;
+        attr.exclude_hv = 1;
+        attr.read_format =
+            PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fds_[i] = static_cast<int>(
+            ::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fds_[i] < 0 && error_.empty()) {
+            error_ = std::string(name(i)) + ": " + std::strerror(errno);
+        }
+    }
+
+    static bool read_(int fd, double& value) {
+        std::uint64_t buf[3];
+        if (fd < 0 || ::read(fd, buf, sizeof(buf)) != sizeof(buf) ||
+            buf[2] == 0) {
+            value = 0;
+            return fd >= 0;
+        }
+        value = double(buf[0]);
+        if (buf[2] < buf[1]) {
+            // multiplexed
+            value *= double(buf[1]) / double(buf[2]);
+        }
+        return true;
+    }
+};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "perf_counters.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::PerfCounters;
+
+void test_perf_counters_1();
+void test_perf_counters_2();
+void test_perf_counters_3();
+
+int main() {
+    test_perf_counters_1();
+    test_perf_counters_2();
+    test_perf_counters_3();
+}
+
+std::uint64_t spin(int n) {
+    std::uint64_t x = 1;
+    for (int i = 0; i < n; ++i) {
+        x = x * 6364136223846793005u + 1442695040888963407u;
+        learn_cpp::detail::do_not_optimize(x);
+    }
+    return x;
+}
+
+// whatever opens counts, the rest reports unavailable
+void test_perf_counters_1() {
+    PerfCounters counters;
+    SHOW(counters.error());
+    for (int i = 0; i < PerfCounters::kCount; ++i) {
+        std::cout << PerfCounters::name(i) << ": "
+                  << (counters.available(i) ? "available" : "unavailable")
+                  << '\n';
+    }
+    assert(counters.error().empty() == [&counters]() {
+        for (int i = 0; i < PerfCounters::kCount; ++i) {
+            if (!counters.available(i)) {
+                return false;
+            }
+        }
+        return true;
+    }());
+
+    counters.start();
+    spin(1000000);
+    auto v = counters.stop();
+    for (int i = 0; i < PerfCounters::kCount; ++i) {
+        assert(v.available[i] == counters.available(i));
+        assert(v.value[i] >= 0);
+        if (!v.available[i]) {
+            assert(v.value[i] == 0);
+        }
+    }
+    if (v.available[PerfCounters::kInstructions]) {
+        SHOW(v.value[PerfCounters::kInstructions]);
+        assert(v.value[PerfCounters::kInstructions] > 1000000);
+    }
+
+    // stopped: nothing counts until the next start()
+    counters.start();
+    auto empty = counters.stop();
+    spin(1000000);
+    if (empty.available[PerfCounters::kInstructions]) {
+        assert(empty.value[PerfCounters::kInstructions] <
+               v.value[PerfCounters::kInstructions]);
+    }
+}
+
+// the software counter sees the context switches of sleeping threads
+void test_perf_counters_2() {
+    PerfCounters counters;
+    if (!counters.available(PerfCounters::kContextSwitches)) {
+        std::cout << "context switches unavailable, skipped\n";
+        return;
+    }
+    counters.start();
+    std::thread worker([]() {
+        for (int i = 0; i < 10; ++i) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    for (int i = 0; i < 10; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    worker.join();
+    auto v = counters.stop();
+    SHOW(v.value[PerfCounters::kContextSwitches]);
+    assert(v.value[PerfCounters::kContextSwitches] >= 10);
+}
+
+// the harness with --perf
+void test_perf_counters_3() {
+    const char* argv[] = {"test", "--perf", "--warmup=0", "--reps=2"};
+    auto options = BenchmarkOptions::parse(4, const_cast<char**>(argv));
+    assert(options.perf && options.repetitions == 2);
+
+    BenchmarkRunner runner("perf", options);
+    auto& sleeper = runner.run("sleep", []() {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    });
+    sleeper.set_items(1);
+    if (sleeper.has_counter(PerfCounters::kContextSwitches)) {
+        // one per repetition at least, averaged
+        assert(sleeper.counter_per_item(PerfCounters::kContextSwitches) >= 1);
+    }
+    runner.run("spin", []() { spin(100000); }).set_items(100000);
+    runner.report();
+
+    auto plain = BenchmarkOptions::parse(1, const_cast<char**>(argv));
+    assert(!plain.perf);
+}
@@ -0,0 +1,160 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "bit_vector.hpp"
+
+/**
+ * Two filter bitmaps over the same rows, one in 2 rows set, one in 8:
+ * AND them, count the rows left, visit them, in a v1::vector<bool> (a byte
+ * per row), a std::vector<bool> and a bit_vector. Then rank and select
+ * from a rank_select_index on random positions vs a scan of the words.
+ *
+ * Usage: bench_bit_vector.out [rows] [queries] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::bit_vector;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::rank_select_index;
+
+using ByteVector = learn_cpp::detail::v1::vector<bool>;
+
+template <class Bools>
+void bench_bools(BenchmarkRunner& runner, const std::string& name,
+                 const Bools& a, const Bools& b) {
+    std::size_t n = a.size();
+    Bools out(n);
+    runner
+        .run(name + "/and",
+             [&]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     out[i] = a[i] && b[i];
+                 }
+                 do_not_optimize(out);
+             })
+        .set_items(n);
+    runner
+        .run(name + "/count",
+             [&]() {
+                 std::size_t count = 0;
+                 for (std::size_t i = 0; i < n; ++i) {
+                     count += out[i];
+                 }
+                 do_not_optimize(count);
+             })
+        .set_items(n);
+    runner
+        .run(name + "/visit",
+             [&]() {
+                 std::size_t sum = 0;
+                 for (std::size_t i = 0; i < n; ++i) {
+                     if (out[i]) {
+                         sum += i;
+                     }
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1 << 26);
+    std::size_t queries = options.arg(1, 1 << 20);
+    BenchmarkRunner runner("bit_vector", options);
+    std::mt19937_64 rng(1);
+
+    ByteVector bytes_a(n), bytes_b(n);
+    std::vector<bool> std_a(n), std_b(n);
+    bit_vector bits_a(n), bits_b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t r = rng();
+        bool a = r % 2 == 0, b = (r >> 8) % 8 == 0;
+        bytes_a[i] = a;
+        bytes_b[i] = b;
+        std_a[i] = a;
+        std_b[i] = b;
+        bits_a.set(i, a);
+        bits_b.set(i, b);
+    }
+
+    bench_bools(runner, "v1::vector<bool>", bytes_a, bytes_b);
+    bench_bools(runner, "std::vector<bool>", std_a, std_b);
+
+    bit_vector out(n);
+    runner
+        .run("bit_vector/and",
+             [&]() {
+                 out = bits_a;
+                 out &= bits_b;
+                 do_not_optimize(out);
+             })
+        .set_items(n);
+    runner.run("bit_vector/count", [&]() { do_not_optimize(out.count()); })
+        .set_items(n);
+    runner
+        .run("bit_vector/visit",
+             [&]() {
+                 std::size_t sum = 0;
+                 out.for_each_set([&sum](std::size_t i) { sum += i; });
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+
+    rank_select_index index(out);
+    std::vector<std::size_t> positions(queries), ranks(queries);
+    for (std::size_t q = 0; q < queries; ++q) {
+        positions[q] = rng() % n;
+        ranks[q] = rng() % index.ones();
+    }
+    runner
+        .run("rank/index",
+             [&]() {
+                 std::size_t sum = 0;
+                 for (std::size_t p : positions) {
+                     sum += index.rank(p);
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(queries);
+    runner
+        .run("select/index",
+             [&]() {
+                 std::size_t sum = 0;
+                 for (std::size_t k : ranks) {
+                     sum += index.select(k);
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(queries);
+    // a scan of the words, on 1/4096 of the queries
+    std::size_t scans = queries / 4096;
+    runner
+        .run("rank/scan",
+             [&]() {
+                 std::size_t sum = 0;
+                 for (std::size_t q = 0; q < scans; ++q) {
+                     const std::uint64_t* w = out.words();
+                     std::size_t i = positions[q], rank = 0;
+                     for (std::size_t k = 0; k < i / 64; ++k) {
+                         rank += std::size_t(__builtin_popcountll(w[k]));
+                     }
+                     sum += rank;
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(scans);
+    runner.report();
+
+    std::cout << "\nmemory: v1::vector<bool> " << bytes_a.capacity()
+              << " bytes, bit_vector " << out.memory_bytes()
+              << " bytes, rank_select_index " << index.memory_bytes()
+              << " bytes\n";
+}
@@ -0,0 +1,59 @@
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "cow_vector.hpp"
+
+/**
+ * cow_vector vs v1::vector: taking a snapshot (copy), reading through a
+ * handle, and the first write after a copy (detach).
+ *
+ * Usage: bench_cow_vector.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::cow_vector;
+using learn_cpp::detail::do_not_optimize;
+namespace v1 = learn_cpp::detail::v1;
+
+template <class Vector>
+void bench_vector(BenchmarkRunner& runner, const std::string& name,
+                  std::size_t n) {
+    Vector vec(n, 1);
+    runner
+        .run(name + "/copy",
+             [&vec]() {
+                 Vector copy(vec);
+                 do_not_optimize(copy.size());
+             })
+        .set_bytes(n * sizeof(long));
+    runner
+        .run(name + "/read",
+             [&vec, n]() {
+                 const Vector& cref = vec;
+                 long sum = 0;
+                 for (std::size_t i = 0; i < n; ++i) {
+                     sum += cref[i];
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+    runner
+        .run(name + "/copy+write",
+             [&vec]() {
+                 Vector copy(vec);
+                 copy[0] = 2;
+                 do_not_optimize(copy[0]);
+             })
+        .set_bytes(n * sizeof(long));
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    BenchmarkRunner runner("cow_vector", options);
+
+    bench_vector<v1::vector<long>>(runner, "v1::vector", n);
+    bench_vector<cow_vector<long>>(runner, "cow_vector", n);
+}
@@ -0,0 +1,113 @@
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "flat_hash_map.hpp"
+
+/**
+ * flat_hash_map vs std::unordered_map: insert (with and without reserve),
+ * lookups that hit, lookups that miss, and erase/insert churn.
+ *
+ * Usage: bench_flat_hash_map.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::flat_hash_map;
+
+// n distinct pseudo-random keys, the odd ones are never inserted.
+std::vector<std::uint64_t> make_keys(std::size_t n) {
+    std::vector<std::uint64_t> keys(n);
+    std::uint64_t x = 88172645463325252ull;
+    for (auto& k : keys) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        k = x << 1;
+    }
+    return keys;
+}
+
+template <class Map>
+void bench_map(BenchmarkRunner& runner, const std::string& name,
+               const std::vector<std::uint64_t>& keys) {
+    std::size_t n = keys.size();
+    runner
+        .run(name + "/insert",
+             [&keys]() {
+                 Map map;
+                 for (auto k : keys) {
+                     map[k] = k;
+                 }
+                 do_not_optimize(map.size());
+             })
+        .set_items(n);
+    runner
+        .run(name + "/reserve+insert",
+             [&keys]() {
+                 Map map;
+                 map.reserve(keys.size());
+                 for (auto k : keys) {
+                     map[k] = k;
+                 }
+                 do_not_optimize(map.size());
+             })
+        .set_items(n);
+
+    Map map;
+    for (auto k : keys) {
+        map[k] = k;
+    }
+    runner
+        .run(name + "/find_hit",
+             [&map, &keys]() {
+                 std::uint64_t sum = 0;
+                 for (auto k : keys) {
+                     sum += map.find(k)->second;
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+    runner
+        .run(name + "/find_miss",
+             [&map, &keys]() {
+                 std::size_t misses = 0;
+                 for (auto k : keys) {
+                     misses += map.find(k | 1) == map.end();
+                 }
+                 do_not_optimize(misses);
+             })
+        .set_items(n);
+    runner
+        .run(name + "/erase+insert",
+             [&map, &keys]() {
+                 for (auto k : keys) {
+                     map.erase(k);
+                     map[k | 1] = k;
+                 }
+                 for (auto k : keys) {
+                     map.erase(k | 1);
+                     map[k] = k;
+                 }
+                 do_not_optimize(map.size());
+             })
+        .set_items(4 * n);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    BenchmarkRunner runner("flat_hash_map", options);
+
+    std::size_t large = options.arg(0, 1000000);
+    for (std::size_t n : {std::size_t(1000), large}) {
+        auto keys = make_keys(n);
+        std::string suffix = "(" + std::to_string(n) + ")";
+        bench_map<flat_hash_map<std::uint64_t, std::uint64_t>>(
+            runner, "flat_hash_map" + suffix, keys);
+        bench_map<std::unordered_map<std::uint64_t, std::uint64_t>>(
+            runner, "std::unordered_map" + suffix, keys);
+    }
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "flat_map.hpp"
+
+/**
+ * Lookup latency of flat_set (sorted and Eytzinger layouts) vs
+ * std::lower_bound over a std::vector and std::map, for 1K keys up to
+ * max_keys, 10x apart. std::map stops at 10M keys (memory).
+ *
+ * Usage: bench_flat_map.out [max_keys] [lookups] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::eytzinger_layout;
+using learn_cpp::detail::flat_set;
+using learn_cpp::detail::sorted_layout;
+
+using Key = std::uint32_t;
+
+std::vector<Key> random_keys(std::size_t n, std::uint64_t seed) {
+    std::vector<Key> keys(n);
+    std::uint64_t x = seed;
+    for (auto& k : keys) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        k = static_cast<Key>(x);
+    }
+    return keys;
+}
+
+// each lookup depends on the previous one, so this is latency, not
+// throughput.
+template <class Find>
+void bench_lookups(BenchmarkRunner& runner, const std::string& name,
+                   const std::vector<Key>& queries, Find find) {
+    runner
+        .run(name,
+             [&queries, &find]() {
+                 std::size_t last = 0;
+                 for (Key q : queries) {
+                     last = find(q ^ static_cast<Key>(last & 1));
+                 }
+                 do_not_optimize(last);
+             })
+        .set_items(queries.size());
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t max_keys = options.arg(0, 10000000);
+    std::size_t lookups = options.arg(1, 1000000);
+    BenchmarkRunner runner("flat_map", options);
+
+    auto queries = random_keys(lookups, 2463534242ull);
+    for (std::size_t n = 1000; n <= max_keys; n *= 10) {
+        auto keys = random_keys(n, 88172645463325252ull);
+        std::string suffix = "(" + std::to_string(n) + ")";
+        {
+            flat_set<Key> set(keys.begin(), keys.end());
+            bench_lookups(runner, "flat_set<sorted>" + suffix, queries,
+                          [&set](Key q) { return set.lower_bound_index(q); });
+        }
+        {
+            flat_set<Key, std::less<Key>, eytzinger_layout> set(keys.begin(),
+                                                                keys.end());
+            bench_lookups(runner, "flat_set<eytzinger>" + suffix, queries,
+                          [&set](Key q) { return set.lower_bound_index(q); });
+        }
+        {
+            std::vector<Key> sorted(keys);
+            std::sort(sorted.begin(), sorted.end());
+            bench_lookups(runner, "std::lower_bound" + suffix, queries,
+                          [&sorted](Key q) {
+                              return std::size_t(
+                                  std::lower_bound(sorted.begin(),
+                                                   sorted.end(), q) -
+                                  sorted.begin());
+                          });
+        }
+        if (n <= 10000000) {
+            std::map<Key, Key> map;
+            for (Key k : keys) {
+                map.emplace(k, k);
+            }
+            bench_lookups(runner, "std::map" + suffix, queries,
+                          [&map](Key q) {
+                              auto it = map.lower_bound(q);
+                              return std::size_t(it == map.end() ? 0
+                                                                 : it->second);
+                          });
+        }
+    }
+}
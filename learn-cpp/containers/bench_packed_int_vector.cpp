@@ -0,0 +1,117 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "packed_int_vector.hpp"
+
+/**
+ * Memory footprint and scan throughput of packed_int_vector (20 bit IDs)
+ * and delta_packed_int_vector (sorted ns timestamps, 1-20 us apart), vs the
+ * same values in a v1::vector<uint64_t>. A scan sums all the values:
+ * element by element, or decode() into a buffer of 1024. MB/s is in bytes
+ * of the plain vector.
+ *
+ * Usage: bench_packed_int_vector.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::delta_packed_int_vector;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::packed_int_vector;
+
+using Vector = learn_cpp::detail::v1::vector<std::uint64_t>;
+
+constexpr std::size_t kBuffer = 1024;
+
+template <class Packed>
+std::uint64_t decode_sum(const Packed& packed) {
+    std::uint64_t buffer[kBuffer];
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < packed.size(); i += kBuffer) {
+        std::size_t n =
+            packed.size() - i < kBuffer ? packed.size() - i : kBuffer;
+        packed.decode(i, n, buffer);
+        for (std::size_t j = 0; j < n; ++j) {
+            sum += buffer[j];
+        }
+    }
+    return sum;
+}
+
+template <class Packed>
+void run(BenchmarkRunner& runner, const std::string& name,
+         const Vector& plain, const Packed& packed, std::string& report) {
+    std::size_t n = plain.size();
+    std::size_t bytes = n * sizeof(std::uint64_t);
+    runner
+        .run(name + "/plain_scan",
+             [&plain]() {
+                 std::uint64_t sum = 0;
+                 for (std::size_t i = 0; i < plain.size(); ++i) {
+                     sum += plain[i];
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n)
+        .set_bytes(bytes);
+    runner
+        .run(name + "/operator[]_scan",
+             [&packed]() {
+                 std::uint64_t sum = 0;
+                 for (std::size_t i = 0; i < packed.size(); ++i) {
+                     sum += packed[i];
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n)
+        .set_bytes(bytes);
+    runner
+        .run(name + "/decode_scan",
+             [&packed]() { do_not_optimize(decode_sum(packed)); })
+        .set_items(n)
+        .set_bytes(bytes);
+    report += name + ": plain " + std::to_string(plain.capacity() * 8) +
+              " bytes, packed " + std::to_string(packed.memory_bytes()) +
+              " bytes (" +
+              std::to_string(double(packed.memory_bytes()) * 8 / double(n)) +
+              " bits per value)\n";
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1 << 24);
+    BenchmarkRunner runner("packed_int_vector", options);
+    std::mt19937_64 rng(1);
+    std::string report;
+
+    {
+        Vector plain;
+        plain.reserve(n);
+        packed_int_vector packed(20);
+        packed.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint64_t id = rng() % (1 << 20);
+            plain.push_back(id);
+            packed.push_back(id);
+        }
+        run(runner, "ids/20bit", plain, packed, report);
+    }
+    {
+        Vector plain;
+        plain.reserve(n);
+        delta_packed_int_vector packed;
+        std::uint64_t t = 1700000000000000000u;
+        for (std::size_t i = 0; i < n; ++i) {
+            t += 1000 + rng() % 19000;
+            plain.push_back(t);
+            packed.push_back(t);
+        }
+        run(runner, "timestamps/delta", plain, packed, report);
+    }
+    runner.report();
+    std::cout << '\n' << report;
+}
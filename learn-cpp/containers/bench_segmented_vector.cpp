@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "segmented_vector.hpp"
+
+/**
+ * segmented_vector vs v1::vector and std::vector: append throughput, the
+ * slowest single push_back, and scans.
+ *
+ * Usage: bench_segmented_vector.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::segmented_vector;
+
+template <class Vector>
+void bench_push_back(BenchmarkRunner& runner, const std::string& name,
+                     std::size_t n) {
+    runner
+        .run(name + "/push_back",
+             [n]() {
+                 Vector vec;
+                 for (std::size_t i = 0; i < n; ++i) {
+                     vec.push_back(static_cast<long>(i));
+                 }
+                 do_not_optimize(vec[n / 2]);
+             })
+        .set_items(n);
+}
+
+// The reallocation spike: the slowest push_back out of n.
+template <class Vector>
+void worst_push_back(const std::string& name, std::size_t n) {
+    using clock = std::chrono::steady_clock;
+    Vector vec;
+    clock::duration worst{0};
+    for (std::size_t i = 0; i < n; ++i) {
+        auto start = clock::now();
+        vec.push_back(static_cast<long>(i));
+        worst = std::max(worst, clock::now() - start);
+    }
+    do_not_optimize(vec[n / 2]);
+    std::cout << name << "/worst_push_back: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(worst)
+                     .count()
+              << " us\n";
+}
+
+template <class Vector>
+void bench_scan(BenchmarkRunner& runner, const std::string& name,
+                std::size_t n) {
+    Vector vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(static_cast<long>(i));
+    }
+    runner
+        .run(name + "/scan",
+             [&vec]() {
+                 long sum = 0;
+                 for (auto item : vec) {
+                     sum += item;
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n)
+        .set_bytes(n * sizeof(long));
+}
+
+void bench_segment_scan(BenchmarkRunner& runner, std::size_t n) {
+    segmented_vector<long> vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(static_cast<long>(i));
+    }
+    runner
+        .run("segmented_vector/segment_scan",
+             [&vec]() {
+                 long sum = 0;
+                 vec.for_each_segment([&sum](const long* first,
+                                             const long* last) {
+                     for (; first != last; ++first) {
+                         sum += *first;
+                     }
+                 });
+                 do_not_optimize(sum);
+             })
+        .set_items(n)
+        .set_bytes(n * sizeof(long));
+}
+
+int main(int argc, char* argv[]) {
+    using learn_cpp::detail::v1::vector;
+
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 4000000);
+    BenchmarkRunner runner("segmented_vector", options);
+
+    bench_push_back<std::vector<long>>(runner, "std::vector", n);
+    bench_push_back<vector<long>>(runner, "v1::vector", n);
+    bench_push_back<segmented_vector<long>>(runner, "segmented_vector", n);
+    bench_scan<std::vector<long>>(runner, "std::vector", n);
+    bench_scan<segmented_vector<long>>(runner, "segmented_vector", n);
+    bench_segment_scan(runner, n);
+    runner.report();
+
+    worst_push_back<std::vector<long>>("std::vector", n);
+    worst_push_back<vector<long>>("v1::vector", n);
+    worst_push_back<segmented_vector<long>>("segmented_vector", n);
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/shared_ptr.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "slot_map.hpp"
+
+/**
+ * A pool of entities, as a slot_map<Entity> with handles vs a
+ * v1::vector<SharedPtr<Entity>>, the pointers in random order as after a
+ * while of churn:
+ *   churn:  erase a random entity, create a new one
+ *   scan:   update every entity
+ *   lookup: read the entity of a random handle / pointer
+ *
+ * Usage: bench_slot_map.out [entities] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::SharedPtr;
+using learn_cpp::detail::slot_handle;
+using learn_cpp::detail::slot_map;
+
+struct Entity {
+    float x = 0, y = 0, vx = 1, vy = 2;
+    std::uint32_t id = 0;
+};
+
+void update(Entity& e) {
+    e.x += e.vx;
+    e.y += e.vy;
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1 << 20);
+    BenchmarkRunner runner("slot_map", options);
+    std::mt19937_64 rng(1);
+
+    using Pointers = learn_cpp::detail::v1::vector<SharedPtr<Entity>>;
+    Pointers pointers;
+    pointers.reserve(n);
+    std::vector<Entity*> raw;
+    for (std::size_t i = 0; i < n; ++i) {
+        raw.push_back(new Entity());
+    }
+    std::shuffle(raw.begin(), raw.end(), rng);
+    for (Entity* e : raw) {
+        pointers.push_back(SharedPtr<Entity>(e));
+    }
+
+    slot_map<Entity> pool(n);
+    std::vector<slot_handle> handles;
+    for (std::size_t i = 0; i < n; ++i) {
+        handles.push_back(pool.emplace());
+    }
+
+    std::vector<std::size_t> victims(n);
+    for (std::size_t& v : victims) {
+        v = rng() % n;
+    }
+
+    runner
+        .run("churn/SharedPtr",
+             [&]() {
+                 for (std::size_t k : victims) {
+                     std::swap(pointers[k], pointers[n - 1]);
+                     pointers.pop_back();
+                     pointers.push_back(SharedPtr<Entity>(new Entity()));
+                 }
+                 do_not_optimize(pointers.data());
+             })
+        .set_items(n);
+    runner
+        .run("churn/slot_map",
+             [&]() {
+                 for (std::size_t k : victims) {
+                     pool.erase(handles[k]);
+                     handles[k] = pool.emplace();
+                 }
+                 do_not_optimize(pool.begin());
+             })
+        .set_items(n);
+
+    runner
+        .run("scan/SharedPtr",
+             [&]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     update(*pointers[i]);
+                 }
+                 do_not_optimize(pointers.data());
+             })
+        .set_items(n)
+        .set_bytes(n * sizeof(Entity));
+    runner
+        .run("scan/slot_map",
+             [&]() {
+                 for (Entity& e : pool) {
+                     update(e);
+                 }
+                 do_not_optimize(pool.begin());
+             })
+        .set_items(n)
+        .set_bytes(n * sizeof(Entity));
+
+    runner
+        .run("lookup/SharedPtr",
+             [&]() {
+                 float sum = 0;
+                 for (std::size_t k : victims) {
+                     sum += pointers[k]->x;
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+    runner
+        .run("lookup/slot_map",
+             [&]() {
+                 float sum = 0;
+                 for (std::size_t k : victims) {
+                     sum += pool[handles[k]].x;
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+    runner.report();
+}
@@ -0,0 +1,52 @@
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "static_vector.hpp"
+
+/**
+ * Short-lived small vectors: static_vector (inline) vs v1::vector (one
+ * allocation, plus growth) with and without reserve.
+ *
+ * Usage: bench_static_vector.out [rounds] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::static_vector;
+
+template <class Vector>
+void bench_small(BenchmarkRunner& runner, const std::string& name,
+                 std::size_t rounds, bool reserve) {
+    runner
+        .run(name,
+             [rounds, reserve]() {
+                 long sum = 0;
+                 for (std::size_t r = 0; r < rounds; ++r) {
+                     Vector vec;
+                     if (reserve) {
+                         vec.reserve(16);
+                     }
+                     for (long i = 0; i < 16; ++i) {
+                         vec.push_back(i + static_cast<long>(r));
+                     }
+                     sum += vec[r % 16];
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(rounds * 16);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t rounds = options.arg(0, 1000000);
+    BenchmarkRunner runner("static_vector", options);
+
+    bench_small<static_vector<long, 16>>(runner, "static_vector<long, 16>",
+                                         rounds, false);
+    bench_small<learn_cpp::detail::v1::vector<long>>(runner, "v1::vector",
+                                                     rounds, false);
+    bench_small<learn_cpp::detail::v1::vector<long>>(
+        runner, "v1::vector+reserve", rounds, true);
+}
@@ -0,0 +1,382 @@
+#ifndef LEARN_CPP_CONTAINERS_BIT_VECTOR_HPP
+#define LEARN_CPP_CONTAINERS_BIT_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_BIT_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   A vector of bits, 64 to a word of a v1::vector<uint64_t>: 1/8 of the
+   memory of a v1::vector<bool>, which stores a byte per flag.
+
+   The bulk operations work a word at a time: &=, |=, ^= and flip() are one
+   instruction per 64 bits, count() one popcount per word, and for_each_set()
+   jumps from set bit to set bit with ctz. The bits past size() in the last
+   word are kept zero, so none of them needs a special case.
+
+   For O(1) rank and select over a bit_vector that no longer changes, build
+   a rank_select_index on it.
+ */
+class bit_vector {
+   public:
+    // types
+    // clang-format off
+    using value_type             = bool;
+    using size_type              = std::size_t;
+    // clang-format on
+
+    static constexpr size_type npos = ~size_type(0);
+
+    // construct/copy/destroy:
+    bit_vector() = default;
+
+    explicit bit_vector(size_type n, bool value = false)
+        : words_(words_for_(n), value ? ~std::uint64_t(0) : 0), size_(n) {
+        clear_tail_();
+    }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    void reserve(size_type n) { words_.reserve(words_for_(n)); }
+
+    std::size_t memory_bytes() const noexcept {
+        return words_.capacity() * sizeof(std::uint64_t);
+    }
+
+    void resize(size_type n, bool value = false) {
+        if (n > size_ && value && size_ % 64 != 0) {
+            words_[words_.size() - 1] |= ~std::uint64_t(0) << (size_ % 64);
+        }
+        words_.resize(words_for_(n), value ? ~std::uint64_t(0) : 0);
+        size_ = n;
+        clear_tail_();
+    }
+
+    // element access:
+    bool operator[](size_type i) const {
+        ASSERT(i < size_, "out of range access");
+        return (words_[i / 64] >> (i % 64)) & 1;
+    }
+
+    bool test(size_type i) const {
+        if (i >= size_) {
+            throw std::out_of_range("bit_vector::test");
+        }
+        return (*this)[i];
+    }
+
+    const std::uint64_t* words() const noexcept { return words_.data(); }
+    size_type word_count() const noexcept { return words_.size(); }
+
+    // modifiers:
+    void set(size_type i, bool value = true) {
+        ASSERT(i < size_, "out of range access");
+        std::uint64_t bit = std::uint64_t(1) << (i % 64);
+        std::uint64_t& w = words_[i / 64];
+        w = value ? w | bit : w & ~bit;
+    }
+
+    void reset(size_type i) { set(i, false); }
+
+    void flip(size_type i) {
+        ASSERT(i < size_, "out of range access");
+        words_[i / 64] ^= std::uint64_t(1) << (i % 64);
+    }
+
+    void push_back(bool value) {
+        if (size_ % 64 == 0) {
+            words_.push_back(0);
+        }
+        words_[words_.size() - 1] |= std::uint64_t(value) << (size_ % 64);
+        ++size_;
+    }
+
+    void clear() noexcept {
+        words_.clear();
+        size_ = 0;
+    }
+
+    void swap(bit_vector& x) noexcept {
+        words_.swap(x.words_);
+        std::swap(size_, x.size_);
+    }
+
+    // bulk operations, on vectors of the same size (or
+    // std::invalid_argument):
+    bit_vector& operator&=(const bit_vector& x) {
+        check_same_size_(x);
+        std::uint64_t* p = words_.data();
+        const std::uint64_t* q = x.words_.data();
+        for (size_type k = 0; k < words_.size(); ++k) {
+            p[k] &= q[k];
+        }
+        return *this;
+    }
+
+    bit_vector& operator|=(const bit_vector& x) {
+        check_same_size_(x);
+        std::uint64_t* p = words_.data();
+        const std::uint64_t* q = x.words_.data();
+        for (size_type k = 0; k < words_.size(); ++k) {
+            p[k] |= q[k];
+        }
+        return *this;
+    }
+
+    bit_vector& operator^=(const bit_vector& x) {
+        check_same_size_(x);
+        std::uint64_t* p = words_.data();
+        const std::uint64_t* q = x.words_.data();
+        for (size_type k = 0; k < words_.size(); ++k) {
+            p[k] ^= q[k];
+        }
+        return *this;
+    }
+
+    /** Flip every bit.
+     */
+    bit_vector& flip() {
+        std::uint64_t* p = words_.data();
+        for (size_type k = 0; k < words_.size(); ++k) {
+            p[k] = ~p[k];
+        }
+        clear_tail_();
+        return *this;
+    }
+
+    /** The number of set bits.
+     */
+    size_type count() const noexcept {
+        const std::uint64_t* p = words_.data();
+        size_type n = 0;
+        for (size_type k = 0; k < words_.size(); ++k) {
+            n += static_cast<size_type>(__builtin_popcountll(p[k]));
+        }
+        return n;
+    }
+
+    bool any() const noexcept {
+        for (size_type k = 0; k < words_.size(); ++k) {
+            if (words_[k] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool none() const noexcept { return !any(); }
+
+    /** The first set bit at or after i, npos if there is none.
+     */
+    size_type find_next(size_type i) const noexcept {
+        if (i >= size_) {
+            return npos;
+        }
+        size_type k = i / 64;
+        std::uint64_t w = words_[k] & (~std::uint64_t(0) << (i % 64));
+        while (w == 0) {
+            if (++k == words_.size()) {
+                return npos;
+            }
+            w = words_[k];
+        }
+        return k * 64 + static_cast<size_type>(__builtin_ctzll(w));
+    }
+
+    size_type find_first() const noexcept { return find_next(0); }
+
+    /** fn(i) for every set bit i, in order.
+     */
+    template <class Fn>
+    void for_each_set(Fn fn) const {
+        const std::uint64_t* p = words_.data();
+        for (size_type k = 0; k < words_.size(); ++k) {
+            for (std::uint64_t w = p[k]; w != 0; w &= w - 1) {
+                fn(k * 64 + static_cast<size_type>(__builtin_ctzll(w)));
+            }
+        }
+    }
+
+    friend bool operator==(const bit_vector& x, const bit_vector& y) {
+        if (x.size_ != y.size_) {
+            return false;
+        }
+        for (size_type k = 0; k < x.words_.size(); ++k) {
+            if (x.words_[k] != y.words_[k]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator!=(const bit_vector& x, const bit_vector& y) {
+        return !(x == y);
+    }
+
+   private:
+    v1::vector<std::uint64_t> words_;
+    size_type size_ = 0;
+
+    static size_type words_for_(size_type n) { return (n + 63) / 64; }
+
+    void check_same_size_(const bit_vector& x) const {
+        if (size_ != x.size_) {
+            throw std::invalid_argument("bit_vector: different sizes");
+        }
+    }
+
+    void clear_tail_() {
+        if (size_ % 64 != 0) {
+            words_[words_.size() - 1] &= ~(~std::uint64_t(0) << (size_ % 64));
+        }
+    }
+};
+
+inline bit_vector operator&(bit_vector x, const bit_vector& y) {
+    x &= y;
+    return x;
+}
+
+inline bit_vector operator|(bit_vector x, const bit_vector& y) {
+    x |= y;
+    return x;
+}
+
+inline bit_vector operator^(bit_vector x, const bit_vector& y) {
+    x ^= y;
+    return x;
+}
+
+/**
+   rank(i), the set bits before i, and select(k), the position of the
+   k-th set bit (from 0), over a bit_vector that must not change while the
+   index is used.
+
+   rank: the count before every block of 512 bits (8 words) is stored, the
+   rest is at most 8 popcounts in one cache line. 1/8 bit per bit.
+   select: the block of every kSelectSample-th set bit is stored; the block
+   of the k-th is found by a binary search between two samples, then the
+   word by popcounts and the bit by clearing the lowest set bits. rank is
+   O(1); select is O(log b), b the number of blocks between the two
+   samples around k, which grows with the runs of zeros on sparse data.
+ */
+class rank_select_index {
+   public:
+    using size_type = bit_vector::size_type;
+
+    static constexpr size_type kBlockWords = 8;
+    static constexpr size_type kSelectSample = 1024;
+
+    explicit rank_select_index(const bit_vector& bits) : bits_(&bits) {
+        const std::uint64_t* p = bits.words();
+        size_type words = bits.word_count();
+        size_type blocks = (words + kBlockWords - 1) / kBlockWords;
+        block_rank_.reserve(blocks + 1);
+        std::uint64_t n = 0;
+        for (size_type b = 0; b < blocks; ++b) {
+            block_rank_.push_back(n);
+            size_type end =
+                (b + 1) * kBlockWords < words ? (b + 1) * kBlockWords : words;
+            for (size_type k = b * kBlockWords; k < end; ++k) {
+                std::uint64_t c = std::uint64_t(__builtin_popcountll(p[k]));
+                // this word holds the ones n .. n + c - 1
+                if (c != 0 &&
+                    (n + c - 1) / kSelectSample >= select_sample_.size()) {
+                    select_sample_.push_back(b);
+                }
+                n += c;
+            }
+        }
+        block_rank_.push_back(n);
+        ones_ = n;
+    }
+
+    /** Set bits among the first i, i <= size().
+     */
+    size_type rank(size_type i) const {
+        ASSERT(i <= bits_->size(), "out of range rank");
+        const std::uint64_t* p = bits_->words();
+        size_type k = i / 64;
+        size_type b = k / kBlockWords;
+        std::uint64_t n = block_rank_[b];
+        for (size_type j = b * kBlockWords; j < k; ++j) {
+            n += std::uint64_t(__builtin_popcountll(p[j]));
+        }
+        if (i % 64 != 0) {
+            n += std::uint64_t(__builtin_popcountll(
+                p[k] & ~(~std::uint64_t(0) << (i % 64))));
+        }
+        return static_cast<size_type>(n);
+    }
+
+    /** The position of the k-th set bit, k < ones().
+     */
+    size_type select(size_type k) const {
+        ASSERT(k < ones_, "out of range select");
+        // the last block whose count before it is <= k
+        size_type s = k / kSelectSample;
+        size_type lo = select_sample_[s];
+        size_type hi = s + 1 < select_sample_.size() ? select_sample_[s + 1]
+                                                     : block_rank_.size() - 2;
+        while (lo < hi) {
+            size_type mid = lo + (hi - lo + 1) / 2;
+            if (block_rank_[mid] <= k) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        const std::uint64_t* p = bits_->words();
+        std::uint64_t left = k - block_rank_[lo];
+        size_type word = lo * kBlockWords;
+        for (;; ++word) {
+            std::uint64_t c = std::uint64_t(__builtin_popcountll(p[word]));
+            if (left < c) {
+                break;
+            }
+            left -= c;
+        }
+        std::uint64_t w = p[word];
+        for (; left != 0; --left) {
+            w &= w - 1;
+        }
+        return word * 64 + static_cast<size_type>(__builtin_ctzll(w));
+    }
+
+    size_type ones() const noexcept { return static_cast<size_type>(ones_); }
+
+    std::size_t memory_bytes() const noexcept {
+        return block_rank_.capacity() * sizeof(std::uint64_t) +
+               select_sample_.capacity() * sizeof(size_type);
+    }
+
+   private:
+    const bit_vector* bits_;
+    // set bits before block b, and the total at the end
+    v1::vector<std::uint64_t> block_rank_;
+    // the block holding set bit s * kSelectSample
+    v1::vector<size_type> select_sample_;
+    std::uint64_t ones_ = 0;
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
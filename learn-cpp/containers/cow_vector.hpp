@@ -0,0 +1,290 @@
+#ifndef LEARN_CPP_CONTAINERS_COW_VECTOR_HPP
+#define LEARN_CPP_CONTAINERS_COW_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "../implement-std-library/c++11/shared_ptr.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_COW_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   A copy-on-write vector: copies share one v1::vector through a SharedPtr,
+   so handing out a snapshot is a reference count increment.
+
+   The first modification through a handle whose buffer is shared copies
+   the buffer (detach), later ones go straight to the now unique buffer.
+   The handle caches the data pointer and the size, so a const read is
+   data_[n], as with v1::vector.
+
+   Non-const element access (operator[], at, front, back, data, begin, end)
+   detaches. A reference obtained that way must not be written through
+   after the vector is copied: the copy shares the buffer again.
+
+   Different handles may be used from different threads; a single handle is
+   not synchronized.
+ */
+template <class T, class Allocator = std::allocator<T>>
+class cow_vector {
+    using buffer_type = v1::vector<T, Allocator>;
+
+   public:
+    // types
+    // clang-format off
+    using value_type             = T;
+    using allocator_type         = Allocator;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    // clang-format on
+
+    // construct/copy/destroy:
+    cow_vector() = default;
+
+    explicit cow_vector(size_type n) : buf_(new buffer_type(n)) { sync_(); }
+
+    cow_vector(size_type n, const T& value)
+        : buf_(new buffer_type(n, value)) {
+        sync_();
+    }
+
+    cow_vector(std::initializer_list<T> ilist)
+        : buf_(new buffer_type(ilist)) {
+        sync_();
+    }
+
+    /** Takes over the elements of vec.
+     */
+    explicit cow_vector(buffer_type&& vec)
+        : buf_(new buffer_type(std::move(vec))) {
+        sync_();
+    }
+
+    // O(1): shares the buffer.
+    cow_vector(const cow_vector& x) = default;
+
+    cow_vector(cow_vector&& x) noexcept
+        : buf_(std::move(x.buf_)), data_(x.data_), size_(x.size_) {
+        x.data_ = nullptr;
+        x.size_ = 0;
+    }
+
+    cow_vector& operator=(cow_vector x) noexcept {
+        swap(x);
+        return *this;
+    }
+
+    // iterators:
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cbegin() const noexcept { return data_; }
+    const_iterator cend() const noexcept { return data_ + size_; }
+
+    iterator begin() { return mutable_data(); }
+    iterator end() { return mutable_data() + size_; }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    size_type capacity() const noexcept { return buf_ ? buf_->capacity() : 0; }
+
+    void reserve(size_type n) {
+        detach_(n);
+        buf_->reserve(n);
+        sync_();
+    }
+
+    void resize(size_type n) {
+        detach_(n);
+        buf_->resize(n);
+        sync_();
+    }
+
+    void resize(size_type n, const T& value) {
+        detach_(n);
+        buf_->resize(n, value);
+        sync_();
+    }
+
+    // element access:
+    const_reference operator[](size_type n) const {
+        ASSERT(n < size_, "out of range access");
+        return data_[n];
+    }
+
+    reference operator[](size_type n) {
+        ASSERT(n < size_, "out of range access");
+        return mutable_data()[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (n >= size_) {
+            throw std::out_of_range("cow_vector::at");
+        }
+        return data_[n];
+    }
+
+    reference at(size_type n) {
+        if (n >= size_) {
+            throw std::out_of_range("cow_vector::at");
+        }
+        return mutable_data()[n];
+    }
+
+    const_reference front() const { return (*this)[0]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+    reference front() { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+
+    const T* data() const noexcept { return data_; }
+
+    /** data(), after detaching.
+     */
+    T* mutable_data() {
+        detach_(size_);
+        return const_cast<T*>(data_);
+    }
+
+    // modifiers:
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        detach_(size_ + 1);
+        buf_->emplace_back(std::forward<Args>(args)...);
+        sync_();
+    }
+
+    void push_back(const T& x) {
+        if (aliases_(x)) {
+            T tmp(x);
+            push_back(std::move(tmp));
+            return;
+        }
+        detach_(size_ + 1);
+        buf_->push_back(x);
+        sync_();
+    }
+
+    void push_back(T&& x) {
+        detach_(size_ + 1);
+        buf_->push_back(std::move(x));
+        sync_();
+    }
+
+    void pop_back() {
+        ASSERT(size_ != 0, "pop_back on empty cow_vector");
+        detach_(size_);
+        buf_->pop_back();
+        sync_();
+    }
+
+    iterator insert(const_iterator position, const T& x) {
+        size_type i = static_cast<size_type>(position - data_);
+        T tmp(x);
+        detach_(size_ + 1);
+        buf_->insert(buf_->begin() + i, std::move(tmp));
+        sync_();
+        return mutable_data() + i;
+    }
+
+    iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        size_type i = static_cast<size_type>(first - data_);
+        size_type j = static_cast<size_type>(last - data_);
+        detach_(size_);
+        buf_->erase(buf_->begin() + i, buf_->begin() + j);
+        sync_();
+        return mutable_data() + i;
+    }
+
+    /** A shared buffer is dropped, not copied.
+     */
+    void clear() {
+        if (buf_ && buf_.unique()) {
+            buf_->clear();
+        } else {
+            buf_.reset();
+        }
+        sync_();
+    }
+
+    void swap(cow_vector& x) noexcept {
+        using std::swap;
+        buf_.swap(x.buf_);
+        swap(data_, x.data_);
+        swap(size_, x.size_);
+    }
+
+    // sharing:
+    /** Handles sharing this buffer, 0 when there is none.
+     */
+    long use_count() const noexcept { return buf_.use_count(); }
+
+    /** True if a write would not copy.
+     */
+    bool unique() const noexcept { return !buf_ || buf_.unique(); }
+
+    /** The shared buffer, read-only.
+     */
+    const buffer_type& vector() const {
+        static const buffer_type empty_buffer;
+        return buf_ ? *buf_ : empty_buffer;
+    }
+
+   private:
+    SharedPtr<buffer_type> buf_;
+    const T* data_ = nullptr;
+    size_type size_ = 0;
+
+    // make buf_ a unique buffer with room for n elements.
+    void detach_(size_type n) {
+        if (!buf_) {
+            SharedPtr<buffer_type>(new buffer_type()).swap(buf_);
+        } else if (!buf_.unique()) {
+            SharedPtr<buffer_type> copy(new buffer_type());
+            copy->reserve(n > size_ ? n : size_);
+            copy->insert(copy->end(), data_, data_ + size_);
+            copy.swap(buf_);
+        }
+        sync_();
+    }
+
+    void sync_() noexcept {
+        data_ = buf_ ? buf_->data() : nullptr;
+        size_ = buf_ ? buf_->size() : 0;
+    }
+
+    bool aliases_(const T& x) const noexcept {
+        return std::less_equal<const T*>()(data_, &x) &&
+               std::less<const T*>()(&x, data_ + size_);
+    }
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
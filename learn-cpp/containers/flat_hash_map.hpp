@@ -0,0 +1,553 @@
+#ifndef LEARN_CPP_CONTAINERS_FLAT_HASH_MAP_HPP
+#define LEARN_CPP_CONTAINERS_FLAT_HASH_MAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_FLAT_HASH_MAP)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   16 control bytes, loaded at once. A control byte is kEmpty or the low
+   7 bits of the hash of a full slot; bit i of a mask stands for byte i.
+ */
+struct ctrl_group {
+    static constexpr std::size_t kWidth = 16;
+    static constexpr std::int8_t kEmpty = -128;
+
+#if defined(__SSE2__)
+    explicit ctrl_group(const std::int8_t* p)
+        : bytes_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    std::uint32_t match(std::int8_t h2) const {
+        return static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(bytes_, _mm_set1_epi8(h2))));
+    }
+
+    // only kEmpty has its high bit set.
+    std::uint32_t match_empty() const {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(bytes_));
+    }
+
+   private:
+    __m128i bytes_;
+#else
+    explicit ctrl_group(const std::int8_t* p) : p_(p) {}
+
+    std::uint32_t match(std::int8_t h2) const {
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < kWidth; ++i) {
+            mask |= std::uint32_t(p_[i] == h2) << i;
+        }
+        return mask;
+    }
+
+    std::uint32_t match_empty() const { return match(kEmpty); }
+
+   private:
+    const std::int8_t* p_;
+#endif
+};
+
+/**
+   An open-addressing hash map: the elements and one control byte per slot
+   live in two v1::vector buffers, no node per element.
+
+   A lookup hashes once, then compares 16 control bytes at a time (SSE2)
+   against the low 7 bits of the hash; only the matching slots compare keys.
+   It stops at the first group with an empty slot.
+
+   The probe is linear from slot hash >> 7, so erase() shifts the following
+   entries back instead of leaving a tombstone: the table never fills with
+   deleted slots and insert/erase at a steady size never rehashes. The
+   first kWidth - 1 control bytes are mirrored past the end so a group can
+   be loaded at any slot.
+
+   The load factor is at most 7/8. reserve(n) sizes the table once for n
+   elements. Inserting or erasing invalidates iterators and references.
+
+   value_type is std::pair<K, V>, entries move on erase; do not modify the
+   key through an iterator.
+ */
+template <class K, class V, class Hash = std::hash<K>,
+          class KeyEqual = std::equal_to<K>>
+class flat_hash_map {
+   public:
+    // types
+    // clang-format off
+    using key_type               = K;
+    using mapped_type            = V;
+    using value_type             = std::pair<K, V>;
+    using hasher                 = Hash;
+    using key_equal              = KeyEqual;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    // clang-format on
+
+    template <bool Const>
+    class basic_iterator;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    static constexpr size_type kGroupWidth = ctrl_group::kWidth;
+
+    // construct/copy/destroy:
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(size_type n, const Hash& hash = Hash(),
+                           const KeyEqual& equal = KeyEqual())
+        : hash_(hash), equal_(equal) {
+        reserve(n);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> ilist) {
+        reserve(ilist.size());
+        for (const auto& item : ilist) {
+            insert(item);
+        }
+    }
+
+    flat_hash_map(const flat_hash_map& x) : hash_(x.hash_), equal_(x.equal_) {
+        reserve(x.size());
+        for (const auto& item : x) {
+            insert_unique_(item);
+        }
+    }
+
+    flat_hash_map(flat_hash_map&& x) noexcept
+        : ctrl_(std::move(x.ctrl_)),
+          slots_(std::move(x.slots_)),
+          size_(x.size_),
+          hash_(std::move(x.hash_)),
+          equal_(std::move(x.equal_)) {
+        x.size_ = 0;
+    }
+
+    ~flat_hash_map() { destroy_all_(); }
+
+    flat_hash_map& operator=(flat_hash_map x) noexcept {
+        swap(x);
+        return *this;
+    }
+
+    // iterators:
+    iterator begin() noexcept { return iterator(this, next_full_(0)); }
+    const_iterator begin() const noexcept {
+        return const_iterator(this, next_full_(0));
+    }
+    iterator end() noexcept { return iterator(this, capacity()); }
+    const_iterator end() const noexcept {
+        return const_iterator(this, capacity());
+    }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    /** Number of slots, 0 or a power of two >= kGroupWidth.
+     */
+    size_type capacity() const noexcept {
+        return ctrl_.empty() ? 0 : ctrl_.size() - (kGroupWidth - 1);
+    }
+
+    float load_factor() const noexcept {
+        return capacity() == 0 ? 0.0f : float(size_) / float(capacity());
+    }
+
+    /** Make room for n elements without rehashing.
+     */
+    void reserve(size_type n) {
+        size_type cap = capacity_for_(n);
+        if (cap > capacity()) {
+            rehash_(cap);
+        }
+    }
+
+    // element access:
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    V& at(const K& key) {
+        size_type i = find_slot_(key);
+        if (i == capacity()) {
+            throw std::out_of_range("flat_hash_map::at");
+        }
+        return slot_(i).second;
+    }
+
+    const V& at(const K& key) const {
+        size_type i = find_slot_(key);
+        if (i == capacity()) {
+            throw std::out_of_range("flat_hash_map::at");
+        }
+        return slot_(i).second;
+    }
+
+    // lookup:
+    iterator find(const K& key) { return iterator(this, find_slot_(key)); }
+
+    const_iterator find(const K& key) const {
+        return const_iterator(this, find_slot_(key));
+    }
+
+    bool contains(const K& key) const { return find_slot_(key) != capacity(); }
+
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    // modifiers:
+    /** Construct V from args if key is absent.
+     */
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return try_emplace_(key, std::forward<Args>(args)...);
+    }
+
+    /** As above, key is moved from only if it is inserted.
+     */
+    template <class... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return try_emplace_(std::move(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& x) {
+        return try_emplace(x.first, x.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& x) {
+        return try_emplace(std::move(x.first), std::move(x.second));
+    }
+
+    template <class M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    /** Erase key if present, returns the number erased. Shifts the rest of
+        its probe run back by one slot.
+     */
+    size_type erase(const K& key) {
+        size_type i = find_slot_(key);
+        if (i == capacity()) {
+            return 0;
+        }
+        slot_(i).~value_type();
+        size_type mask = capacity() - 1;
+        for (size_type j = (i + 1) & mask; ctrl_[j] != ctrl_group::kEmpty;
+             j = (j + 1) & mask) {
+            // the entry at j may fill the hole at i if i is between its
+            // home slot and j.
+            size_type home = h1_(hash_of_(slot_(j).first)) & mask;
+            if (((j - home) & mask) >= ((j - i) & mask)) {
+                ::new (static_cast<void*>(slots_.data() + i))
+                    value_type(std::move(slot_(j)));
+                slot_(j).~value_type();
+                set_ctrl_(i, ctrl_[j]);
+                i = j;
+            }
+        }
+        set_ctrl_(i, ctrl_group::kEmpty);
+        --size_;
+        return 1;
+    }
+
+    /** Destroy the elements, keep the slots.
+     */
+    void clear() noexcept {
+        destroy_all_();
+        for (size_type i = 0; i < ctrl_.size(); ++i) {
+            ctrl_[i] = ctrl_group::kEmpty;
+        }
+        size_ = 0;
+    }
+
+    void swap(flat_hash_map& x) noexcept {
+        using std::swap;
+        ctrl_.swap(x.ctrl_);
+        slots_.swap(x.slots_);
+        swap(size_, x.size_);
+        swap(hash_, x.hash_);
+        swap(equal_, x.equal_);
+    }
+
+    /** Slots between the home slot of key and where it is (or would be
+        inserted), for checking the hash quality.
+     */
+    size_type probe_length(const K& key) const {
+        if (capacity() == 0) {
+            return 0;
+        }
+        std::uint64_t h = hash_of_(key);
+        size_type mask = capacity() - 1;
+        size_type i = find_slot_(key, h);
+        if (i == capacity()) {
+            i = insert_slot_(h);
+        }
+        return (i - h1_(h)) & mask;
+    }
+
+   private:
+    using slot_type = typename std::aligned_storage<sizeof(value_type),
+                                                    alignof(value_type)>::type;
+
+    // capacity() + kGroupWidth - 1 bytes, the last ones mirror the first.
+    v1::vector<std::int8_t> ctrl_;
+    // raw storage: reserved, never resized, so its size() stays 0 and a
+    // slot is constructed only where ctrl_ marks it full.
+    v1::vector<slot_type> slots_;
+    size_type size_ = 0;
+    Hash hash_;
+    KeyEqual equal_;
+
+    value_type& slot_(size_type i) noexcept {
+        return *reinterpret_cast<value_type*>(slots_.data() + i);
+    }
+
+    const value_type& slot_(size_type i) const noexcept {
+        return *reinterpret_cast<const value_type*>(slots_.data() + i);
+    }
+
+    bool full_(size_type i) const noexcept {
+        return ctrl_[i] != ctrl_group::kEmpty;
+    }
+
+    // std::hash of an integer is the identity: fold a 128 bit product so
+    // every bit of the key reaches both h1 and h2.
+    std::uint64_t hash_of_(const K& key) const {
+        auto x = static_cast<std::uint64_t>(hash_(key));
+        unsigned __int128 m =
+            static_cast<unsigned __int128>(x) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::uint64_t>(m) ^
+               static_cast<std::uint64_t>(m >> 64);
+    }
+
+    static size_type h1_(std::uint64_t h) noexcept {
+        return static_cast<size_type>(h >> 7);
+    }
+
+    static std::int8_t h2_(std::uint64_t h) noexcept {
+        return static_cast<std::int8_t>(h & 0x7F);
+    }
+
+    static size_type max_size_for_(size_type cap) noexcept {
+        return cap - cap / 8;
+    }
+
+    static size_type capacity_for_(size_type n) noexcept {
+        if (n == 0) {
+            return 0;
+        }
+        size_type cap = kGroupWidth;
+        while (max_size_for_(cap) < n) {
+            cap *= 2;
+        }
+        return cap;
+    }
+
+    void set_ctrl_(size_type i, std::int8_t c) noexcept {
+        ctrl_[i] = c;
+        if (i < kGroupWidth - 1) {
+            ctrl_[capacity() + i] = c;
+        }
+    }
+
+    size_type find_slot_(const K& key) const {
+        return capacity() == 0 ? 0 : find_slot_(key, hash_of_(key));
+    }
+
+    // the slot of key, or capacity() if absent.
+    size_type find_slot_(const K& key, std::uint64_t h) const {
+        if (capacity() == 0) {
+            return 0;
+        }
+        size_type mask = capacity() - 1;
+        std::int8_t tag = h2_(h);
+        for (size_type pos = h1_(h) & mask;; pos = (pos + kGroupWidth) & mask) {
+            ctrl_group group(&ctrl_[pos]);
+            for (std::uint32_t m = group.match(tag); m != 0; m &= m - 1) {
+                size_type i = (pos + __builtin_ctz(m)) & mask;
+                if (equal_(slot_(i).first, key)) {
+                    return i;
+                }
+            }
+            if (group.match_empty() != 0) {
+                return capacity();
+            }
+        }
+    }
+
+    // the first empty slot from the home slot of h; there is one since the
+    // load factor is below 1.
+    size_type insert_slot_(std::uint64_t h) const {
+        size_type mask = capacity() - 1;
+        for (size_type pos = h1_(h) & mask;; pos = (pos + kGroupWidth) & mask) {
+            std::uint32_t m = ctrl_group(&ctrl_[pos]).match_empty();
+            if (m != 0) {
+                return (pos + __builtin_ctz(m)) & mask;
+            }
+        }
+    }
+
+    template <class KK, class... Args>
+    std::pair<iterator, bool> try_emplace_(KK&& key, Args&&... args) {
+        std::uint64_t h = hash_of_(key);
+        size_type i = find_slot_(key, h);
+        if (i != capacity()) {
+            return {iterator(this, i), false};
+        }
+        if (size_ + 1 > max_size_for_(capacity())) {
+            rehash_(capacity() == 0 ? kGroupWidth : capacity() * 2);
+        }
+        i = insert_slot_(h);
+        ::new (static_cast<void*>(slots_.data() + i)) value_type(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<KK>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        set_ctrl_(i, h2_(h));
+        ++size_;
+        return {iterator(this, i), true};
+    }
+
+    // for copies and rehash: key is known to be absent and there is room.
+    void insert_unique_(const value_type& x) {
+        std::uint64_t h = hash_of_(x.first);
+        size_type i = insert_slot_(h);
+        ::new (static_cast<void*>(slots_.data() + i)) value_type(x);
+        set_ctrl_(i, h2_(h));
+        ++size_;
+    }
+
+    void rehash_(size_type new_capacity) {
+        ASSERT(max_size_for_(new_capacity) >= size_, "rehash too small");
+        flat_hash_map next;
+        next.hash_ = hash_;
+        next.equal_ = equal_;
+        v1::vector<std::int8_t>(new_capacity + kGroupWidth - 1,
+                                ctrl_group::kEmpty)
+            .swap(next.ctrl_);
+        next.slots_.reserve(new_capacity);
+        for (size_type i = 0; i < capacity(); ++i) {
+            if (full_(i)) {
+                value_type& x = slot_(i);
+                std::uint64_t h = next.hash_of_(x.first);
+                size_type j = next.insert_slot_(h);
+                ::new (static_cast<void*>(next.slots_.data() + j))
+                    value_type(std::move(x));
+                next.set_ctrl_(j, h2_(h));
+                ++next.size_;
+            }
+        }
+        swap(next);
+    }
+
+    void destroy_all_() noexcept {
+        if (!std::is_trivially_destructible<value_type>::value) {
+            for (size_type i = 0; i < capacity(); ++i) {
+                if (full_(i)) {
+                    slot_(i).~value_type();
+                }
+            }
+        }
+    }
+
+    size_type next_full_(size_type i) const noexcept {
+        while (i < capacity() && !full_(i)) {
+            ++i;
+        }
+        return i;
+    }
+};
+
+/**
+   Forward iterator: the map and a slot index, skipping empty slots.
+ */
+template <class K, class V, class Hash, class KeyEqual>
+template <bool Const>
+class flat_hash_map<K, V, Hash, KeyEqual>::basic_iterator {
+    using container = typename std::conditional<Const, const flat_hash_map,
+                                                flat_hash_map>::type;
+
+   public:
+    // clang-format off
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename flat_hash_map::value_type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::conditional_t<Const, const value_type*,
+                                                 value_type*>;
+    using reference         = std::conditional_t<Const, const value_type&,
+                                                 value_type&>;
+    // clang-format on
+
+    basic_iterator() = default;
+
+    basic_iterator(container* c, size_type i) : c_(c), i_(i) {}
+
+    // iterator -> const_iterator
+    template <bool OtherConst,
+              class = typename std::enable_if<Const && !OtherConst>::type>
+    basic_iterator(const basic_iterator<OtherConst>& x)
+        : c_(x.c_), i_(x.i_) {}
+
+    reference operator*() const { return c_->slot_(i_); }
+    pointer operator->() const { return std::addressof(c_->slot_(i_)); }
+
+    basic_iterator& operator++() {
+        i_ = c_->next_full_(i_ + 1);
+        return *this;
+    }
+    basic_iterator operator++(int) {
+        auto old = *this;
+        ++*this;
+        return old;
+    }
+
+    friend bool operator==(const basic_iterator& x, const basic_iterator& y) {
+        return x.i_ == y.i_;
+    }
+    friend bool operator!=(const basic_iterator& x, const basic_iterator& y) {
+        return x.i_ != y.i_;
+    }
+
+   private:
+    container* c_ = nullptr;
+    size_type i_ = 0;
+
+    template <bool OtherConst>
+    friend class basic_iterator;
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
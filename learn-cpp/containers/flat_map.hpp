@@ -0,0 +1,522 @@
+#ifndef LEARN_CPP_CONTAINERS_FLAT_MAP_HPP
+#define LEARN_CPP_CONTAINERS_FLAT_MAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_FLAT_MAP)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   Search layouts for flat_set and flat_map. A layout keeps whatever index it
+   needs next to the sorted keys, rebuilt by build() after every change, and
+   answers lower_bound() as a position in the sorted keys. A build() that
+   throws leaves the old index; clear() empties it and does not throw.
+ */
+
+/** Binary search over the sorted keys themselves, no extra memory. The loop
+    has no data-dependent branch: the compiler turns the step into a cmov.
+ */
+struct sorted_layout {
+    template <class K, class Compare>
+    class index {
+       public:
+        void build(const K*, std::size_t) {}
+        void clear() noexcept {}
+
+        std::size_t lower_bound(const K* keys, std::size_t n, const K& key,
+                                const Compare& comp) const {
+            if (n == 0) {
+                return 0;
+            }
+            const K* base = keys;
+            while (n > 1) {
+                std::size_t half = n / 2;
+                // both possible next midpoints
+                __builtin_prefetch(base + half / 2);
+                __builtin_prefetch(base + half + half / 2);
+                base = comp(base[half], key) ? base + half : base;
+                n -= half;
+            }
+            return static_cast<std::size_t>(base - keys) + comp(*base, key);
+        }
+
+        std::size_t memory_bytes() const { return 0; }
+    };
+};
+
+/** A copy of the keys in Eytzinger (breadth-first) order: node k has its
+    children at 2k and 2k + 1, so the first levels share a few cache lines
+    and the nodes four levels down are contiguous and can be prefetched
+    while the current ones are compared. rank_ maps a node back to its
+    position in the sorted keys.
+ */
+struct eytzinger_layout {
+    template <class K, class Compare>
+    class index {
+       public:
+        void build(const K* keys, std::size_t n) {
+            if (n >= UINT32_MAX) {
+                throw std::length_error("eytzinger_layout: too many keys");
+            }
+            // node 0 is unused, keeps the arithmetic 1-based. Built aside,
+            // so a throwing copy of K leaves the old index.
+            v1::vector<K> tree(n + 1);
+            v1::vector<std::uint32_t> rank(n + 1);
+            build_(keys, n, 0, 1, tree, rank);
+            tree_.swap(tree);
+            rank_.swap(rank);
+        }
+
+        void clear() noexcept {
+            tree_.clear();
+            rank_.clear();
+        }
+
+        std::size_t lower_bound(const K* keys, std::size_t n, const K& key,
+                                const Compare& comp) const {
+            (void)keys;
+            const K* tree = tree_.data();
+            std::size_t k = 1;
+            while (k <= n) {
+                // the 16 descendants four levels down
+                __builtin_prefetch(tree + k * 16);
+                k = 2 * k + comp(tree[k], key);
+            }
+            // undo the right turns after the last left turn
+            k >>= __builtin_ffsll(static_cast<long long>(~k));
+            return k == 0 ? n : rank_[k];
+        }
+
+        std::size_t memory_bytes() const {
+            return tree_.size() * sizeof(K) +
+                   rank_.size() * sizeof(std::uint32_t);
+        }
+
+       private:
+        v1::vector<K> tree_;
+        v1::vector<std::uint32_t> rank_;
+
+        // in-order walk of the implicit tree, i is the next sorted key.
+        static std::size_t build_(const K* keys, std::size_t n, std::size_t i,
+                                  std::size_t k, v1::vector<K>& tree,
+                                  v1::vector<std::uint32_t>& rank) {
+            if (k <= n) {
+                i = build_(keys, n, i, 2 * k, tree, rank);
+                tree[k] = keys[i];
+                rank[k] = static_cast<std::uint32_t>(i++);
+                i = build_(keys, n, i, 2 * k + 1, tree, rank);
+            }
+            return i;
+        }
+    };
+};
+
+/**
+   A sorted set of keys in one v1::vector, for read-mostly lookups.
+
+   Changing one key shifts the rest of the vector: build the set in bulk
+   with the range constructor (sort, then unique) and add keys in batches
+   with insert_many(), which sorts the batch and merges it in one pass.
+   Layout picks the search (sorted_layout or eytzinger_layout).
+
+   insert() and erase() leave the set as it was if they throw;
+   insert_many() leaves it empty.
+ */
+template <class K, class Compare = std::less<K>,
+          class Layout = sorted_layout>
+class flat_set {
+   public:
+    // types
+    // clang-format off
+    using key_type               = K;
+    using value_type             = K;
+    using key_compare            = Compare;
+    using size_type              = std::size_t;
+    using const_iterator         = const K*;
+    using iterator               = const_iterator;
+    // clang-format on
+
+    flat_set() = default;
+
+    template <class InputIterator>
+    flat_set(InputIterator first, InputIterator last,
+             const Compare& comp = Compare())
+        : comp_(comp) {
+        insert_many(first, last);
+    }
+
+    flat_set(std::initializer_list<K> ilist, const Compare& comp = Compare())
+        : flat_set(ilist.begin(), ilist.end(), comp) {}
+
+    // iterators, in key order:
+    const_iterator begin() const noexcept { return keys_.data(); }
+    const_iterator end() const noexcept { return keys_.data() + size(); }
+
+    size_type size() const noexcept { return keys_.size(); }
+    bool empty() const noexcept { return keys_.empty(); }
+
+    const v1::vector<K>& keys() const noexcept { return keys_; }
+
+    /** Bytes used by the search index on top of the keys.
+     */
+    size_type index_bytes() const { return index_.memory_bytes(); }
+
+    // lookup:
+    /** Position of the first key not less than key, or size().
+     */
+    size_type lower_bound_index(const K& key) const {
+        return index_.lower_bound(keys_.data(), size(), key, comp_);
+    }
+
+    const_iterator lower_bound(const K& key) const {
+        return begin() + lower_bound_index(key);
+    }
+
+    const_iterator find(const K& key) const {
+        size_type i = lower_bound_index(key);
+        return i != size() && !comp_(key, keys_[i]) ? begin() + i : end();
+    }
+
+    bool contains(const K& key) const { return find(key) != end(); }
+
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    // modifiers:
+    /** O(size()). Returns true if inserted.
+     */
+    bool insert(const K& key) {
+        size_type i = lower_bound_index(key);
+        if (i != size() && !comp_(key, keys_[i])) {
+            return false;
+        }
+        // copied first: v1::vector::insert in the middle only gives the
+        // basic guarantee when the copy throws.
+        K copy(key);
+        keys_.insert(keys_.begin() + i, std::move(copy));
+        try {
+            index_.build(keys_.data(), size());
+        } catch (...) {
+            keys_.erase(keys_.begin() + i);
+            throw;
+        }
+        return true;
+    }
+
+    /** Insert the keys of [first, last) that are absent, in one merge.
+        Returns the number inserted.
+     */
+    template <class InputIterator>
+    size_type insert_many(InputIterator first, InputIterator last) {
+        v1::vector<K> batch;
+        for (; first != last; ++first) {
+            batch.push_back(*first);
+        }
+        std::sort(batch.begin(), batch.end(), comp_);
+        auto equal = [this](const K& x, const K& y) {
+            return !comp_(x, y) && !comp_(y, x);
+        };
+        batch.erase(std::unique(batch.begin(), batch.end(), equal),
+                    batch.end());
+
+        v1::vector<K> merged;
+        merged.reserve(size() + batch.size());
+        size_type i = 0, j = 0, inserted = 0;
+        while (i < size() && j < batch.size()) {
+            if (comp_(keys_[i], batch[j])) {
+                merged.push_back(std::move(keys_[i++]));
+            } else if (comp_(batch[j], keys_[i])) {
+                merged.push_back(std::move(batch[j++]));
+                ++inserted;
+            } else {
+                merged.push_back(std::move(keys_[i++]));
+                ++j;
+            }
+        }
+        for (; i < size(); ++i) {
+            merged.push_back(std::move(keys_[i]));
+        }
+        for (; j < batch.size(); ++j, ++inserted) {
+            merged.push_back(std::move(batch[j]));
+        }
+        keys_.swap(merged);
+        try {
+            index_.build(keys_.data(), size());
+        } catch (...) {
+            // the old keys were moved from, and the old index is too long.
+            clear();
+            throw;
+        }
+        return inserted;
+    }
+
+    size_type erase(const K& key) {
+        const_iterator it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        size_type i = static_cast<size_type>(it - begin());
+        K erased = std::move(keys_[i]);
+        keys_.erase(keys_.begin() + i);
+        try {
+            index_.build(keys_.data(), size());
+        } catch (...) {
+            keys_.insert(keys_.begin() + i, std::move(erased));
+            throw;
+        }
+        return 1;
+    }
+
+    void clear() noexcept {
+        keys_.clear();
+        index_.clear();
+    }
+
+   private:
+    v1::vector<K> keys_;
+    Compare comp_;
+    typename Layout::template index<K, Compare> index_;
+};
+
+/**
+   A sorted map with the keys and the values in two v1::vectors, in the
+   same order: a search touches only keys, and keys() / values() are plain
+   arrays to scan.
+
+   Like flat_set, build it in bulk (sort, then unique; the first of equal
+   keys wins) and add to it in batches with insert_many(). The exception
+   guarantees are flat_set's.
+ */
+template <class K, class V, class Compare = std::less<K>,
+          class Layout = sorted_layout>
+class flat_map {
+   public:
+    // types
+    // clang-format off
+    using key_type               = K;
+    using mapped_type            = V;
+    using value_type             = std::pair<K, V>;
+    using key_compare            = Compare;
+    using size_type              = std::size_t;
+    // clang-format on
+
+    flat_map() = default;
+
+    /** From a range of std::pair<K, V>.
+     */
+    template <class InputIterator>
+    flat_map(InputIterator first, InputIterator last,
+             const Compare& comp = Compare())
+        : comp_(comp) {
+        insert_many(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> ilist,
+             const Compare& comp = Compare())
+        : flat_map(ilist.begin(), ilist.end(), comp) {}
+
+    size_type size() const noexcept { return keys_.size(); }
+    bool empty() const noexcept { return keys_.empty(); }
+
+    /** keys()[i] maps to values()[i], keys in order.
+     */
+    const v1::vector<K>& keys() const noexcept { return keys_; }
+    const v1::vector<V>& values() const noexcept { return values_; }
+
+    size_type index_bytes() const { return index_.memory_bytes(); }
+
+    // lookup:
+    size_type lower_bound_index(const K& key) const {
+        return index_.lower_bound(keys_.data(), size(), key, comp_);
+    }
+
+    /** The value of key, or nullptr.
+     */
+    V* find(const K& key) {
+        size_type i = find_index_(key);
+        return i != size() ? &values_[i] : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        size_type i = find_index_(key);
+        return i != size() ? &values_[i] : nullptr;
+    }
+
+    bool contains(const K& key) const { return find_index_(key) != size(); }
+
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    V& at(const K& key) {
+        V* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("flat_map::at");
+        }
+        return *value;
+    }
+
+    const V& at(const K& key) const {
+        const V* value = find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("flat_map::at");
+        }
+        return *value;
+    }
+
+    // modifiers:
+    /** O(size()). Returns true if inserted.
+     */
+    bool insert(const K& key, const V& value) {
+        size_type i = lower_bound_index(key);
+        if (i != size() && !comp_(key, keys_[i])) {
+            return false;
+        }
+        // copied first, as in flat_set::insert().
+        K key_copy(key);
+        V value_copy(value);
+        keys_.insert(keys_.begin() + i, std::move(key_copy));
+        bool value_inserted = false;
+        try {
+            values_.insert(values_.begin() + i, std::move(value_copy));
+            value_inserted = true;
+            index_.build(keys_.data(), size());
+        } catch (...) {
+            if (value_inserted) {
+                values_.erase(values_.begin() + i);
+            }
+            keys_.erase(keys_.begin() + i);
+            throw;
+        }
+        return true;
+    }
+
+    bool insert_or_assign(const K& key, const V& value) {
+        V* old = find(key);
+        if (old != nullptr) {
+            *old = value;
+            return false;
+        }
+        return insert(key, value);
+    }
+
+    /** Insert the pairs of [first, last) whose key is absent, in one merge.
+        Returns the number inserted.
+     */
+    template <class InputIterator>
+    size_type insert_many(InputIterator first, InputIterator last) {
+        v1::vector<value_type> batch;
+        for (; first != last; ++first) {
+            batch.push_back(*first);
+        }
+        // stable: the first of equal keys is kept
+        auto less = [this](const value_type& x, const value_type& y) {
+            return comp_(x.first, y.first);
+        };
+        std::stable_sort(batch.begin(), batch.end(), less);
+        auto equal = [this](const value_type& x, const value_type& y) {
+            return !comp_(x.first, y.first) && !comp_(y.first, x.first);
+        };
+        batch.erase(std::unique(batch.begin(), batch.end(), equal),
+                    batch.end());
+
+        v1::vector<K> keys;
+        v1::vector<V> values;
+        keys.reserve(size() + batch.size());
+        values.reserve(size() + batch.size());
+        size_type i = 0, j = 0, inserted = 0;
+        auto take_old = [&]() {
+            keys.push_back(std::move(keys_[i]));
+            values.push_back(std::move(values_[i]));
+            ++i;
+        };
+        auto take_new = [&]() {
+            keys.push_back(std::move(batch[j].first));
+            values.push_back(std::move(batch[j].second));
+            ++j;
+            ++inserted;
+        };
+        while (i < size() && j < batch.size()) {
+            if (comp_(keys_[i], batch[j].first)) {
+                take_old();
+            } else if (comp_(batch[j].first, keys_[i])) {
+                take_new();
+            } else {
+                take_old();
+                ++j;
+            }
+        }
+        while (i < size()) {
+            take_old();
+        }
+        while (j < batch.size()) {
+            take_new();
+        }
+        keys_.swap(keys);
+        values_.swap(values);
+        try {
+            index_.build(keys_.data(), size());
+        } catch (...) {
+            clear();
+            throw;
+        }
+        return inserted;
+    }
+
+    size_type erase(const K& key) {
+        size_type i = find_index_(key);
+        if (i == size()) {
+            return 0;
+        }
+        K erased_key = std::move(keys_[i]);
+        V erased_value = std::move(values_[i]);
+        keys_.erase(keys_.begin() + i);
+        values_.erase(values_.begin() + i);
+        try {
+            index_.build(keys_.data(), size());
+        } catch (...) {
+            keys_.insert(keys_.begin() + i, std::move(erased_key));
+            values_.insert(values_.begin() + i, std::move(erased_value));
+            throw;
+        }
+        return 1;
+    }
+
+    void clear() noexcept {
+        keys_.clear();
+        values_.clear();
+        index_.clear();
+    }
+
+   private:
+    v1::vector<K> keys_;
+    v1::vector<V> values_;
+    Compare comp_;
+    typename Layout::template index<K, Compare> index_;
+
+    // the position of key, or size() if absent.
+    size_type find_index_(const K& key) const {
+        size_type i = lower_bound_index(key);
+        ASSERT(i <= size(), "lower_bound out of range");
+        return i != size() && !comp_(key, keys_[i]) ? i : size();
+    }
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
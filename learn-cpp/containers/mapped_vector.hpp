@@ -0,0 +1,466 @@
+#ifndef LEARN_CPP_CONTAINERS_MAPPED_VECTOR_HPP
+#define LEARN_CPP_CONTAINERS_MAPPED_VECTOR_HPP
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_MAPPED_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+enum class map_mode {
+    read_only,   // map an existing file, PROT_READ, zero-copy
+    read_write,  // map an existing file or create it, keep its content
+    truncate,    // create the file or discard its content
+};
+
+enum class access_hint {
+    normal,
+    sequential,
+    random,
+    will_need,
+    dont_need,
+};
+
+/**
+   A vector of trivially copyable T whose storage is a memory-mapped file.
+
+   The file holds the elements back to back and nothing else, so a snapshot
+   written by `fwrite(vec.data(), sizeof(T), vec.size(), fp)` can be opened
+   directly. While the file is open for writing it may be longer than
+   size() * sizeof(T) (the extra part is the capacity); close() truncates it
+   back to the exact size.
+
+   Opening is O(1): pages are faulted in lazily by the kernel and served from
+   the page cache.
+ */
+template <class T>
+class mapped_vector {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "mapped_vector stores raw bytes of T in a file");
+
+   public:
+    // types
+    // clang-format off
+    using value_type             = T;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    // clang-format on
+
+    // construct/copy/destroy:
+    mapped_vector() = default;
+
+    explicit mapped_vector(const char* path,
+                           map_mode mode = map_mode::read_write) {
+        open(path, mode);
+    }
+
+    mapped_vector(const mapped_vector&) = delete;
+    mapped_vector& operator=(const mapped_vector&) = delete;
+
+    mapped_vector(mapped_vector&& x) noexcept { swap(x); }
+
+    mapped_vector& operator=(mapped_vector&& x) noexcept {
+        if (this != std::addressof(x)) {
+            close_noexcept_();
+            swap(x);
+        }
+        return *this;
+    }
+
+    ~mapped_vector() { close_noexcept_(); }
+
+    // file management:
+    void open(const char* path, map_mode mode = map_mode::read_write);
+    /** Unmap the file. A writable file is truncated to size() elements.
+     */
+    void close();
+    /** Write dirty pages back to the file (msync).
+     */
+    void flush(bool async = false);
+    /** Tell the kernel how the mapping is going to be accessed (madvise).
+        The hint is kept and re-applied whenever the mapping moves.
+     */
+    void advise(access_hint hint);
+
+    bool is_open() const noexcept { return fd_ != -1; }
+
+    bool read_only() const noexcept { return !writable_; }
+
+    // iterators:
+    // NOTE the non-const accessors hand out writable memory; a read_only
+    // mapping is PROT_READ, use a const mapped_vector to read it.
+    iterator begin() noexcept {
+        ASSERT(can_write_(), "non-const access to a read-only mapping");
+        return begin_;
+    }
+
+    const_iterator begin() const noexcept { return begin_; }
+
+    iterator end() noexcept {
+        ASSERT(can_write_(), "non-const access to a read-only mapping");
+        return begin_ + size_;
+    }
+
+    const_iterator end() const noexcept { return begin_ + size_; }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    const_iterator cend() const noexcept { return end(); }
+
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+
+    size_type max_size() const noexcept {
+        return std::numeric_limits<off_t>::max() / sizeof(value_type);
+    }
+
+    void resize(size_type sz) { resize(sz, value_type()); }
+
+    void resize(size_type sz, const T& c);
+
+    size_type capacity() const noexcept { return capacity_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    void reserve(size_type n) {
+        if (n > capacity_) {
+            remap_(n);
+        }
+    }
+
+    void shrink_to_fit() {
+        if (size_ < capacity_) {
+            remap_(size_);
+        }
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        ASSERT(n < size(), "out of range access");
+        ASSERT(can_write_(), "non-const access to a read-only mapping");
+        return begin_[n];
+    }
+
+    const_reference operator[](size_type n) const {
+        ASSERT(n < size(), "out of range access");
+        return begin_[n];
+    }
+
+    reference front() {
+        ASSERT(can_write_(), "non-const access to a read-only mapping");
+        return begin_[0];
+    }
+
+    const_reference front() const { return begin_[0]; }
+
+    reference back() {
+        ASSERT(can_write_(), "non-const access to a read-only mapping");
+        return begin_[size_ - 1];
+    }
+
+    const_reference back() const { return begin_[size_ - 1]; }
+
+    // data access
+    T* data() noexcept {
+        ASSERT(can_write_(), "non-const access to a read-only mapping");
+        return begin_;
+    }
+
+    const T* data() const noexcept { return begin_; }
+
+    // modifiers:
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+        ensure_capacity_(size_ + 1);
+        ::new (static_cast<void*>(begin_ + size_))
+            value_type(std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    void push_back(const T& x) { emplace_back(x); }
+
+    void pop_back() {
+        ASSERT(size_ > 0, "pop_back on empty mapped_vector");
+        --size_;
+    }
+
+    void swap(mapped_vector& x) noexcept {
+        using std::swap;
+        swap(fd_, x.fd_);
+        swap(begin_, x.begin_);
+        swap(size_, x.size_);
+        swap(capacity_, x.capacity_);
+        swap(writable_, x.writable_);
+        swap(hint_, x.hint_);
+    }
+
+    // T is trivially copyable, there is nothing to destroy.
+    void clear() noexcept { size_ = 0; }
+
+   private:
+    int fd_ = -1;
+    pointer begin_ = nullptr;
+    size_type size_ = 0;
+    size_type capacity_ = 0;
+    bool writable_ = false;
+    access_hint hint_ = access_hint::normal;
+
+    // a closed vector has nothing to protect.
+    bool can_write_() const noexcept { return fd_ == -1 || writable_; }
+
+    static void throw_errno_(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    void ensure_capacity_(size_type n) {
+        if (n > capacity_) {
+            remap_(std::max(2 * capacity_, n));
+        }
+    }
+
+    /** Resize the file to new_cap elements and move the mapping with it.
+     */
+    void remap_(size_type new_cap);
+    void map_(size_type n);
+    void apply_hint_() noexcept;
+    void close_noexcept_() noexcept;
+};
+
+template <class T>
+void mapped_vector<T>::open(const char* path, map_mode mode) {
+    close();
+    int flags = O_RDONLY;
+    if (mode == map_mode::read_write) {
+        flags = O_RDWR | O_CREAT;
+    } else if (mode == map_mode::truncate) {
+        flags = O_RDWR | O_CREAT | O_TRUNC;
+    }
+    int fd = ::open(path, flags | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        throw_errno_("mapped_vector: open");
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throw_errno_("mapped_vector: fstat");
+    }
+    fd_ = fd;
+    writable_ = mode != map_mode::read_only;
+    // NOTE a trailing partial element is neither mapped nor counted as
+    // capacity: an unmodified close() keeps it, any growth drops it.
+    size_type n = static_cast<size_type>(st.st_size) / sizeof(value_type);
+    try {
+        map_(n);
+    } catch (...) {
+        ::close(fd_);
+        fd_ = -1;
+        throw;
+    }
+    size_ = n;
+}
+
+template <class T>
+void mapped_vector<T>::close() {
+    if (fd_ == -1) {
+        return;
+    }
+    int fd = fd_;
+    if (begin_ != nullptr) {
+        ::munmap(begin_, capacity_ * sizeof(value_type));
+    }
+    bool shrink = writable_ && size_ != capacity_;
+    off_t length = static_cast<off_t>(size_ * sizeof(value_type));
+    fd_ = -1;
+    begin_ = nullptr;
+    size_ = capacity_ = 0;
+    writable_ = false;
+    hint_ = access_hint::normal;
+    if (shrink && ::ftruncate(fd, length) == -1) {
+        int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throw_errno_("mapped_vector: ftruncate");
+    }
+    if (::close(fd) == -1) {
+        throw_errno_("mapped_vector: close");
+    }
+}
+
+template <class T>
+void mapped_vector<T>::flush(bool async) {
+    if (begin_ == nullptr || !writable_) {
+        return;
+    }
+    if (::msync(begin_, size_ * sizeof(value_type),
+                async ? MS_ASYNC : MS_SYNC) == -1) {
+        throw_errno_("mapped_vector: msync");
+    }
+}
+
+template <class T>
+void mapped_vector<T>::advise(access_hint hint) {
+    hint_ = hint;
+    apply_hint_();
+}
+
+template <class T>
+void mapped_vector<T>::resize(size_type sz, const T& c) {
+    if (sz > size_) {
+        ensure_capacity_(sz);
+        std::uninitialized_fill(begin_ + size_, begin_ + sz, c);
+    }
+    size_ = sz;
+}
+
+// private methods
+
+template <class T>
+void mapped_vector<T>::remap_(size_type new_cap) {
+    ASSERT(fd_ != -1, "mapped_vector is not open");
+    ASSERT(new_cap >= size_, "remap_ would drop elements");
+    if (new_cap > max_size()) {
+        throw std::length_error("mapped_vector: capacity exceeds max_size()");
+    }
+    // ftruncate fails with EINVAL/EBADF on a file opened read-only.
+    if (::ftruncate(fd_, static_cast<off_t>(new_cap * sizeof(value_type))) ==
+        -1) {
+        throw_errno_("mapped_vector: ftruncate");
+    }
+    try {
+        map_(new_cap);
+    } catch (...) {
+        // close() only truncates when size_ != capacity_: give the file
+        // back the length of the mapping, or a full vector would keep the
+        // zeroed elements.
+        (void)::ftruncate(fd_,
+                          static_cast<off_t>(capacity_ * sizeof(value_type)));
+        throw;
+    }
+}
+
+template <class T>
+void mapped_vector<T>::map_(size_type n) {
+    std::size_t old_bytes = capacity_ * sizeof(value_type);
+    std::size_t new_bytes = n * sizeof(value_type);
+    if (new_bytes == 0) {
+        // mmap does not accept an empty mapping.
+        if (begin_ != nullptr) {
+            ::munmap(begin_, old_bytes);
+        }
+        begin_ = nullptr;
+        capacity_ = 0;
+        return;
+    }
+    void* addr = MAP_FAILED;
+#if defined(MREMAP_MAYMOVE)
+    if (begin_ != nullptr) {
+        // The kernel moves the page table entries, no data is copied.
+        addr = ::mremap(begin_, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (addr == MAP_FAILED) {
+            throw_errno_("mapped_vector: mremap");
+        }
+    }
+#endif
+    if (addr == MAP_FAILED) {
+        int prot = writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        addr = ::mmap(nullptr, new_bytes, prot, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            throw_errno_("mapped_vector: mmap");
+        }
+        if (begin_ != nullptr) {
+            ::munmap(begin_, old_bytes);
+        }
+    }
+    begin_ = static_cast<pointer>(addr);
+    capacity_ = n;
+    apply_hint_();
+}
+
+template <class T>
+void mapped_vector<T>::apply_hint_() noexcept {
+    if (begin_ == nullptr) {
+        return;
+    }
+    int advice = MADV_NORMAL;
+    switch (hint_) {
+        case access_hint::normal:
+            advice = MADV_NORMAL;
+            break;
+        case access_hint::sequential:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case access_hint::random:
+            advice = MADV_RANDOM;
+            break;
+        case access_hint::will_need:
+            advice = MADV_WILLNEED;
+            break;
+        case access_hint::dont_need:
+            advice = MADV_DONTNEED;
+            break;
+    }
+    // NOTE madvise is only a hint, a failure is not an error.
+    ::madvise(begin_, capacity_ * sizeof(value_type), advice);
+}
+
+template <class T>
+void mapped_vector<T>::close_noexcept_() noexcept {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
@@ -0,0 +1,434 @@
+#ifndef LEARN_CPP_CONTAINERS_PACKED_INT_VECTOR_HPP
+#define LEARN_CPP_CONTAINERS_PACKED_INT_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_PACKED_INT_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+namespace bit_packing {
+
+/*
+   Kernels on groups of 64 values of W bits, stored in W words, value j at
+   bit j * W. W is a template argument so that every shift and mask of the
+   fully unrolled loop is a constant: no branch, no loop-carried state, and
+   the compiler schedules (and where it can, vectorizes) the whole group.
+   The tables below pick the kernel for a width known at run time.
+ */
+
+inline std::uint64_t mask(unsigned bits) {
+    return bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+}
+
+/** The bits needed for values up to max_value, 0 for 0.
+ */
+inline unsigned bits_for(std::uint64_t max_value) {
+    return max_value == 0 ? 0 : 64 - __builtin_clzll(max_value);
+}
+
+template <unsigned W>
+void unpack64(const std::uint64_t* in, std::uint64_t* out) {
+    constexpr std::uint64_t m =
+        W == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << W) - 1;
+#pragma GCC unroll 64
+    for (unsigned j = 0; j < 64; ++j) {
+        const unsigned pos = j * W;
+        const unsigned word = pos / 64;
+        const unsigned off = pos % 64;
+        std::uint64_t v = W == 0 ? 0 : in[word] >> off;
+        if (off + W > 64) {
+            // & 63: no warning in the instances where this is dead code
+            v |= in[word + 1] << ((64 - off) & 63);
+        }
+        out[j] = v & m;
+    }
+}
+
+// the values must fit in W bits.
+template <unsigned W>
+void pack64(const std::uint64_t* in, std::uint64_t* out) {
+    for (unsigned k = 0; k < W; ++k) {
+        out[k] = 0;
+    }
+#pragma GCC unroll 64
+    for (unsigned j = 0; j < 64; ++j) {
+        const unsigned pos = j * W;
+        const unsigned word = pos / 64;
+        const unsigned off = pos % 64;
+        if (W != 0) {
+            out[word] |= in[j] << off;
+        }
+        if (off + W > 64) {
+            out[word + 1] |= in[j] >> ((64 - off) & 63);
+        }
+    }
+}
+
+using kernel = void (*)(const std::uint64_t*, std::uint64_t*);
+
+template <std::size_t... W>
+const kernel* unpack_table(std::index_sequence<W...>) {
+    static const kernel table[] = {&unpack64<W>...};
+    return table;
+}
+
+template <std::size_t... W>
+const kernel* pack_table(std::index_sequence<W...>) {
+    static const kernel table[] = {&pack64<W>...};
+    return table;
+}
+
+/** Unpack 64 values of bits bits, 0 to 64.
+ */
+inline void unpack64(unsigned bits, const std::uint64_t* in,
+                     std::uint64_t* out) {
+    static const kernel* table = unpack_table(std::make_index_sequence<65>());
+    table[bits](in, out);
+}
+
+inline void pack64(unsigned bits, const std::uint64_t* in,
+                   std::uint64_t* out) {
+    static const kernel* table = pack_table(std::make_index_sequence<65>());
+    table[bits](in, out);
+}
+
+/** Value i of bits bits, at bit i * bits of words. The word after the
+    value must be readable.
+ */
+inline std::uint64_t get(const std::uint64_t* words, unsigned bits,
+                         std::size_t i) {
+    std::size_t pos = i * bits;
+    const std::uint64_t* p = words + pos / 64;
+    unsigned off = pos % 64;
+    // << 1 << (63 - off) is << (64 - off) without the undefined shift by 64
+    std::uint64_t v = (p[0] >> off) | (p[1] << 1 << (63 - off));
+    return v & mask(bits);
+}
+
+inline void set(std::uint64_t* words, unsigned bits, std::size_t i,
+                std::uint64_t value) {
+    std::size_t pos = i * bits;
+    std::uint64_t* p = words + pos / 64;
+    unsigned off = pos % 64;
+    std::uint64_t m = mask(bits);
+    p[0] = (p[0] & ~(m << off)) | (value << off);
+    if (off + bits > 64) {
+        unsigned shift = 64 - off;
+        p[1] = (p[1] & ~(m >> shift)) | (value >> shift);
+    }
+}
+
+}  // namespace bit_packing
+
+/**
+   Unsigned integers of a fixed bit width, 1 to 64, packed back to back in
+   a v1::vector<uint64_t>: n values take n * bits / 8 bytes (plus a word),
+   instead of 8 * n.
+
+   operator[] is two loads and three shifts. decode() unpacks a range in
+   groups of 64 values with the kernels of bit_packing, several times
+   faster than element by element.
+ */
+class packed_int_vector {
+   public:
+    // types
+    // clang-format off
+    using value_type             = std::uint64_t;
+    using size_type              = std::size_t;
+    // clang-format on
+
+    explicit packed_int_vector(unsigned bits) : bits_(bits), words_(1) {
+        if (bits == 0 || bits > 64) {
+            throw std::invalid_argument("packed_int_vector: bits");
+        }
+    }
+
+    unsigned bits() const noexcept { return bits_; }
+    value_type max_value() const noexcept { return bit_packing::mask(bits_); }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    void reserve(size_type n) { words_.reserve(words_for_(n)); }
+
+    /** The bytes allocated for the values.
+     */
+    std::size_t memory_bytes() const noexcept {
+        return words_.capacity() * sizeof(std::uint64_t);
+    }
+
+    // element access:
+    value_type operator[](size_type i) const {
+        ASSERT(i < size_, "out of range access");
+        return bit_packing::get(words_.data(), bits_, i);
+    }
+
+    value_type at(size_type i) const {
+        if (i >= size_) {
+            throw std::out_of_range("packed_int_vector::at");
+        }
+        return (*this)[i];
+    }
+
+    value_type back() const { return (*this)[size_ - 1]; }
+
+    /** Values [first, first + n) into out.
+     */
+    void decode(size_type first, size_type n, value_type* out) const {
+        ASSERT(first + n <= size_, "out of range decode");
+        size_type i = first;
+        size_type last = first + n;
+        for (; i < last && i % 64 != 0; ++i) {
+            *out++ = (*this)[i];
+        }
+        for (; i + 64 <= last; i += 64, out += 64) {
+            bit_packing::unpack64(bits_, words_.data() + i / 64 * bits_, out);
+        }
+        for (; i < last; ++i) {
+            *out++ = (*this)[i];
+        }
+    }
+
+    /** All the values, into out (resized).
+     */
+    template <class Allocator>
+    void decode(v1::vector<value_type, Allocator>& out) const {
+        out.resize(size_);
+        decode(0, size_, out.data());
+    }
+
+    // modifiers:
+    void set(size_type i, value_type value) {
+        ASSERT(i < size_, "out of range access");
+        ASSERT(value <= max_value(), "value does not fit");
+        bit_packing::set(words_.data(), bits_, i, value);
+    }
+
+    void push_back(value_type value) {
+        ASSERT(value <= max_value(), "value does not fit");
+        size_type words = words_for_(size_ + 1);
+        while (words_.size() < words) {
+            words_.push_back(0);
+        }
+        bit_packing::set(words_.data(), bits_, size_, value);
+        ++size_;
+    }
+
+    void clear() {
+        words_.clear();
+        words_.push_back(0);
+        size_ = 0;
+    }
+
+    void swap(packed_int_vector& x) noexcept {
+        std::swap(bits_, x.bits_);
+        words_.swap(x.words_);
+        std::swap(size_, x.size_);
+    }
+
+   private:
+    unsigned bits_;
+    v1::vector<std::uint64_t> words_;
+    size_type size_ = 0;
+
+    // the words of n values, and the one get() reads past the last value.
+    size_type words_for_(size_type n) const {
+        return (n * bits_ + 63) / 64 + 1;
+    }
+};
+
+/**
+   Non-decreasing unsigned integers (sorted IDs, timestamps), compressed
+   in blocks of kBlockSize. A block stores the line from its first to its
+   last value, base + j * step, and the distance of every value j to that
+   line, bit-packed with the width of the largest.
+
+   Regular data needs a few bits per value: timestamps exactly 10 us apart
+   are on the line and take no bits, only the 1.5 bits per value of the
+   block header; with a jitter of +-1 us they take about 12. Unlike deltas
+   between neighbours, the line keeps operator[] O(1). The last, incomplete
+   block is kept as plain values until it is full.
+ */
+class delta_packed_int_vector {
+   public:
+    // types
+    // clang-format off
+    using value_type             = std::uint64_t;
+    using size_type              = std::size_t;
+    // clang-format on
+
+    static constexpr size_type kBlockSize = 128;
+
+    delta_packed_int_vector() : words_(1) {}
+
+    // capacity:
+    size_type size() const noexcept {
+        return blocks_.size() * kBlockSize + tail_size_;
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    std::size_t memory_bytes() const noexcept {
+        return words_.capacity() * sizeof(std::uint64_t) +
+               blocks_.capacity() * sizeof(Block) + sizeof(tail_);
+    }
+
+    // element access:
+    value_type operator[](size_type i) const {
+        ASSERT(i < size(), "out of range access");
+        size_type b = i / kBlockSize;
+        if (b == blocks_.size()) {
+            return tail_[i % kBlockSize];
+        }
+        const Block& block = blocks_[b];
+        size_type j = i % kBlockSize;
+        value_type on_line = block.base + j * block.step;
+        if (block.bits == 0) {
+            // no words, every value on the line
+            return on_line;
+        }
+        return on_line +
+               bit_packing::get(words_.data() + block.offset, block.bits, j);
+    }
+
+    value_type at(size_type i) const {
+        if (i >= size()) {
+            throw std::out_of_range("delta_packed_int_vector::at");
+        }
+        return (*this)[i];
+    }
+
+    value_type back() const { return (*this)[size() - 1]; }
+
+    /** Values [first, first + n) into out.
+     */
+    void decode(size_type first, size_type n, value_type* out) const {
+        ASSERT(first + n <= size(), "out of range decode");
+        size_type i = first;
+        size_type last = first + n;
+        for (; i < last && i % kBlockSize != 0; ++i) {
+            *out++ = (*this)[i];
+        }
+        for (; i + kBlockSize <= last && i / kBlockSize < blocks_.size();
+             i += kBlockSize, out += kBlockSize) {
+            decode_block_(blocks_[i / kBlockSize], out);
+        }
+        for (; i < last; ++i) {
+            *out++ = (*this)[i];
+        }
+    }
+
+    template <class Allocator>
+    void decode(v1::vector<value_type, Allocator>& out) const {
+        out.resize(size());
+        decode(0, size(), out.data());
+    }
+
+    // modifiers:
+    void push_back(value_type value) {
+        ASSERT(empty() || value >= back(), "values must not decrease");
+        tail_[tail_size_++] = value;
+        if (tail_size_ == kBlockSize) {
+            flush_();
+        }
+    }
+
+    void clear() {
+        words_.clear();
+        words_.push_back(0);
+        blocks_.clear();
+        tail_size_ = 0;
+    }
+
+   private:
+    // values are base + j * step + the packed distance, modulo 2^64.
+    struct Block {
+        value_type base;
+        value_type step;
+        // into words_
+        std::uint64_t offset : 56;
+        std::uint64_t bits : 8;
+    };
+
+    v1::vector<std::uint64_t> words_;
+    v1::vector<Block> blocks_;
+    value_type tail_[kBlockSize];
+    size_type tail_size_ = 0;
+
+    void flush_() {
+        value_type first = tail_[0];
+        value_type range = tail_[kBlockSize - 1] - first;
+        value_type step = range < (value_type(1) << 62)
+                              ? range / (kBlockSize - 1)
+                              : 0;
+        // distances from the line, modulo 2^64. A flat line leaves every
+        // value in [first, first + range]; on a sloped one they are within
+        // +-range < 2^62 and compare as signed.
+        value_type low = 0;
+        value_type high = range;
+        if (step != 0) {
+            std::int64_t lowest = 0;
+            std::int64_t highest = 0;
+            for (size_type j = 0; j < kBlockSize; ++j) {
+                std::int64_t d = std::int64_t(tail_[j] - first - j * step);
+                lowest = d < lowest ? d : lowest;
+                highest = d > highest ? d : highest;
+            }
+            low = value_type(lowest);
+            high = value_type(highest);
+        }
+        // the line moved down to the lowest value
+        value_type base = first + low;
+        value_type deltas[kBlockSize];
+        for (size_type j = 0; j < kBlockSize; ++j) {
+            deltas[j] = tail_[j] - base - j * step;
+        }
+        unsigned bits = bit_packing::bits_for(high - low);
+        // the last word is the one get() may read past the end.
+        size_type offset = words_.size() - 1;
+        words_.resize(offset + kBlockSize / 64 * bits + 1);
+        for (size_type g = 0; g < kBlockSize / 64; ++g) {
+            bit_packing::pack64(bits, deltas + g * 64,
+                                words_.data() + offset + g * bits);
+        }
+        Block block;
+        block.base = base;
+        block.step = step;
+        block.offset = offset;
+        block.bits = bits;
+        blocks_.push_back(block);
+        tail_size_ = 0;
+    }
+
+    void decode_block_(const Block& block, value_type* out) const {
+        for (size_type g = 0; g < kBlockSize / 64; ++g) {
+            bit_packing::unpack64(
+                block.bits, words_.data() + block.offset + g * block.bits,
+                out + g * 64);
+        }
+        value_type on_line = block.base;
+        for (size_type j = 0; j < kBlockSize; ++j) {
+            out[j] += on_line;
+            on_line += block.step;
+        }
+    }
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
@@ -0,0 +1,379 @@
+#ifndef LEARN_CPP_CONTAINERS_SEGMENTED_VECTOR_HPP
+#define LEARN_CPP_CONTAINERS_SEGMENTED_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_SEGMENTED_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+// Elements per chunk: about 16KB, rounded down to a power of two.
+template <class T>
+constexpr std::size_t default_chunk_size() {
+    std::size_t n = 1;
+    while (n * 2 * sizeof(T) <= 16384) {
+        n *= 2;
+    }
+    return n;
+}
+
+/**
+   A vector made of fixed-size chunks, tracked by a small index of chunk
+   pointers.
+
+   Growing appends a chunk; existing elements are never moved, so pointers
+   and references stay valid until the element is erased, and no push_back
+   has to copy the whole container. Element i is
+   chunks_[i >> kChunkShift][i & kChunkMask].
+
+   Each chunk is contiguous, for_each_segment() hands them out as plain
+   arrays for scans the compiler can vectorize.
+ */
+template <class T, std::size_t ChunkSize = default_chunk_size<T>(),
+          class Allocator = std::allocator<T>>
+class segmented_vector {
+    static_assert(ChunkSize != 0 && (ChunkSize & (ChunkSize - 1)) == 0,
+                  "ChunkSize must be a power of two");
+    static_assert(std::is_same<typename Allocator::value_type, T>::value,
+                  "Allocator::value_type must be T");
+
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+   public:
+    // types
+    // clang-format off
+    using value_type             = T;
+    using allocator_type         = Allocator;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    // clang-format on
+
+    template <bool Const>
+    class basic_iterator;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    static constexpr size_type kChunkSize = ChunkSize;
+    static constexpr size_type kChunkMask = ChunkSize - 1;
+    static constexpr int kChunkShift = __builtin_ctzll(ChunkSize);
+
+    // construct/copy/destroy:
+    segmented_vector() = default;
+
+    explicit segmented_vector(const Allocator& a) : alloc_(a) {}
+
+    // delegates first, so a throwing copy runs the destructor.
+    segmented_vector(const segmented_vector& x)
+        : segmented_vector(
+              alloc_traits::select_on_container_copy_construction(x.alloc_)) {
+        reserve(x.size());
+        for (const auto& item : x) {
+            emplace_back(item);
+        }
+    }
+
+    segmented_vector(segmented_vector&& x) noexcept
+        : chunks_(std::move(x.chunks_)),
+          size_(x.size_),
+          alloc_(std::move(x.alloc_)) {
+        x.size_ = 0;
+    }
+
+    ~segmented_vector() {
+        clear();
+        release_chunks_(0);
+    }
+
+    // NOTE the allocator goes with the contents: x was copy or move
+    // constructed from the source, and swap takes its allocator.
+    segmented_vector& operator=(segmented_vector x) noexcept {
+        swap(x);
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc_; }
+
+    // iterators:
+    iterator begin() noexcept { return iterator(this, 0); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // capacity:
+    size_type size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    size_type capacity() const noexcept { return chunks_.size() * kChunkSize; }
+
+    /** Allocate chunks for n elements up front.
+     */
+    void reserve(size_type n) {
+        while (capacity() < n) {
+            add_chunk_();
+        }
+    }
+
+    /** Release the chunks past the last element.
+     */
+    void shrink_to_fit() {
+        release_chunks_((size_ + kChunkMask) >> kChunkShift);
+    }
+
+    // element access:
+    reference operator[](size_type n) {
+        ASSERT(n < size_, "out of range access");
+        return chunks_[n >> kChunkShift][n & kChunkMask];
+    }
+
+    const_reference operator[](size_type n) const {
+        ASSERT(n < size_, "out of range access");
+        return chunks_[n >> kChunkShift][n & kChunkMask];
+    }
+
+    reference at(size_type n) {
+        if (n >= size_) {
+            throw std::out_of_range("segmented_vector::at");
+        }
+        return (*this)[n];
+    }
+
+    const_reference at(size_type n) const {
+        if (n >= size_) {
+            throw std::out_of_range("segmented_vector::at");
+        }
+        return (*this)[n];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    const_reference back() const { return (*this)[size_ - 1]; }
+
+    // segments:
+    size_type segment_count() const noexcept {
+        return (size_ + kChunkMask) >> kChunkShift;
+    }
+
+    /** The k-th run of contiguous elements, [segment_data(k),
+        segment_data(k) + segment_size(k)).
+     */
+    pointer segment_data(size_type k) noexcept { return chunks_[k]; }
+    const_pointer segment_data(size_type k) const noexcept {
+        return chunks_[k];
+    }
+
+    size_type segment_size(size_type k) const noexcept {
+        ASSERT(k < segment_count(), "out of range segment");
+        return k + 1 < segment_count() ? kChunkSize
+                                       : size_ - (k << kChunkShift);
+    }
+
+    /** Call fn(first, last) on every segment, in order.
+     */
+    template <class Fn>
+    void for_each_segment(Fn fn) {
+        for (size_type k = 0, n = segment_count(); k < n; ++k) {
+            fn(chunks_[k], chunks_[k] + segment_size(k));
+        }
+    }
+
+    template <class Fn>
+    void for_each_segment(Fn fn) const {
+        for (size_type k = 0, n = segment_count(); k < n; ++k) {
+            fn(const_pointer(chunks_[k]), chunks_[k] + segment_size(k));
+        }
+    }
+
+    // modifiers:
+    template <class... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity()) {
+            add_chunk_();
+        }
+        pointer p = chunks_[size_ >> kChunkShift] + (size_ & kChunkMask);
+        alloc_traits::construct(alloc_, p, std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    void push_back(const T& x) { emplace_back(x); }
+
+    void push_back(T&& x) { emplace_back(std::move(x)); }
+
+    void pop_back() {
+        ASSERT(size_ != 0, "pop_back on empty segmented_vector");
+        --size_;
+        alloc_traits::destroy(
+            alloc_, chunks_[size_ >> kChunkShift] + (size_ & kChunkMask));
+    }
+
+    /** Destroy the elements, keep the chunks.
+     */
+    void clear() noexcept {
+        for_each_segment([this](pointer first, pointer last) {
+            for (; first != last; ++first) {
+                alloc_traits::destroy(alloc_, first);
+            }
+        });
+        size_ = 0;
+    }
+
+    void swap(segmented_vector& x) noexcept {
+        using std::swap;
+        chunks_.swap(x.chunks_);
+        swap(size_, x.size_);
+        swap(alloc_, x.alloc_);
+    }
+
+   private:
+    v1::vector<pointer> chunks_;
+    size_type size_ = 0;
+    allocator_type alloc_;
+
+    void add_chunk_() {
+        pointer chunk = alloc_traits::allocate(alloc_, kChunkSize);
+        try {
+            chunks_.push_back(chunk);
+        } catch (...) {
+            alloc_traits::deallocate(alloc_, chunk, kChunkSize);
+            throw;
+        }
+    }
+
+    // free the chunks from index `keep` on, they hold no elements.
+    void release_chunks_(size_type keep) noexcept {
+        while (chunks_.size() > keep) {
+            alloc_traits::deallocate(alloc_, chunks_[chunks_.size() - 1],
+                                     kChunkSize);
+            chunks_.pop_back();
+        }
+    }
+};
+
+/**
+   Random access iterator: the container and a position. It stays valid while
+   the container grows, like references do; dereference is a shift and a
+   mask.
+ */
+template <class T, std::size_t ChunkSize, class Allocator>
+template <bool Const>
+class segmented_vector<T, ChunkSize, Allocator>::basic_iterator {
+    using container = typename std::conditional<Const, const segmented_vector,
+                                                segmented_vector>::type;
+
+   public:
+    // clang-format off
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type        = T;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = std::conditional_t<Const, const T*, T*>;
+    using reference         = std::conditional_t<Const, const T&, T&>;
+    // clang-format on
+
+    basic_iterator() = default;
+
+    basic_iterator(container* c, size_type i) : c_(c), i_(i) {}
+
+    // iterator -> const_iterator
+    template <bool OtherConst,
+              class = typename std::enable_if<Const && !OtherConst>::type>
+    basic_iterator(const basic_iterator<OtherConst>& x)
+        : c_(x.c_), i_(x.i_) {}
+
+    reference operator*() const { return (*c_)[i_]; }
+    pointer operator->() const { return std::addressof((*c_)[i_]); }
+    reference operator[](difference_type n) const { return (*c_)[i_ + n]; }
+
+    basic_iterator& operator++() {
+        ++i_;
+        return *this;
+    }
+    basic_iterator operator++(int) {
+        auto old = *this;
+        ++i_;
+        return old;
+    }
+    basic_iterator& operator--() {
+        --i_;
+        return *this;
+    }
+    basic_iterator operator--(int) {
+        auto old = *this;
+        --i_;
+        return old;
+    }
+    basic_iterator& operator+=(difference_type n) {
+        i_ += n;
+        return *this;
+    }
+    basic_iterator& operator-=(difference_type n) {
+        i_ -= n;
+        return *this;
+    }
+    friend basic_iterator operator+(basic_iterator it, difference_type n) {
+        return it += n;
+    }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) {
+        return it += n;
+    }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) {
+        return it -= n;
+    }
+    friend difference_type operator-(const basic_iterator& x,
+                                     const basic_iterator& y) {
+        return difference_type(x.i_) - difference_type(y.i_);
+    }
+
+    friend bool operator==(const basic_iterator& x, const basic_iterator& y) {
+        return x.i_ == y.i_;
+    }
+    friend bool operator!=(const basic_iterator& x, const basic_iterator& y) {
+        return x.i_ != y.i_;
+    }
+    friend bool operator<(const basic_iterator& x, const basic_iterator& y) {
+        return x.i_ < y.i_;
+    }
+    friend bool operator>(const basic_iterator& x, const basic_iterator& y) {
+        return y.i_ < x.i_;
+    }
+    friend bool operator<=(const basic_iterator& x, const basic_iterator& y) {
+        return !(y.i_ < x.i_);
+    }
+    friend bool operator>=(const basic_iterator& x, const basic_iterator& y) {
+        return !(x.i_ < y.i_);
+    }
+
+   private:
+    container* c_ = nullptr;
+    size_type i_ = 0;
+
+    template <bool OtherConst>
+    friend class basic_iterator;
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
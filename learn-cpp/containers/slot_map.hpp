@@ -0,0 +1,245 @@
+#ifndef LEARN_CPP_CONTAINERS_SLOT_MAP_HPP
+#define LEARN_CPP_CONTAINERS_SLOT_MAP_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_SLOT_MAP)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   A handle into a slot_map: the slot and its generation, 64 bits. The
+   default handle refers to nothing.
+ */
+struct slot_handle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    std::uint64_t value() const noexcept {
+        return std::uint64_t(generation) << 32 | index;
+    }
+
+    static slot_handle from_value(std::uint64_t v) noexcept {
+        return {static_cast<std::uint32_t>(v),
+                static_cast<std::uint32_t>(v >> 32)};
+    }
+
+    friend bool operator==(slot_handle x, slot_handle y) noexcept {
+        return x.index == y.index && x.generation == y.generation;
+    }
+
+    friend bool operator!=(slot_handle x, slot_handle y) noexcept {
+        return !(x == y);
+    }
+};
+
+/**
+   A pool of T with stable handles instead of pointers: the elements live
+   packed in one v1::vector, in no particular order, so a scan of the whole
+   pool is a loop over an array. Neither insert nor erase allocates once the
+   vectors have grown, and there is no control block per element.
+
+   A handle names a slot; the slot holds the element's index in the dense
+   vector. erase() moves the last element into the hole and repoints its
+   slot, and puts the erased slot on a free list for the next insert.
+
+   Every slot has a generation, odd while the slot is in use and bumped on
+   insert and on erase, so a handle to an erased element never matches
+   again: find() returns nullptr, erase() false. Only after 2^31 reuses of
+   the same slot does the generation wrap and an old handle match again.
+
+   Inserting may reallocate, erasing moves the last element: both
+   invalidate pointers and iterators, never handles.
+ */
+template <class T>
+class slot_map {
+   public:
+    // types
+    // clang-format off
+    using value_type             = T;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using size_type              = std::size_t;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using handle                 = slot_handle;
+    // clang-format on
+
+    // construct/copy/destroy:
+    slot_map() = default;
+
+    explicit slot_map(size_type n) { reserve(n); }
+
+    // iterators, over the dense elements:
+    iterator begin() noexcept { return values_.data(); }
+    const_iterator begin() const noexcept { return values_.data(); }
+    iterator end() noexcept { return values_.data() + values_.size(); }
+    const_iterator end() const noexcept {
+        return values_.data() + values_.size();
+    }
+
+    // capacity:
+    size_type size() const noexcept { return values_.size(); }
+    bool empty() const noexcept { return values_.empty(); }
+
+    void reserve(size_type n) {
+        values_.reserve(n);
+        dense_to_slot_.reserve(n);
+        slots_.reserve(n);
+    }
+
+    // element access:
+    bool contains(handle h) const noexcept {
+        return h.index < slots_.size() &&
+               slots_[h.index].generation == h.generation &&
+               (h.generation & 1) != 0;
+    }
+
+    /** The element of h, nullptr if it was erased.
+     */
+    T* find(handle h) noexcept {
+        return contains(h) ? &values_[slots_[h.index].index] : nullptr;
+    }
+
+    const T* find(handle h) const noexcept {
+        return contains(h) ? &values_[slots_[h.index].index] : nullptr;
+    }
+
+    T& operator[](handle h) {
+        ASSERT(contains(h), "stale handle");
+        return values_[slots_[h.index].index];
+    }
+
+    const T& operator[](handle h) const {
+        ASSERT(contains(h), "stale handle");
+        return values_[slots_[h.index].index];
+    }
+
+    T& at(handle h) {
+        if (!contains(h)) {
+            throw std::out_of_range("slot_map::at");
+        }
+        return values_[slots_[h.index].index];
+    }
+
+    const T& at(handle h) const {
+        if (!contains(h)) {
+            throw std::out_of_range("slot_map::at");
+        }
+        return values_[slots_[h.index].index];
+    }
+
+    /** The handle of the element at position i of the dense order.
+     */
+    handle handle_at(size_type i) const {
+        ASSERT(i < size(), "out of range access");
+        std::uint32_t slot = dense_to_slot_[i];
+        return {slot, slots_[slot].generation};
+    }
+
+    // modifiers:
+    template <class... Args>
+    handle emplace(Args&&... args) {
+        std::uint32_t slot = free_head_;
+        if (slot == kNoSlot) {
+            // a new free slot, left on the free list if T throws
+            if (slots_.size() == kNoSlot) {
+                throw std::length_error("slot_map: too many slots");
+            }
+            slot = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back(Slot{kNoSlot, 0});
+            free_head_ = slot;
+        }
+        dense_to_slot_.push_back(slot);
+        try {
+            values_.emplace_back(std::forward<Args>(args)...);
+        } catch (...) {
+            dense_to_slot_.pop_back();
+            throw;
+        }
+        Slot& s = slots_[slot];
+        free_head_ = s.index;
+        s.index = static_cast<std::uint32_t>(values_.size() - 1);
+        ++s.generation;
+        return {slot, s.generation};
+    }
+
+    handle insert(const T& value) { return emplace(value); }
+    handle insert(T&& value) { return emplace(std::move(value)); }
+
+    /** Erase the element of h, false if it was already erased. The last
+        element of the dense order takes its place.
+     */
+    bool erase(handle h) {
+        if (!contains(h)) {
+            return false;
+        }
+        Slot& s = slots_[h.index];
+        size_type i = s.index;
+        size_type last = values_.size() - 1;
+        if (i != last) {
+            values_[i] = std::move(values_[last]);
+            std::uint32_t moved = dense_to_slot_[last];
+            dense_to_slot_[i] = moved;
+            slots_[moved].index = static_cast<std::uint32_t>(i);
+        }
+        values_.pop_back();
+        dense_to_slot_.pop_back();
+        ++s.generation;
+        s.index = free_head_;
+        free_head_ = h.index;
+        return true;
+    }
+
+    /** Erase every element; all handles become stale, the slots are kept.
+     */
+    void clear() noexcept {
+        for (size_type i = 0; i < dense_to_slot_.size(); ++i) {
+            std::uint32_t slot = dense_to_slot_[i];
+            ++slots_[slot].generation;
+            slots_[slot].index = free_head_;
+            free_head_ = slot;
+        }
+        values_.clear();
+        dense_to_slot_.clear();
+    }
+
+    void swap(slot_map& x) noexcept {
+        values_.swap(x.values_);
+        dense_to_slot_.swap(x.dense_to_slot_);
+        slots_.swap(x.slots_);
+        std::swap(free_head_, x.free_head_);
+    }
+
+   private:
+    static constexpr std::uint32_t kNoSlot = ~std::uint32_t(0);
+
+    // in use: index in values_; free: the next free slot.
+    struct Slot {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    v1::vector<T> values_;
+    v1::vector<std::uint32_t> dense_to_slot_;
+    v1::vector<Slot> slots_;
+    std::uint32_t free_head_ = kNoSlot;
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
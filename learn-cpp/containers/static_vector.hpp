@@ -0,0 +1,461 @@
+#ifndef LEARN_CPP_CONTAINERS_STATIC_VECTOR_HPP
+#define LEARN_CPP_CONTAINERS_STATIC_VECTOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_STATIC_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   What a static_vector does when an element does not fit. The growing
+   functions return false (or nullptr, end()) when overflow() does.
+ */
+
+// A bug: assert in debug builds, abort in release builds.
+struct overflow_assert {
+    static bool overflow(const char* what) {
+        assert(false && "static_vector overflow");
+        (void)what;
+        std::abort();
+    }
+};
+
+struct overflow_throw {
+    static bool overflow(const char* what) { throw std::length_error(what); }
+};
+
+// Expected: leave the vector as it is and report it to the caller.
+struct overflow_report {
+    static constexpr bool overflow(const char*) { return false; }
+};
+
+// Inline storage for N elements. Trivial types live in a plain array, so
+// the vector is trivially copyable and usable in constant expressions (the
+// array is zeroed on construction); other types are constructed in raw
+// bytes. The bytes are copied as they are when T is trivially copyable and
+// destructible, else the elements are copied and destroyed one by one.
+template <class T, std::size_t N, bool Trivial = std::is_trivial<T>::value,
+          bool TriviallyCopyable = std::is_trivially_copyable<T>::value &&
+                                   std::is_trivially_destructible<T>::value>
+class static_vector_storage {
+   protected:
+    T data_[N] = {};
+    std::size_t size_ = 0;
+
+    constexpr T* ptr_(std::size_t i) noexcept { return data_ + i; }
+    constexpr const T* ptr_(std::size_t i) const noexcept { return data_ + i; }
+
+    template <class... Args>
+    constexpr void construct_(std::size_t i, Args&&... args) {
+        data_[i] = T(std::forward<Args>(args)...);
+    }
+
+    constexpr void destroy_(std::size_t) noexcept {}
+};
+
+template <class T, std::size_t N>
+class static_vector_storage<T, N, false, true> {
+   protected:
+    static_vector_storage() noexcept {}
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data_[N];
+    std::size_t size_ = 0;
+
+    T* ptr_(std::size_t i) noexcept {
+        return std::launder(reinterpret_cast<T*>(data_ + i));
+    }
+    const T* ptr_(std::size_t i) const noexcept {
+        return std::launder(reinterpret_cast<const T*>(data_ + i));
+    }
+
+    template <class... Args>
+    void construct_(std::size_t i, Args&&... args) {
+        ::new (static_cast<void*>(data_ + i)) T(std::forward<Args>(args)...);
+    }
+
+    void destroy_(std::size_t) noexcept {}
+};
+
+template <class T, std::size_t N>
+class static_vector_storage<T, N, false, false> {
+   protected:
+    static_vector_storage() noexcept {}
+
+    static_vector_storage(const static_vector_storage& x) {
+        for (; size_ < x.size_; ++size_) {
+            construct_(size_, *x.ptr_(size_));
+        }
+    }
+
+    static_vector_storage(static_vector_storage&& x) noexcept(
+        std::is_nothrow_move_constructible<T>::value) {
+        for (; size_ < x.size_; ++size_) {
+            construct_(size_, std::move(*x.ptr_(size_)));
+        }
+    }
+
+    static_vector_storage& operator=(const static_vector_storage& x) {
+        if (this != &x) {
+            destroy_all_();
+            for (; size_ < x.size_; ++size_) {
+                construct_(size_, *x.ptr_(size_));
+            }
+        }
+        return *this;
+    }
+
+    static_vector_storage& operator=(static_vector_storage&& x) noexcept(
+        std::is_nothrow_move_constructible<T>::value) {
+        if (this != &x) {
+            destroy_all_();
+            for (; size_ < x.size_; ++size_) {
+                construct_(size_, std::move(*x.ptr_(size_)));
+            }
+        }
+        return *this;
+    }
+
+    ~static_vector_storage() { destroy_all_(); }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type data_[N];
+    std::size_t size_ = 0;
+
+    T* ptr_(std::size_t i) noexcept {
+        return std::launder(reinterpret_cast<T*>(data_ + i));
+    }
+    const T* ptr_(std::size_t i) const noexcept {
+        return std::launder(reinterpret_cast<const T*>(data_ + i));
+    }
+
+    template <class... Args>
+    void construct_(std::size_t i, Args&&... args) {
+        ::new (static_cast<void*>(data_ + i)) T(std::forward<Args>(args)...);
+    }
+
+    void destroy_(std::size_t i) noexcept { ptr_(i)->~T(); }
+
+   private:
+    void destroy_all_() noexcept {
+        while (size_ != 0) {
+            destroy_(--size_);
+        }
+    }
+};
+
+/**
+   A vector with the interface of v1::vector and a fixed capacity of N
+   elements stored inline: no allocation, ever.
+
+   When T is trivially copyable and destructible, so is the vector. When T
+   is trivial it is also constexpr, so lookup tables can be built at
+   compile time:
+
+       constexpr auto squares = [] {
+           static_vector<int, 16> v;
+           for (int i = 0; i < 16; ++i) v.push_back(i * i);
+           return v;
+       }();
+
+   Overflow is the policy's call (overflow_assert, overflow_throw or
+   overflow_report); reserve() and shrink_to_fit() have nothing to do.
+ */
+template <class T, std::size_t N, class Overflow = overflow_assert>
+class static_vector : private static_vector_storage<T, N> {
+    static_assert(N > 0, "static_vector needs a capacity");
+
+    using base = static_vector_storage<T, N>;
+    using base::construct_;
+    using base::data_;
+    using base::destroy_;
+    using base::ptr_;
+    using base::size_;
+
+   public:
+    // types
+    // clang-format off
+    using value_type             = T;
+    using pointer                = T*;
+    using const_pointer          = const T*;
+    using reference              = value_type&;
+    using const_reference        = const value_type&;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using iterator               = T*;
+    using const_iterator         = const T*;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using overflow_policy        = Overflow;
+    // clang-format on
+
+    // construct/copy/destroy:
+    constexpr static_vector() noexcept {}
+
+    /** n > N throws or asserts depending on the policy; overflow_report
+        constructs N elements.
+     */
+    constexpr explicit static_vector(size_type n) {
+        if (!resize(n)) {
+            resize(N);
+        }
+    }
+
+    constexpr static_vector(size_type n, const T& value) {
+        if (!resize(n, value)) {
+            resize(N, value);
+        }
+    }
+
+    template <class InputIterator,
+              class = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    constexpr static_vector(InputIterator first, InputIterator last) {
+        assign(first, last);
+    }
+
+    constexpr static_vector(std::initializer_list<T> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    template <class InputIterator,
+              class = typename std::enable_if<
+                  !std::is_integral<InputIterator>::value>::type>
+    constexpr bool assign(InputIterator first, InputIterator last) {
+        clear();
+        for (; first != last; ++first) {
+            if (!push_back(*first)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool assign(size_type n, const T& value) {
+        clear();
+        return resize(n, value);
+    }
+
+    // iterators:
+    constexpr iterator begin() noexcept { return ptr_(0); }
+    constexpr const_iterator begin() const noexcept { return ptr_(0); }
+    constexpr iterator end() noexcept { return ptr_(size_); }
+    constexpr const_iterator end() const noexcept { return ptr_(size_); }
+
+    constexpr reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    constexpr reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+    constexpr const_reverse_iterator crbegin() const noexcept {
+        return rbegin();
+    }
+    constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // capacity:
+    constexpr size_type size() const noexcept { return size_; }
+    static constexpr size_type max_size() noexcept { return N; }
+    static constexpr size_type capacity() noexcept { return N; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr bool full() const noexcept { return size_ == N; }
+
+    constexpr bool resize(size_type sz) {
+        if (sz > N && !Overflow::overflow("static_vector::resize")) {
+            return false;
+        }
+        while (size_ > sz) {
+            destroy_(--size_);
+        }
+        while (size_ < sz) {
+            construct_(size_++);
+        }
+        return true;
+    }
+
+    constexpr bool resize(size_type sz, const T& c) {
+        if (sz > N && !Overflow::overflow("static_vector::resize")) {
+            return false;
+        }
+        while (size_ > sz) {
+            destroy_(--size_);
+        }
+        while (size_ < sz) {
+            construct_(size_++, c);
+        }
+        return true;
+    }
+
+    /** Nothing to reserve: checks that n fits.
+     */
+    constexpr bool reserve(size_type n) {
+        return n <= N || Overflow::overflow("static_vector::reserve");
+    }
+
+    constexpr void shrink_to_fit() noexcept {}
+
+    // element access:
+    constexpr reference operator[](size_type n) {
+        ASSERT(n < size_, "out of range access");
+        return *ptr_(n);
+    }
+
+    constexpr const_reference operator[](size_type n) const {
+        ASSERT(n < size_, "out of range access");
+        return *ptr_(n);
+    }
+
+    constexpr reference at(size_type n) {
+        if (n >= size_) {
+            throw std::out_of_range("static_vector::at");
+        }
+        return *ptr_(n);
+    }
+
+    constexpr const_reference at(size_type n) const {
+        if (n >= size_) {
+            throw std::out_of_range("static_vector::at");
+        }
+        return *ptr_(n);
+    }
+
+    constexpr reference front() { return (*this)[0]; }
+    constexpr const_reference front() const { return (*this)[0]; }
+    constexpr reference back() { return (*this)[size_ - 1]; }
+    constexpr const_reference back() const { return (*this)[size_ - 1]; }
+
+    constexpr T* data() noexcept { return ptr_(0); }
+    constexpr const T* data() const noexcept { return ptr_(0); }
+
+    // modifiers:
+    /** The new element, or nullptr if full and the policy reports it.
+     */
+    template <class... Args>
+    constexpr T* emplace_back(Args&&... args) {
+        if (full() && !Overflow::overflow("static_vector::emplace_back")) {
+            return nullptr;
+        }
+        construct_(size_, std::forward<Args>(args)...);
+        return ptr_(size_++);
+    }
+
+    constexpr bool push_back(const T& x) { return emplace_back(x) != nullptr; }
+
+    constexpr bool push_back(T&& x) {
+        return emplace_back(std::move(x)) != nullptr;
+    }
+
+    constexpr void pop_back() {
+        ASSERT(!empty(), "pop_back on empty static_vector");
+        destroy_(--size_);
+    }
+
+    /** The new element, or end() if full and the policy reports it.
+     */
+    template <class... Args>
+    constexpr iterator emplace(const_iterator position, Args&&... args) {
+        size_type i = static_cast<size_type>(position - begin());
+        ASSERT(i <= size_, "emplace out of range");
+        if (full() && !Overflow::overflow("static_vector::emplace")) {
+            return end();
+        }
+        if (i == size_) {
+            construct_(size_++, std::forward<Args>(args)...);
+            return ptr_(i);
+        }
+        // args may refer to an element that is about to move.
+        T tmp(std::forward<Args>(args)...);
+        construct_(size_, std::move(*ptr_(size_ - 1)));
+        for (size_type j = size_ - 1; j > i; --j) {
+            *ptr_(j) = std::move(*ptr_(j - 1));
+        }
+        *ptr_(i) = std::move(tmp);
+        ++size_;
+        return ptr_(i);
+    }
+
+    constexpr iterator insert(const_iterator position, const T& x) {
+        return emplace(position, x);
+    }
+
+    constexpr iterator insert(const_iterator position, T&& x) {
+        return emplace(position, std::move(x));
+    }
+
+    constexpr iterator erase(const_iterator position) {
+        return erase(position, position + 1);
+    }
+
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        size_type i = static_cast<size_type>(first - begin());
+        size_type n = static_cast<size_type>(last - first);
+        ASSERT(i + n <= size_, "erase out of range");
+        for (size_type j = i; j + n < size_; ++j) {
+            *ptr_(j) = std::move(*ptr_(j + n));
+        }
+        for (size_type j = 0; j < n; ++j) {
+            destroy_(--size_);
+        }
+        return ptr_(i);
+    }
+
+    constexpr void swap(static_vector& x) {
+        static_vector tmp(std::move(x));
+        x = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    constexpr void clear() noexcept {
+        while (size_ != 0) {
+            destroy_(--size_);
+        }
+    }
+};
+
+template <class T, std::size_t N, class Overflow>
+constexpr bool operator==(const static_vector<T, N, Overflow>& x,
+                          const static_vector<T, N, Overflow>& y) {
+    if (x.size() != y.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        if (!(x[i] == y[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T, std::size_t N, class Overflow>
+constexpr bool operator!=(const static_vector<T, N, Overflow>& x,
+                          const static_vector<T, N, Overflow>& y) {
+    return !(x == y);
+}
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
@@ -0,0 +1,152 @@
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "bit_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+using learn_cpp::detail::bit_vector;
+using learn_cpp::detail::rank_select_index;
+
+void test_bit_vector_1();
+void test_bit_vector_2();
+void test_bit_vector_3();
+
+int main() {
+    test_bit_vector_1();
+    test_bit_vector_2();
+    test_bit_vector_3();
+}
+
+// element access, push_back, resize, the bits past size() stay zero
+void test_bit_vector_1() {
+    std::mt19937_64 rng(42);
+    bit_vector bits;
+    std::vector<bool> expected;
+    for (int i = 0; i < 1000; ++i) {
+        bool b = rng() % 3 == 0;
+        bits.push_back(b);
+        expected.push_back(b);
+    }
+    assert(bits.size() == 1000 && bits.word_count() == 16);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        assert(bits[i] == expected[i]);
+    }
+
+    bits.set(5);
+    bits.reset(6);
+    bits.flip(7);
+    expected[5] = true;
+    expected[6] = false;
+    expected[7] = !expected[7];
+    assert(bits[5] && !bits[6] && bits[7] == expected[7]);
+    assert(bits[4] == expected[4] && bits[8] == expected[8]);
+
+    bool thrown = false;
+    try {
+        bits.test(1000);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // the new bits of a resize(n, true) start in the partial last word
+    bits.resize(1100, true);
+    for (std::size_t i = 1000; i < 1100; ++i) {
+        assert(bits[i]);
+    }
+    bits.resize(1050);
+    assert(bits.words()[1050 / 64] >> (1050 % 64) == 0);
+    bits.resize(1100);
+    assert(!bits[1060] && bits[1049]);
+
+    bit_vector ones(130, true);
+    assert(ones.count() == 130);
+    ones.flip();
+    assert(ones.none() && ones.count() == 0);
+    SHOW(bit_vector(1 << 20).memory_bytes());
+    assert(bit_vector(1 << 20).memory_bytes() == (1 << 20) / 8);
+}
+
+// word-parallel &, |, ^, count, set-bit iteration
+void test_bit_vector_2() {
+    std::mt19937_64 rng(7);
+    std::size_t n = 777;
+    bit_vector a(n), b(n);
+    std::vector<bool> ea(n), eb(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ea[i] = rng() % 2 == 0;
+        eb[i] = rng() % 5 == 0;
+        a.set(i, ea[i]);
+        b.set(i, eb[i]);
+    }
+
+    bit_vector x = a & b, y = a | b, z = a ^ b;
+    std::size_t and_count = 0, or_count = 0, xor_count = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(x[i] == (ea[i] && eb[i]));
+        assert(y[i] == (ea[i] || eb[i]));
+        assert(z[i] == (ea[i] != eb[i]));
+        and_count += ea[i] && eb[i];
+        or_count += ea[i] || eb[i];
+        xor_count += ea[i] != eb[i];
+    }
+    assert(x.count() == and_count && y.count() == or_count &&
+           z.count() == xor_count);
+
+    bool thrown = false;
+    try {
+        x &= bit_vector(n - 1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && x.count() == and_count);
+    assert((z ^ b) == a && (a ^ a).none());
+
+    std::vector<std::size_t> set;
+    y.for_each_set([&set](std::size_t i) { set.push_back(i); });
+    assert(set.size() == or_count);
+    std::size_t k = 0;
+    for (std::size_t i = y.find_first(); i != bit_vector::npos;
+         i = y.find_next(i + 1)) {
+        assert(set[k++] == i && y[i]);
+    }
+    assert(k == set.size());
+    assert(bit_vector(100).find_first() == bit_vector::npos);
+}
+
+// rank and select against a scan, on dense, sparse and empty vectors
+void test_bit_vector_3() {
+    std::mt19937_64 rng(3);
+    for (unsigned one_in : {1u, 2u, 50u, 3000u}) {
+        std::size_t n = 200000 + rng() % 64;
+        bit_vector bits(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            bits.set(i, rng() % one_in == 0);
+        }
+        rank_select_index index(bits);
+        assert(index.ones() == bits.count());
+
+        std::size_t rank = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(index.rank(i) == rank);
+            if (bits[i]) {
+                assert(index.select(rank) == i);
+                ++rank;
+            }
+        }
+        assert(index.rank(n) == rank);
+        SHOW(index.memory_bytes());
+        // 1/8 of the bits for rank, less for select
+        assert(index.memory_bytes() <= bits.memory_bytes() / 4);
+    }
+
+    bit_vector empty;
+    rank_select_index index(empty);
+    assert(index.ones() == 0 && index.rank(0) == 0);
+}
@@ -0,0 +1,118 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cow_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_cow_vector_1();
+void test_cow_vector_2();
+void test_cow_vector_3();
+
+int main() {
+    test_cow_vector_1();
+    test_cow_vector_2();
+    test_cow_vector_3();
+}
+
+// copies share, writes detach
+void test_cow_vector_1() {
+    using learn_cpp::detail::cow_vector;
+
+    cow_vector<int> vec1 = {1, 2, 3};
+    assert(vec1.use_count() == 1 && vec1.unique());
+    cow_vector<int> vec2 = vec1;
+    assert(vec1.use_count() == 2 && vec2.data() == vec1.data());
+
+    const cow_vector<int>& cref = vec2;
+    assert(cref[1] == 2 && cref.use_count() == 2);
+
+    vec2[1] = 20;
+    assert(vec1.use_count() == 1 && vec2.use_count() == 1);
+    assert(vec2.data() != vec1.data());
+    assert(vec1[1] == 2 && vec2[1] == 20);
+
+    // unique: no copy
+    const int* before = vec2.data();
+    vec2[0] = 10;
+    assert(vec2.data() == before);
+
+    cow_vector<int> vec3 = vec1;
+    vec3.push_back(4);
+    assert(vec1.size() == 3 && vec3.size() == 4 && vec3.back() == 4);
+    vec3.push_back(vec3[0]);
+    assert(vec3.size() == 5 && vec3[4] == 1);
+
+    cow_vector<int> vec4 = vec3;
+    vec4.erase(vec4.begin() + 1, vec4.begin() + 3);
+    vec4.insert(vec4.cbegin(), 0);
+    assert(vec4.size() == 4 && vec4[0] == 0 && vec4[1] == 1 && vec4[2] == 4);
+    assert(vec3.size() == 5 && vec3[1] == 2);
+
+    // clear on a shared buffer leaves the other handles alone
+    cow_vector<int> vec5 = vec3;
+    vec5.clear();
+    assert(vec5.empty() && vec5.use_count() == 0 && vec3.size() == 5);
+    vec5.push_back(7);
+    assert(vec5.size() == 1 && vec5[0] == 7);
+
+    cow_vector<int> vec6 = std::move(vec5);
+    assert(vec5.empty() && vec5.data() == nullptr && vec6[0] == 7);
+}
+
+// construction, resize, non-trivial elements
+void test_cow_vector_2() {
+    using learn_cpp::detail::cow_vector;
+    namespace v1 = learn_cpp::detail::v1;
+
+    cow_vector<std::string> vec1(3, "x");
+    assert(vec1.size() == 3 && vec1.at(2) == "x");
+    auto vec2 = vec1;
+    vec2.resize(5, "y");
+    assert(vec1.size() == 3 && vec2.size() == 5 && vec2[4] == "y");
+    vec2.pop_back();
+    assert(vec2.size() == 4);
+
+    v1::vector<std::string> plain(2, "z");
+    cow_vector<std::string> vec3(std::move(plain));
+    assert(vec3.size() == 2 && vec3.vector().size() == 2);
+
+    cow_vector<std::string> vec4;
+    assert(vec4.empty() && vec4.begin() == vec4.end() && vec4.unique());
+    vec4 = vec3;
+    assert(vec4.use_count() == 2);
+    vec4 = cow_vector<std::string>();
+    assert(vec3.use_count() == 1);
+}
+
+// snapshots handed to readers while the owner keeps writing
+void test_cow_vector_3() {
+    using learn_cpp::detail::cow_vector;
+
+    cow_vector<long> master(1000, 0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        cow_vector<long> snapshot = master;
+        readers.emplace_back([snapshot, t]() {
+            long sum = 0;
+            for (int round = 0; round < 100; ++round) {
+                for (long x : snapshot) {
+                    sum += x;
+                }
+            }
+            // each snapshot saw only the writes made before it
+            assert(sum == 100 * 1000L * t);
+        });
+        for (auto& x : master) {
+            ++x;
+        }
+    }
+    for (auto& r : readers) {
+        r.join();
+    }
+    assert(master[999] == 4 && master.unique());
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "flat_hash_map.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_flat_hash_map_1();
+void test_flat_hash_map_2();
+void test_flat_hash_map_3();
+
+int main() {
+    test_flat_hash_map_1();
+    test_flat_hash_map_2();
+    test_flat_hash_map_3();
+}
+
+void test_flat_hash_map_1() {
+    using learn_cpp::detail::flat_hash_map;
+
+    flat_hash_map<std::string, int> map1;
+    assert(map1.empty() && map1.capacity() == 0);
+    assert(map1.find("a") == map1.end() && !map1.contains("a"));
+    assert(map1.erase("a") == 0);
+    assert(map1.insert({"a", 1}).second);
+    assert(!map1.insert({"a", 2}).second);
+    assert(map1.at("a") == 1);
+    map1["b"] = 2;
+    map1["b"] += 1;
+    assert(!map1.insert_or_assign("a", 10).second);
+    assert(map1.size() == 2 && map1.capacity() == 16);
+    assert(map1.find("a")->second == 10 && map1.at("b") == 3);
+    assert(map1.count("b") == 1 && map1.count("c") == 0);
+    try {
+        map1.at("c");
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    int sum = 0;
+    for (const auto& item : map1) {
+        sum += item.second;
+    }
+    assert(sum == 13);
+
+    auto map2 = map1;
+    assert(map1.erase("a") == 1 && map1.size() == 1);
+    assert(map2.size() == 2 && map2.at("a") == 10);
+    map1 = std::move(map2);
+    assert(map1.size() == 2 && map1.contains("a"));
+
+    map1.clear();
+    assert(map1.empty() && map1.capacity() == 16 && !map1.contains("b"));
+
+    // an inserted rvalue moves its key, a rejected one keeps it
+    std::string key(32, 'k');
+    assert(map1.insert({std::move(key), 1}).second && key.empty());
+    std::string again(32, 'k');
+    assert(!map1.try_emplace(std::move(again), 2).second);
+    assert(again.size() == 32 && map1.at(std::string(32, 'k')) == 1);
+}
+
+// growth and reserve
+void test_flat_hash_map_2() {
+    using learn_cpp::detail::flat_hash_map;
+
+    flat_hash_map<int, int> map1;
+    for (int i = 0; i < 10000; ++i) {
+        map1[i] = i * 2;
+        assert(map1.load_factor() <= 0.875f);
+    }
+    assert(map1.size() == 10000);
+    for (int i = 0; i < 10000; ++i) {
+        assert(map1.at(i) == i * 2);
+    }
+    assert(!map1.contains(-1) && !map1.contains(10000));
+
+    // sequential integers probe no further than a group or two
+    std::size_t longest = 0;
+    for (int i = 0; i < 10000; ++i) {
+        longest = std::max(longest, map1.probe_length(i));
+    }
+    SHOW(longest);
+    assert(longest < 64);
+
+    flat_hash_map<int, int> map2(1000);
+    std::size_t cap = map2.capacity();
+    assert(cap == 2048);
+    for (int i = 0; i < 1000; ++i) {
+        map2[i] = i;
+    }
+    assert(map2.capacity() == cap);
+    // steady size churn: no tombstones, no rehash
+    for (int i = 1000; i < 100000; ++i) {
+        map2.erase(i - 1000);
+        map2[i] = i;
+    }
+    assert(map2.capacity() == cap && map2.size() == 1000);
+}
+
+// erase with backward shift, against std::unordered_map
+void test_flat_hash_map_3() {
+    using learn_cpp::detail::flat_hash_map;
+
+    // a bad hash: every key collides, runs wrap around the end
+    struct Clustered {
+        std::size_t operator()(int x) const { return std::size_t(x) % 4; }
+    };
+    flat_hash_map<int, std::string, Clustered> map1;
+    std::unordered_map<int, std::string> ref;
+    unsigned rng = 1;
+    for (int step = 0; step < 20000; ++step) {
+        rng = rng * 1103515245 + 12345;
+        int key = int((rng >> 16) % 200);
+        if ((rng >> 8) % 3 == 0) {
+            assert(map1.erase(key) == ref.erase(key));
+        } else {
+            std::string value = std::to_string(step);
+            map1.insert_or_assign(key, value);
+            ref[key] = value;
+        }
+        assert(map1.size() == ref.size());
+    }
+    for (const auto& item : ref) {
+        assert(map1.at(item.first) == item.second);
+    }
+    std::size_t n = 0;
+    for (const auto& item : map1) {
+        assert(ref.at(item.first) == item.second);
+        ++n;
+    }
+    assert(n == ref.size());
+}
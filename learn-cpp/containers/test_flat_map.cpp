@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flat_map.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_flat_map_1();
+void test_flat_map_2();
+void test_flat_map_3();
+void test_flat_map_4();
+
+int main() {
+    test_flat_map_1();
+    test_flat_map_2();
+    test_flat_map_3();
+    test_flat_map_4();
+}
+
+// flat_set: bulk build, merge, both layouts agree with std::lower_bound
+template <class Layout>
+void check_set() {
+    using learn_cpp::detail::flat_set;
+
+    flat_set<int, std::less<int>, Layout> set0;
+    assert(set0.empty() && set0.lower_bound_index(1) == 0 && !set0.contains(1));
+
+    flat_set<int, std::less<int>, Layout> set1 = {5, 1, 3, 5, 1, 9};
+    assert(set1.size() == 4);
+    assert(std::is_sorted(set1.begin(), set1.end()));
+    assert(set1.contains(3) && !set1.contains(4));
+
+    std::vector<int> more = {4, 3, 10, 4, 0};
+    assert(set1.insert_many(more.begin(), more.end()) == 3);
+    std::vector<int> expect = {0, 1, 3, 4, 5, 9, 10};
+    assert(std::equal(set1.begin(), set1.end(), expect.begin(),
+                      expect.end()));
+    assert(set1.insert(7) && !set1.insert(7));
+    assert(set1.erase(1) == 1 && set1.erase(1) == 0);
+    assert(set1.size() == 7 && *set1.find(7) == 7);
+
+    // every size up to 100, every key in between
+    for (int n = 0; n < 100; ++n) {
+        std::vector<int> keys;
+        for (int i = 0; i < n; ++i) {
+            keys.push_back(i * 2);
+        }
+        flat_set<int, std::less<int>, Layout> set2(keys.begin(), keys.end());
+        for (int key = -1; key <= 2 * n; ++key) {
+            auto expected = std::lower_bound(keys.begin(), keys.end(), key) -
+                            keys.begin();
+            assert(set2.lower_bound_index(key) == std::size_t(expected));
+        }
+    }
+}
+
+void test_flat_map_1() {
+    using learn_cpp::detail::eytzinger_layout;
+    using learn_cpp::detail::flat_set;
+    using learn_cpp::detail::sorted_layout;
+
+    check_set<sorted_layout>();
+    check_set<eytzinger_layout>();
+
+    flat_set<int> set1 = {1, 2, 3};
+    flat_set<int, std::less<int>, eytzinger_layout> set2 = {1, 2, 3};
+    assert(set1.index_bytes() == 0 && set2.index_bytes() > 0);
+
+    // another order
+    flat_set<std::string, std::greater<std::string>> set3 = {"a", "c", "b"};
+    assert(*set3.begin() == "c" && set3.contains("b"));
+}
+
+// flat_map
+template <class Layout>
+void check_map() {
+    using learn_cpp::detail::flat_map;
+
+    std::vector<std::pair<std::string, int>> items = {
+        {"b", 2}, {"a", 1}, {"b", 20}, {"c", 3}};
+    flat_map<std::string, int, std::less<std::string>, Layout> map1(
+        items.begin(), items.end());
+    assert(map1.size() == 3);
+    // the first of equal keys wins
+    assert(map1.at("b") == 2);
+    assert(map1.keys()[0] == "a" && map1.values()[2] == 3);
+    assert(map1.find("d") == nullptr);
+    try {
+        map1.at("d");
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+
+    assert(map1.insert("d", 4) && !map1.insert("d", 40));
+    assert(!map1.insert_or_assign("d", 44) && map1.at("d") == 44);
+    *map1.find("a") += 10;
+    assert(map1.at("a") == 11);
+
+    std::vector<std::pair<std::string, int>> batch = {
+        {"e", 5}, {"a", 0}, {"0", -1}, {"e", 50}};
+    assert(map1.insert_many(batch.begin(), batch.end()) == 2);
+    assert(map1.size() == 6);
+    assert(map1.at("a") == 11 && map1.at("e") == 5 && map1.at("0") == -1);
+    assert(std::is_sorted(map1.keys().begin(), map1.keys().end()));
+    for (std::size_t i = 0; i < map1.size(); ++i) {
+        assert(*map1.find(map1.keys()[i]) == map1.values()[i]);
+    }
+
+    assert(map1.erase("c") == 1 && map1.erase("c") == 0);
+    assert(!map1.contains("c") && map1.size() == 5);
+    map1.clear();
+    assert(map1.empty() && !map1.contains("a"));
+}
+
+void test_flat_map_2() {
+    using learn_cpp::detail::eytzinger_layout;
+    using learn_cpp::detail::sorted_layout;
+
+    check_map<sorted_layout>();
+    check_map<eytzinger_layout>();
+}
+
+// random batches against std::map
+void test_flat_map_3() {
+    using learn_cpp::detail::eytzinger_layout;
+    using learn_cpp::detail::flat_map;
+
+    flat_map<unsigned, unsigned, std::less<unsigned>, eytzinger_layout> map1;
+    std::map<unsigned, unsigned> ref;
+    unsigned rng = 7;
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::pair<unsigned, unsigned>> batch;
+        for (int i = 0; i < 100; ++i) {
+            rng = rng * 1103515245 + 12345;
+            batch.emplace_back((rng >> 8) % 5000, rng);
+        }
+        std::size_t before = ref.size();
+        for (const auto& item : batch) {
+            ref.insert(item);
+        }
+        assert(map1.insert_many(batch.begin(), batch.end()) ==
+               ref.size() - before);
+    }
+    assert(map1.size() == ref.size());
+    for (unsigned key = 0; key < 5000; ++key) {
+        auto it = ref.find(key);
+        const unsigned* value = map1.find(key);
+        assert((it == ref.end()) == (value == nullptr));
+        assert(value == nullptr || *value == it->second);
+    }
+}
+
+// a throwing copy leaves the keys, the values and the index in step
+struct Fragile {
+    static bool fail_copy;
+    static bool fail_assign;
+
+    int x = 0;
+
+    Fragile() = default;
+    Fragile(int x) : x(x) {}
+    Fragile(const Fragile& other) : x(other.x) {
+        if (fail_copy) {
+            throw std::runtime_error("Fragile copy");
+        }
+    }
+    Fragile(Fragile&&) = default;
+    Fragile& operator=(const Fragile& other) {
+        if (fail_assign) {
+            throw std::runtime_error("Fragile copy");
+        }
+        x = other.x;
+        return *this;
+    }
+    Fragile& operator=(Fragile&&) = default;
+
+    friend bool operator<(const Fragile& a, const Fragile& b) {
+        return a.x < b.x;
+    }
+};
+
+bool Fragile::fail_copy = false;
+bool Fragile::fail_assign = false;
+
+void test_flat_map_4() {
+    using learn_cpp::detail::eytzinger_layout;
+    using learn_cpp::detail::flat_map;
+    using learn_cpp::detail::flat_set;
+
+    flat_map<int, Fragile, std::less<int>, eytzinger_layout> map1;
+    for (int i = 0; i < 20; ++i) {
+        map1.insert(i * 2, Fragile(i));
+    }
+    Fragile::fail_copy = true;
+    bool thrown = false;
+    try {
+        map1.insert(7, Fragile(100));
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    Fragile::fail_copy = false;
+    assert(thrown && map1.size() == 20 && map1.values().size() == 20);
+    assert(!map1.contains(7) && map1.at(38).x == 19);
+
+    // the eytzinger index assigns the keys when it is rebuilt
+    flat_set<Fragile, std::less<Fragile>, eytzinger_layout> set1;
+    for (int i = 0; i < 20; ++i) {
+        set1.insert(Fragile(i * 2));
+    }
+    Fragile::fail_assign = true;
+    thrown = false;
+    try {
+        set1.insert(Fragile(7));
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && set1.size() == 20 && !set1.contains(Fragile(7)));
+    thrown = false;
+    try {
+        set1.erase(Fragile(10));
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    Fragile::fail_assign = false;
+    assert(thrown && set1.size() == 20 && set1.contains(Fragile(10)));
+    for (int i = 0; i < 40; ++i) {
+        assert(set1.contains(Fragile(i)) == (i % 2 == 0));
+    }
+}
@@ -0,0 +1,128 @@
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include "mapped_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+struct Record {
+    std::int64_t id;
+    double value;
+};
+
+void test_mapped_vector_1(const std::string& path);
+void test_mapped_vector_2(const std::string& path);
+void test_mapped_vector_3(const std::string& path);
+
+int main() {
+    std::string path =
+        "/tmp/test_mapped_vector." + std::to_string(::getpid()) + ".bin";
+    test_mapped_vector_1(path);
+    test_mapped_vector_2(path);
+    test_mapped_vector_3(path);
+    std::remove(path.c_str());
+}
+
+// write, close, reopen read-only
+void test_mapped_vector_1(const std::string& path) {
+    using learn_cpp::detail::map_mode;
+    using learn_cpp::detail::mapped_vector;
+
+    {
+        mapped_vector<int> vec1(path.c_str(), map_mode::truncate);
+        assert(vec1.is_open());
+        assert(vec1.empty());
+        for (int i = 0; i < 10000; ++i) {
+            vec1.push_back(i);
+        }
+        assert(vec1.size() == 10000);
+        assert(vec1.capacity() >= vec1.size());
+        SHOW(vec1.capacity());
+    }
+
+    // close() truncates the file to the exact size.
+    struct stat st;
+    assert(::stat(path.c_str(), &st) == 0);
+    assert(st.st_size == 10000 * sizeof(int));
+
+    const mapped_vector<int> vec2(path.c_str(), map_mode::read_only);
+    assert(vec2.read_only());
+    assert(vec2.size() == 10000);
+    int expected = 0;
+    for (auto item : vec2) {
+        assert(item == expected);
+        ++expected;
+    }
+}
+
+// append to an existing file, resize and shrink
+void test_mapped_vector_2(const std::string& path) {
+    using learn_cpp::detail::access_hint;
+    using learn_cpp::detail::map_mode;
+    using learn_cpp::detail::mapped_vector;
+
+    mapped_vector<int> vec1(path.c_str(), map_mode::read_write);
+    assert(vec1.size() == 10000);
+    vec1.advise(access_hint::sequential);
+    vec1.resize(20000, 7);
+    assert(vec1.size() == 20000);
+    assert(vec1[9999] == 9999);
+    assert(vec1[10000] == 7);
+    assert(vec1.back() == 7);
+    vec1.pop_back();
+    assert(vec1.size() == 19999);
+    vec1.shrink_to_fit();
+    assert(vec1.capacity() == vec1.size());
+    vec1.flush();
+
+    // move ctor
+    auto vec2 = std::move(vec1);
+    assert(!vec1.is_open());
+    assert(vec2.size() == 19999);
+    vec2.close();
+
+    mapped_vector<int> vec3(path.c_str(), map_mode::read_only);
+    const auto& cvec3 = vec3;
+    assert(vec3.size() == 19999);
+    assert(cvec3[19998] == 7);
+    vec3.advise(access_hint::random);
+
+    // a read-only mapping can not grow.
+    bool thrown = false;
+    try {
+        vec3.push_back(1);
+    } catch (const std::system_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// a raw snapshot written with fwrite can be mapped directly
+void test_mapped_vector_3(const std::string& path) {
+    using learn_cpp::detail::map_mode;
+    using learn_cpp::detail::mapped_vector;
+
+    Record records[3] = {{1, 0.5}, {2, 1.5}, {3, 2.5}};
+    std::FILE* fp = std::fopen(path.c_str(), "wb");
+    assert(fp != nullptr);
+    std::fwrite(records, sizeof(Record), 3, fp);
+    std::fclose(fp);
+
+    const mapped_vector<Record> vec1(path.c_str(), map_mode::read_only);
+    assert(vec1.size() == 3);
+    assert(vec1[2].id == 3);
+    assert(vec1[2].value == 2.5);
+
+    mapped_vector<Record> vec2(path.c_str(), map_mode::truncate);
+    assert(vec2.empty());
+    vec2.emplace_back(Record{4, 3.5});
+    assert(vec2.size() == 1);
+}
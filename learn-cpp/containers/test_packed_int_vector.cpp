@@ -0,0 +1,176 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "packed_int_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+namespace bit_packing = learn_cpp::detail::bit_packing;
+using learn_cpp::detail::delta_packed_int_vector;
+using learn_cpp::detail::packed_int_vector;
+using learn_cpp::detail::v1::vector;
+
+void test_packed_int_vector_1();
+void test_packed_int_vector_2();
+void test_packed_int_vector_3();
+
+int main() {
+    test_packed_int_vector_1();
+    test_packed_int_vector_2();
+    test_packed_int_vector_3();
+}
+
+// every width: push_back, operator[], set, decode
+void test_packed_int_vector_1() {
+    std::mt19937_64 rng(42);
+    for (unsigned bits = 1; bits <= 64; ++bits) {
+        packed_int_vector vec(bits);
+        std::vector<std::uint64_t> expected;
+        for (int i = 0; i < 300; ++i) {
+            std::uint64_t v = rng() & bit_packing::mask(bits);
+            vec.push_back(v);
+            expected.push_back(v);
+        }
+        assert(vec.size() == 300 && vec.bits() == bits);
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            assert(vec[i] == expected[i]);
+        }
+
+        // neighbours are left alone
+        vec.set(100, vec.max_value());
+        expected[100] = vec.max_value();
+        vec.set(101, 0);
+        expected[101] = 0;
+        assert(vec[99] == expected[99] && vec[102] == expected[102]);
+
+        // unaligned head, whole groups, tail
+        std::vector<std::uint64_t> out(300, 7);
+        vec.decode(3, 290, out.data());
+        for (std::size_t i = 0; i < 290; ++i) {
+            assert(out[i] == expected[i + 3]);
+        }
+        vector<std::uint64_t> all;
+        vec.decode(all);
+        assert(all.size() == 300);
+        for (std::size_t i = 0; i < 300; ++i) {
+            assert(all[i] == expected[i]);
+        }
+    }
+
+    // 20 bit IDs take 20 bits
+    packed_int_vector ids(20);
+    ids.reserve(64000);
+    for (int i = 0; i < 64000; ++i) {
+        ids.push_back(std::uint64_t(i) * 16 % (1 << 20));
+    }
+    SHOW(ids.memory_bytes());
+    assert(ids.memory_bytes() <= 64000 * 20 / 8 + 8);
+}
+
+// sorted values: equal runs, small and huge gaps, the partial last block
+void test_packed_int_vector_2() {
+    std::mt19937_64 rng(7);
+    delta_packed_int_vector vec;
+    std::vector<std::uint64_t> expected;
+    std::uint64_t v = 1000;
+    for (int i = 0; i < 1000; ++i) {
+        if (i < 128) {
+            // one block of 0 bit deltas
+        } else if (i < 600) {
+            v += rng() % 50;
+        } else if (i == 700) {
+            v = ~std::uint64_t(0) - 1000;
+        } else if (i > 700) {
+            v += rng() % 2;
+        }
+        vec.push_back(v);
+        expected.push_back(v);
+    }
+    assert(vec.size() == 1000 && vec.back() == expected.back());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        assert(vec[i] == expected[i]);
+    }
+    for (std::size_t first : {0, 5, 128, 200}) {
+        std::vector<std::uint64_t> out(1000);
+        std::size_t n = 1000 - first - 3;
+        vec.decode(first, n, out.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(out[i] == expected[first + i]);
+        }
+    }
+    vector<std::uint64_t> all;
+    vec.decode(all);
+    assert(all.size() == 1000 && all[999] == expected[999]);
+
+    // timestamps 10 us apart, in ns, are on the line of every block
+    delta_packed_int_vector ts;
+    delta_packed_int_vector jittered;
+    for (std::uint64_t i = 0; i < 128000; ++i) {
+        ts.push_back(1700000000000000000u + i * 10000);
+        jittered.push_back(1700000000000000000u + i * 10000 + rng() % 2000);
+    }
+    SHOW(ts.memory_bytes());
+    SHOW(jittered.memory_bytes());
+    assert(ts.memory_bytes() < 128000 * 2 / 8 + 4096);
+    // 11 bits, 1.5 of header and the spare capacity of the vectors
+    assert(jittered.memory_bytes() < 128000 * 16 / 8);
+    assert(ts[127999] == 1700000000000000000u + 127999u * 10000);
+    std::vector<std::uint64_t> out(128000);
+    jittered.decode(0, 128000, out.data());
+    for (std::size_t i = 1; i < out.size(); ++i) {
+        assert(out[i] == jittered[i] && out[i] > out[i - 1]);
+    }
+
+    // a block spanning more than 2^63
+    delta_packed_int_vector wide;
+    for (int i = 0; i < 126; ++i) {
+        wide.push_back(0);
+    }
+    wide.push_back(std::uint64_t(1) << 62);
+    wide.push_back((std::uint64_t(1) << 63) + 1);
+    assert(wide[125] == 0 && wide[126] == std::uint64_t(1) << 62);
+    assert(wide[127] == (std::uint64_t(1) << 63) + 1);
+}
+
+// errors, clear
+void test_packed_int_vector_3() {
+    bool thrown = false;
+    try {
+        packed_int_vector vec(65);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    packed_int_vector vec(3);
+    vec.push_back(5);
+    thrown = false;
+    try {
+        vec.at(1);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown && vec.at(0) == 5);
+    vec.clear();
+    assert(vec.empty());
+    vec.push_back(7);
+    assert(vec[0] == 7);
+
+    delta_packed_int_vector sorted;
+    for (std::uint64_t i = 0; i < 300; ++i) {
+        sorted.push_back(i * i);
+    }
+    sorted.clear();
+    assert(sorted.empty());
+    sorted.push_back(3);
+    assert(sorted.size() == 1 && sorted[0] == 3);
+
+    assert(bit_packing::bits_for(0) == 0 && bit_packing::bits_for(1) == 1);
+    assert(bit_packing::bits_for(~std::uint64_t(0)) == 64);
+}
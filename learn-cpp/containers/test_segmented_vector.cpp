@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "segmented_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_segmented_vector_1();
+void test_segmented_vector_2();
+void test_segmented_vector_3();
+
+int main() {
+    test_segmented_vector_1();
+    test_segmented_vector_2();
+    test_segmented_vector_3();
+}
+
+// random access, and references stay where they are while growing
+void test_segmented_vector_1() {
+    using learn_cpp::detail::segmented_vector;
+
+    segmented_vector<int, 8> vec1;
+    assert(vec1.empty() && vec1.capacity() == 0);
+    vec1.push_back(0);
+    int* first = &vec1[0];
+    for (int i = 1; i < 100; ++i) {
+        vec1.push_back(i);
+    }
+    assert(&vec1[0] == first);
+    assert(vec1.size() == 100);
+    assert(vec1.capacity() == 104);
+    for (int i = 0; i < 100; ++i) {
+        assert(vec1[i] == i);
+    }
+    assert(vec1.front() == 0 && vec1.back() == 99);
+
+    bool thrown = false;
+    try {
+        vec1.at(100);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    vec1.pop_back();
+    vec1.pop_back();
+    assert(vec1.size() == 98 && vec1.back() == 97);
+    vec1.shrink_to_fit();
+    assert(vec1.capacity() == 104);
+    vec1.clear();
+    assert(vec1.empty() && vec1.capacity() == 104);
+    vec1.shrink_to_fit();
+    assert(vec1.capacity() == 0);
+
+    // 16KB chunks by default
+    SHOW(segmented_vector<int>::kChunkSize);
+    assert(segmented_vector<int>::kChunkSize == 4096);
+    assert(segmented_vector<char[20000]>::kChunkSize == 1);
+}
+
+// segments and iterators
+void test_segmented_vector_2() {
+    using learn_cpp::detail::segmented_vector;
+
+    segmented_vector<long, 16> vec1;
+    vec1.reserve(40);
+    assert(vec1.capacity() == 48);
+    for (long i = 0; i < 40; ++i) {
+        vec1.emplace_back(i);
+    }
+    assert(vec1.segment_count() == 3);
+    assert(vec1.segment_size(0) == 16 && vec1.segment_size(2) == 8);
+    assert(vec1.segment_data(1)[0] == 16);
+
+    long sum = 0;
+    vec1.for_each_segment([&sum](const long* first, const long* last) {
+        for (; first != last; ++first) {
+            sum += *first;
+        }
+    });
+    assert(sum == 40 * 39 / 2);
+    assert(std::accumulate(vec1.begin(), vec1.end(), 0L) == sum);
+
+    auto it = std::lower_bound(vec1.begin(), vec1.end(), 33L);
+    assert(it - vec1.begin() == 33 && *it == 33);
+    std::reverse(vec1.begin(), vec1.end());
+    assert(vec1[0] == 39 && vec1[39] == 0);
+    std::sort(vec1.begin(), vec1.end());
+    assert(std::is_sorted(vec1.cbegin(), vec1.cend()));
+
+    // an iterator taken before growing still works after
+    segmented_vector<long, 16>::const_iterator cit = vec1.begin() + 10;
+    for (long i = 0; i < 1000; ++i) {
+        vec1.push_back(i);
+    }
+    assert(*cit == 10 && cit[30] == 0);
+}
+
+// non-trivial elements, copy and move; a throwing copy leaks nothing
+struct Counted {
+    static int live;
+    static int copies_left;
+
+    Counted() { ++live; }
+    Counted(const Counted&) {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("Counted");
+        }
+        ++live;
+    }
+    ~Counted() { --live; }
+};
+
+int Counted::live = 0;
+int Counted::copies_left = 0;
+
+void test_segmented_vector_3() {
+    using learn_cpp::detail::segmented_vector;
+    using std::string;
+
+    segmented_vector<string, 4> vec1;
+    for (int i = 0; i < 10; ++i) {
+        vec1.emplace_back(std::to_string(i));
+    }
+    const string* p = &vec1[9];
+
+    auto vec2 = vec1;
+    assert(vec2.size() == 10 && vec2[9] == "9");
+    assert(&vec2[9] != p);
+
+    auto vec3 = std::move(vec1);
+    assert(vec1.empty());
+    assert(&vec3[9] == p);
+
+    vec1 = vec3;
+    vec3.clear();
+    assert(vec1.size() == 10 && vec1[3] == "3");
+
+    segmented_vector<Counted, 4> vec4;
+    for (int i = 0; i < 10; ++i) {
+        vec4.emplace_back();
+    }
+    assert(Counted::live == 10);
+    Counted::copies_left = 6;
+    bool thrown = false;
+    try {
+        auto vec5 = vec4;
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && Counted::live == 10);
+}
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "slot_map.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+using learn_cpp::detail::slot_handle;
+using learn_cpp::detail::slot_map;
+
+void test_slot_map_1();
+void test_slot_map_2();
+void test_slot_map_3();
+
+int main() {
+    test_slot_map_1();
+    test_slot_map_2();
+    test_slot_map_3();
+}
+
+// insert, find, erase, stale handles, slot reuse
+void test_slot_map_1() {
+    slot_map<std::string> names;
+    assert(names.empty() && !names.contains(slot_handle{}));
+
+    auto a = names.insert("a");
+    auto b = names.emplace(3, 'b');
+    auto c = names.insert(std::string("c"));
+    assert(names.size() == 3);
+    assert(names[a] == "a" && names[b] == "bbb" && *names.find(c) == "c");
+
+    assert(names.erase(a));
+    assert(!names.erase(a) && !names.contains(a) && !names.find(a));
+    bool thrown = false;
+    try {
+        names.at(a);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(names.size() == 2 && names[b] == "bbb" && names[c] == "c");
+
+    // the slot of a is reused, with a new generation
+    auto d = names.insert("d");
+    assert(d.index == a.index && d.generation != a.generation);
+    assert(!names.contains(a) && names[d] == "d");
+
+    // handles survive a round trip through 64 bits
+    static_assert(sizeof(slot_handle) == 8, "64 bit handles");
+    assert(slot_handle::from_value(d.value()) == d);
+    assert(names.find(slot_handle::from_value(d.value())) == &names[d]);
+    SHOW(d.value());
+
+    names.clear();
+    assert(names.empty() && !names.contains(b) && !names.contains(d));
+    auto e = names.insert("e");
+    assert(names.size() == 1 && names[e] == "e" && e.index <= 2);
+}
+
+// random inserts and erases against an unordered_map; the dense order
+// holds every element once, and handle_at() agrees with it
+void test_slot_map_2() {
+    std::mt19937_64 rng(42);
+    slot_map<std::uint64_t> pool;
+    std::unordered_map<std::uint64_t, std::uint64_t> expected;
+    std::vector<slot_handle> handles, erased;
+    for (int op = 0; op < 100000; ++op) {
+        if (handles.empty() || rng() % 3 != 0) {
+            std::uint64_t v = rng();
+            auto h = pool.insert(v);
+            handles.push_back(h);
+            expected[h.value()] = v;
+        } else {
+            std::size_t k = rng() % handles.size();
+            assert(pool.erase(handles[k]));
+            expected.erase(handles[k].value());
+            erased.push_back(handles[k]);
+            handles[k] = handles.back();
+            handles.pop_back();
+        }
+    }
+    assert(pool.size() == expected.size());
+    for (auto h : handles) {
+        assert(pool.contains(h) && pool[h] == expected[h.value()]);
+    }
+    for (auto h : erased) {
+        assert(!pool.contains(h) && !pool.erase(h));
+    }
+
+    std::size_t i = 0;
+    for (const std::uint64_t& v : pool) {
+        auto h = pool.handle_at(i++);
+        assert(&pool[h] == &v && expected[h.value()] == v);
+    }
+    assert(i == pool.size());
+    SHOW(pool.size());
+}
+
+// move-only elements, swap-remove moves them, a throwing constructor
+// leaves the pool as it was
+struct Throwing {
+    explicit Throwing(bool fail) {
+        if (fail) {
+            throw std::runtime_error("Throwing");
+        }
+    }
+};
+
+void test_slot_map_3() {
+    slot_map<std::unique_ptr<int>> ptrs;
+    std::vector<slot_handle> handles;
+    for (int i = 0; i < 10; ++i) {
+        handles.push_back(ptrs.insert(std::make_unique<int>(i)));
+    }
+    assert(ptrs.erase(handles[0]) && ptrs.erase(handles[5]));
+    for (int i = 1; i < 10; ++i) {
+        if (i != 5) {
+            assert(*ptrs[handles[i]] == i);
+        }
+    }
+    int sum = 0;
+    for (const auto& p : ptrs) {
+        sum += *p;
+    }
+    assert(sum == 45 - 5);
+
+    slot_map<Throwing> pool;
+    auto h = pool.emplace(false);
+    bool thrown = false;
+    try {
+        pool.emplace(true);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && pool.size() == 1 && pool.contains(h));
+    auto g = pool.emplace(false);
+    assert(pool.size() == 2 && pool.contains(g) && g != h);
+    assert(pool.erase(h) && pool.handle_at(0) == g);
+}
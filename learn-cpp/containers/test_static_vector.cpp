@@ -0,0 +1,141 @@
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "static_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_static_vector_1();
+void test_static_vector_2();
+void test_static_vector_3();
+
+int main() {
+    test_static_vector_1();
+    test_static_vector_2();
+    test_static_vector_3();
+}
+
+// built at compile time
+constexpr learn_cpp::detail::static_vector<int, 16> make_squares() {
+    learn_cpp::detail::static_vector<int, 16> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i * i);
+    }
+    vec.erase(vec.begin());
+    vec.insert(vec.begin(), -1);
+    return vec;
+}
+
+constexpr auto kSquares = make_squares();
+static_assert(kSquares.size() == 10, "");
+static_assert(kSquares[0] == -1 && kSquares[9] == 81, "");
+static_assert(kSquares.capacity() == 16, "");
+
+// trivial types stay trivially copyable
+static_assert(
+    std::is_trivially_copyable<learn_cpp::detail::static_vector<int, 8>>::value,
+    "");
+static_assert(!std::is_trivially_copyable<
+                  learn_cpp::detail::static_vector<std::string, 8>>::value,
+              "");
+
+// so do trivially copyable types that are not trivial
+struct Point {
+    int x = 0;
+};
+static_assert(!std::is_trivial<Point>::value, "");
+static_assert(std::is_trivially_copyable<
+                  learn_cpp::detail::static_vector<Point, 4>>::value,
+              "");
+
+void test_static_vector_1() {
+    using learn_cpp::detail::static_vector;
+
+    static_vector<int, 4> vec1 = {1, 2, 3};
+    assert(vec1.size() == 3 && !vec1.full());
+    assert(vec1.front() == 1 && vec1.back() == 3);
+    assert(*vec1.rbegin() == 3);
+    vec1.insert(vec1.begin() + 1, 10);
+    assert(vec1.full());
+    assert(vec1 == (static_vector<int, 4>{1, 10, 2, 3}));
+    vec1.erase(vec1.begin(), vec1.begin() + 2);
+    assert(vec1 == (static_vector<int, 4>{2, 3}));
+    vec1.pop_back();
+    assert(vec1.size() == 1 && vec1.at(0) == 2);
+    try {
+        vec1.at(1);
+        assert(false);
+    } catch (const std::out_of_range&) {
+    }
+    // memcpy is a copy
+    static_vector<int, 4> vec2 = vec1;
+    assert(vec2 == vec1);
+    assert(sizeof(vec1) == 4 * sizeof(int) + sizeof(std::size_t));
+
+    static_vector<Point, 4> vec3(2);
+    vec3.push_back(Point{5});
+    auto vec4 = vec3;
+    assert(vec4.size() == 3 && vec4[0].x == 0 && vec4[2].x == 5);
+}
+
+// overflow policies
+void test_static_vector_2() {
+    using learn_cpp::detail::overflow_report;
+    using learn_cpp::detail::overflow_throw;
+    using learn_cpp::detail::static_vector;
+
+    static_vector<int, 2, overflow_report> vec1;
+    assert(vec1.push_back(1) && vec1.push_back(2));
+    assert(!vec1.push_back(3) && vec1.size() == 2);
+    assert(vec1.emplace_back(3) == nullptr);
+    assert(vec1.insert(vec1.begin(), 0) == vec1.end());
+    assert(!vec1.resize(3) && vec1.size() == 2);
+    assert(vec1.reserve(2) && !vec1.reserve(3));
+    assert(vec1[0] == 1 && vec1[1] == 2);
+    // a constructor cannot report: it fills the capacity
+    static_vector<int, 2, overflow_report> vec3(5, 7);
+    assert(vec3.size() == 2 && vec3[1] == 7);
+
+    static_vector<int, 2, overflow_throw> vec2(2);
+    try {
+        vec2.push_back(1);
+        assert(false);
+    } catch (const std::length_error&) {
+    }
+    assert(vec2.size() == 2);
+}
+
+// non-trivial elements are constructed and destroyed in place
+void test_static_vector_3() {
+    using learn_cpp::detail::static_vector;
+
+    auto counter = std::make_shared<int>(0);
+    {
+        static_vector<std::shared_ptr<int>, 8> vec1;
+        for (int i = 0; i < 5; ++i) {
+            vec1.push_back(counter);
+        }
+        assert(counter.use_count() == 6);
+        auto vec2 = vec1;
+        assert(counter.use_count() == 11);
+        vec2.erase(vec2.begin() + 1, vec2.begin() + 3);
+        assert(vec2.size() == 3 && counter.use_count() == 9);
+        vec1.clear();
+        assert(counter.use_count() == 4);
+    }
+    assert(counter.use_count() == 1);
+
+    static_vector<std::string, 4> vec3 = {"a", "c"};
+    vec3.emplace(vec3.begin() + 1, "b");
+    // an argument that refers to an element
+    vec3.insert(vec3.begin(), vec3[2]);
+    assert(vec3 == (static_vector<std::string, 4>{"c", "a", "b", "c"}));
+    static_vector<std::string, 4> vec4;
+    vec4.swap(vec3);
+    assert(vec3.empty() && vec4.size() == 4 && vec4[2] == "b");
+}
@@ -0,0 +1,88 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../benchmark/benchmark.hpp"
+#include "shared_ptr.hpp"
+
+/**
+ * SharedPtr vs std::shared_ptr.
+ *
+ * Usage: bench_SharedPtr.out [operations] [threads] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::SharedPtr;
+
+template <class Ptr>
+void bench_create(BenchmarkRunner& runner, const std::string& name,
+                  std::size_t n) {
+    runner
+        .run(name + "/create_destroy",
+             [n]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     Ptr p(new int(static_cast<int>(i)));
+                     do_not_optimize(p.get());
+                 }
+             })
+        .set_items(n);
+}
+
+// copy + destroy: one increment and one decrement of the count.
+template <class Ptr>
+void bench_copy(BenchmarkRunner& runner, const std::string& name,
+                std::size_t n) {
+    Ptr p(new int(1));
+    runner
+        .run(name + "/copy",
+             [n, &p]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     Ptr copy(p);
+                     do_not_optimize(copy.get());
+                 }
+             })
+        .set_items(n);
+}
+
+// all threads copy the same pointer, the count is contended.
+template <class Ptr>
+void bench_copy_contended(BenchmarkRunner& runner, const std::string& name,
+                          std::size_t n, unsigned threads) {
+    Ptr p(new int(1));
+    runner
+        .run_parallel(
+            name + "/copy_contended/" + std::to_string(threads),
+            [n, threads, &p]() {
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([n, threads, &p]() {
+                        for (std::size_t i = 0; i < n / threads; ++i) {
+                            Ptr copy(p);
+                            do_not_optimize(copy.get());
+                        }
+                    });
+                }
+                for (auto& w : workers) {
+                    w.join();
+                }
+            })
+        .set_items(n);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    unsigned threads = static_cast<unsigned>(options.arg(1, 4));
+    BenchmarkRunner runner("SharedPtr", options);
+
+    bench_create<std::shared_ptr<int>>(runner, "std::shared_ptr", n);
+    bench_create<SharedPtr<int>>(runner, "SharedPtr", n);
+    bench_copy<std::shared_ptr<int>>(runner, "std::shared_ptr", n);
+    bench_copy<SharedPtr<int>>(runner, "SharedPtr", n);
+    bench_copy_contended<std::shared_ptr<int>>(runner, "std::shared_ptr", n,
+                                               threads);
+    bench_copy_contended<SharedPtr<int>>(runner, "SharedPtr", n, threads);
+}
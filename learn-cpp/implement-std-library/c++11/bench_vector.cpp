@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../../benchmark/benchmark.hpp"
+#include "vector.hpp"
+
+/**
+ * v1::vector vs std::vector.
+ *
+ * Usage: bench_vector.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+
+template <class Vector>
+void bench_push_back(BenchmarkRunner& runner, const std::string& name,
+                     std::size_t n) {
+    runner
+        .run(name + "/push_back",
+             [n]() {
+                 Vector vec;
+                 for (std::size_t i = 0; i < n; ++i) {
+                     vec.push_back(static_cast<int>(i));
+                 }
+                 do_not_optimize(vec.data());
+             })
+        .set_items(n);
+}
+
+template <class Vector>
+void bench_copy(BenchmarkRunner& runner, const std::string& name,
+                std::size_t n) {
+    Vector src(n, 1);
+    runner
+        .run(name + "/copy",
+             [&src]() {
+                 Vector copy(src);
+                 do_not_optimize(copy.data());
+             })
+        .set_items(n)
+        .set_bytes(n * sizeof(int));
+}
+
+template <class Vector>
+void bench_random_read(BenchmarkRunner& runner, const std::string& name,
+                       std::size_t n) {
+    Vector vec(n, 1);
+    std::vector<std::uint32_t> indices(n);
+    std::mt19937 rng(1);
+    for (auto& i : indices) {
+        i = rng() % n;
+    }
+    runner
+        .run(name + "/random_read",
+             [&vec, &indices]() {
+                 long sum = 0;
+                 for (auto i : indices) {
+                     sum += vec[i];
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n);
+}
+
+template <class Vector>
+void bench_push_back_string(BenchmarkRunner& runner, const std::string& name,
+                            std::size_t n) {
+    runner
+        .run(name + "/push_back_string",
+             [n]() {
+                 Vector vec;
+                 for (std::size_t i = 0; i < n; ++i) {
+                     vec.emplace_back(32, 'x');
+                 }
+                 do_not_optimize(vec.data());
+             })
+        .set_items(n);
+}
+
+// insert in the middle, then erase it again: one shift of half the
+// elements per call.
+template <class Vector, class Value>
+void bench_middle_insert(BenchmarkRunner& runner, const std::string& name,
+                         std::size_t n, std::size_t ops, const Value& value) {
+    Vector vec(n, value);
+    runner
+        .run(name,
+             [&vec, ops, &value]() {
+                 for (std::size_t i = 0; i < ops; ++i) {
+                     auto it = vec.insert(vec.begin() + vec.size() / 2, value);
+                     vec.erase(it);
+                 }
+                 do_not_optimize(vec.data());
+             })
+        .set_items(ops)
+        .set_bytes(ops * (n / 2) * sizeof(Value) * 2);
+}
+
+// grow a sorted vector by inserting at random positions.
+template <class Vector>
+void bench_sorted_insert(BenchmarkRunner& runner, const std::string& name,
+                         std::size_t n) {
+    std::vector<int> keys(n);
+    std::mt19937 rng(2);
+    for (auto& k : keys) {
+        k = static_cast<int>(rng());
+    }
+    runner
+        .run(name + "/sorted_insert",
+             [&keys]() {
+                 Vector vec;
+                 for (int k : keys) {
+                     vec.insert(std::lower_bound(vec.begin(), vec.end(), k), k);
+                 }
+                 do_not_optimize(vec.data());
+             })
+        .set_items(n);
+}
+
+int main(int argc, char* argv[]) {
+    using learn_cpp::detail::v1::vector;
+
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    BenchmarkRunner runner("vector", options);
+
+    bench_push_back<std::vector<int>>(runner, "std::vector", n);
+    bench_push_back<vector<int>>(runner, "v1::vector", n);
+    bench_copy<std::vector<int>>(runner, "std::vector", n);
+    bench_copy<vector<int>>(runner, "v1::vector", n);
+    bench_random_read<std::vector<int>>(runner, "std::vector", n);
+    bench_random_read<vector<int>>(runner, "v1::vector", n);
+    bench_push_back_string<std::vector<std::string>>(runner, "std::vector",
+                                                     n / 10);
+    bench_push_back_string<vector<std::string>>(runner, "v1::vector", n / 10);
+    bench_middle_insert<std::vector<int>>(
+        runner, "std::vector/middle_insert_erase", n / 10, 100, 1);
+    bench_middle_insert<vector<int>>(runner, "v1::vector/middle_insert_erase",
+                                     n / 10, 100, 1);
+    std::string str(32, 'x');
+    bench_middle_insert<std::vector<std::string>>(
+        runner, "std::vector/middle_insert_erase_string", n / 100, 100, str);
+    bench_middle_insert<vector<std::string>>(
+        runner, "v1::vector/middle_insert_erase_string", n / 100, 100, str);
+    bench_sorted_insert<std::vector<int>>(runner, "std::vector", n / 50);
+    bench_sorted_insert<vector<int>>(runner, "v1::vector", n / 50);
+}
@@ -6,6 +6,11 @@
 #include <memory>
 #include <type_traits>
 
+#if defined(LEARN_CPP_TRACK_SHARED_PTR)
+#include "../../memory/allocation_stats.hpp"
+#endif
+#include "../../utility/trace.hpp"
+
 namespace learn_cpp {
 
 namespace detail {
@@ -42,14 +47,17 @@ class SharedCount {
 
     bool release_shared() noexcept {
         if (shared_owners_.fetch_add(-1, std::memory_order_acq_rel) == 0) {
+            LEARN_CPP_TRACE_SCOPE("SharedCount::on_zero_shared");
             on_zero_shared();
             return true;
         }
         return false;
     }
 
+    // acquire: an owner that sees use_count() == 1 also sees every access
+    // the other owners made before they released.
     long use_count() const noexcept {
-        return shared_owners_.load(std::memory_order_relaxed) + 1;
+        return shared_owners_.load(std::memory_order_acquire) + 1;
     }
 
     virtual void on_zero_shared() noexcept = 0;
@@ -73,6 +81,20 @@ class SharedCountCntrl : public SharedCount {
         delete this;
     }
 
+#if defined(LEARN_CPP_TRACK_SHARED_PTR)
+    // count the control blocks in the allocation stats.
+    static void* operator new(std::size_t bytes) {
+        void* p = ::operator new(bytes);
+        allocation_stats::record_allocate(bytes);
+        return p;
+    }
+
+    static void operator delete(void* p, std::size_t bytes) noexcept {
+        allocation_stats::record_deallocate(bytes);
+        ::operator delete(p);
+    }
+#endif
+
    private:
     T* data_;
 };
@@ -97,7 +119,8 @@ class SharedPtr {
         : ptr_(nullptr), cntrl_(nullptr) {}
 
     template <typename Y,
-              typename = std::enable_if<std::is_convertible<Y*, T*>::value>>
+              typename = typename std::enable_if<
+                  std::is_convertible<Y*, T*>::value>::type>
     explicit SharedPtr(Y* p) {
         std::unique_ptr<Y> hold(p);
         cntrl_ = new SharedCountCntrl<Y>(p);
@@ -117,7 +140,8 @@ class SharedPtr {
     }
 
     template <typename Y,
-              typename = std::enable_if<std::is_convertible<Y*, T*>::value>>
+              typename = typename std::enable_if<
+                  std::is_convertible<Y*, T*>::value>::type>
     SharedPtr(const SharedPtr<Y>& r) noexcept : ptr_(r.ptr_), cntrl_(r.cntrl_) {
         if (cntrl_) {
             cntrl_->add_shared();
@@ -125,7 +149,8 @@ class SharedPtr {
     }
 
     template <typename Y,
-              typename = std::enable_if<std::is_convertible<Y*, T*>::value>>
+              typename = typename std::enable_if<
+                  std::is_convertible<Y*, T*>::value>::type>
     SharedPtr(const SharedPtr<Y>&& r) noexcept
         : ptr_(r.ptr_), cntrl_(r.cntrl_) {
         if (cntrl_) {
@@ -147,9 +172,10 @@ class SharedPtr {
     }
 
     template <typename Y,
-              typename = std::enable_if<std::is_convertible<Y*, T*>::value>>
+              typename = typename std::enable_if<
+                  std::is_convertible<Y*, T*>::value>::type>
     SharedPtr& operator=(const SharedPtr<Y>& r) noexcept {
-        SharedPtr(r).swap();
+        SharedPtr(r).swap(*this);
         return *this;
     }
 
@@ -163,9 +189,10 @@ class SharedPtr {
     void reset() noexcept { SharedPtr().swap(*this); }
 
     template <typename Y,
-              typename = std::enable_if<std::is_convertible<Y*, T*>::value>>
+              typename = typename std::enable_if<
+                  std::is_convertible<Y*, T*>::value>::type>
     void reset(Y* p) {
-        SharedPtr(p).reset(*this);
+        SharedPtr(p).swap(*this);
     }
 
     // observers
@@ -191,7 +218,10 @@ class SharedPtr {
 
    private:
     element_type* ptr_;
-    SharedCountCntrl<T>* cntrl_;
+    SharedCount* cntrl_;
+
+    template <typename Y>
+    friend class SharedPtr;
 };
 
 template<class T>
@@ -1,5 +1,7 @@
 #include <cassert>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include <string>
 
 #include "vector.hpp"
@@ -9,10 +11,16 @@
 
 void test_v1_vector_1();
 void test_v1_vector_2();
+void test_v1_vector_3();
+void test_v1_vector_4();
+void test_v1_vector_5();
 
 int main() {
     test_v1_vector_1();
     test_v1_vector_2();
+    test_v1_vector_3();
+    test_v1_vector_4();
+    test_v1_vector_5();
 }
 
 void test_v1_vector_1() {
@@ -77,3 +85,134 @@ void test_v1_vector_2() {
     unsigned size5 = size3 + 1;
     assert(vec5.size() == size5);
 }
+
+template <class Vector, class List>
+bool same_elements(const Vector& vec, const List& expected) {
+    if (vec.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    for (auto& item : vec) {
+        if (!(item == *it++)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// insert / erase, memmove path
+void test_v1_vector_3() {
+    using learn_cpp::detail::v1::vector;
+    using list = std::initializer_list<int>;
+
+    vector<int> vec1 = {1, 2, 3};
+    // reallocation
+    auto it1 = vec1.insert(vec1.begin() + 1, 9);
+    assert(*it1 == 9);
+    assert(same_elements(vec1, list{1, 9, 2, 3}));
+    vec1.reserve(16);
+    // in place
+    it1 = vec1.insert(vec1.begin(), 2, 7);
+    assert(it1 == vec1.begin());
+    assert(same_elements(vec1, list{7, 7, 1, 9, 2, 3}));
+    // x refers to an element that moves
+    vec1.insert(vec1.begin(), vec1[5]);
+    assert(same_elements(vec1, list{3, 7, 7, 1, 9, 2, 3}));
+    it1 = vec1.emplace(vec1.end(), 4);
+    assert(*it1 == 4 && vec1.size() == 8);
+    vec1.insert(vec1.begin() + 2, {5, 6});
+    assert(same_elements(vec1, list{3, 7, 5, 6, 7, 1, 9, 2, 3, 4}));
+
+    it1 = vec1.erase(vec1.begin() + 1);
+    assert(*it1 == 5);
+    it1 = vec1.erase(vec1.begin() + 1, vec1.begin() + 5);
+    assert(*it1 == 9);
+    assert(same_elements(vec1, list{3, 9, 2, 3, 4}));
+    it1 = vec1.erase(vec1.begin() + 3, vec1.end());
+    assert(it1 == vec1.end());
+    assert(same_elements(vec1, list{3, 9, 2}));
+
+    // input iterators
+    std::istringstream input("10 11 12");
+    vec1.insert(vec1.begin() + 1, std::istream_iterator<int>(input),
+                std::istream_iterator<int>());
+    assert(same_elements(vec1, list{3, 10, 11, 12, 9, 2}));
+
+    vector<int> vec2;
+    vec2.insert(vec2.end(), vec1.begin(), vec1.end());
+    assert(same_elements(vec2, vec1));
+}
+
+// insert / erase, move assignment path
+void test_v1_vector_4() {
+    using learn_cpp::detail::v1::vector;
+    using std::string;
+    using list = std::initializer_list<string>;
+
+    vector<string> vec1 = {"a", "b", "c", "d"};
+    vec1.reserve(16);
+    // fewer new values than elements after the position
+    vec1.insert(vec1.begin() + 1, 2, "x");
+    assert(same_elements(vec1, list{"a", "x", "x", "b", "c", "d"}));
+    // more new values than elements after the position
+    vec1.insert(vec1.end() - 1, {"p", "q", "r"});
+    assert(same_elements(vec1,
+                         list{"a", "x", "x", "b", "c", "p", "q", "r", "d"}));
+    vec1.insert(vec1.begin(), vec1[8]);
+    assert(vec1[0] == "d" && vec1[9] == "d");
+    string s = "moved";
+    vec1.insert(vec1.begin() + 1, std::move(s));
+    assert(vec1[1] == "moved");
+    auto it1 = vec1.emplace(vec1.begin() + 2, 3, 'e');
+    assert(*it1 == "eee");
+    assert(vec1.size() == 12);
+
+    // reallocation
+    vector<string> vec2 = {"1", "2"};
+    vec2.insert(vec2.begin() + 1, vec1.begin(), vec1.end());
+    assert(vec2.size() == 14);
+    assert(vec2[0] == "1" && vec2[1] == "d" && vec2[13] == "2");
+
+    it1 = vec1.erase(vec1.begin(), vec1.begin() + 3);
+    assert(*it1 == "a");
+    assert(same_elements(vec1,
+                         list{"a", "x", "x", "b", "c", "p", "q", "r", "d"}));
+    vec1.erase(vec1.begin() + 1, vec1.begin() + 3);
+    vec1.erase(vec1.end() - 1);
+    assert(same_elements(vec1, list{"a", "b", "c", "p", "q", "r"}));
+    vec1.erase(vec1.begin(), vec1.end());
+    assert(vec1.empty());
+}
+
+// assignment, resize with a value, resize without initialization
+void test_v1_vector_5() {
+    using learn_cpp::detail::v1::vector;
+    using std::string;
+    using list = std::initializer_list<string>;
+
+    vector<string> vec1 = {"a", "b"};
+    vector<string> vec2;
+    (vec2 = vec1).push_back("c");
+    assert(same_elements(vec2, list{"a", "b", "c"}));
+    vector<string> vec3;
+    (vec3 = std::move(vec2)).push_back("d");
+    assert(vec2.empty() && same_elements(vec3, list{"a", "b", "c", "d"}));
+    (vec3 = {"x"}).push_back("y");
+    assert(same_elements(vec3, list{"x", "y"}));
+
+    vec3.resize(4, vec3[0]);
+    assert(same_elements(vec3, list{"x", "y", "x", "x"}));
+    vec3.resize(1, "z");
+    assert(same_elements(vec3, list{"x"}));
+    vec3.resize_default_init(3);
+    assert(same_elements(vec3, list{"x", "", ""}));
+
+    vector<int> vec4 = {1, 2};
+    vec4.resize_default_init(100);
+    assert(vec4.size() == 100 && vec4[1] == 2);
+    for (int i = 2; i < 100; ++i) {
+        vec4[i] = i;
+    }
+    vec4.resize_default_init(3);
+    assert(vec4.size() == 3 && vec4[2] == 2);
+}
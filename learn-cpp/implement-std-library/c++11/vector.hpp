@@ -1,14 +1,21 @@
 #ifndef LEARN_CPP_CXX11_VECTOR_HPP
 #define LEARN_CPP_CXX11_VECTOR_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <new>
 #include <type_traits>
 
+#include "../../template-metaprogarmming/container_traits.hpp"
+#include "../../utility/trace.hpp"
+
 namespace learn_cpp {
 
 namespace detail {
@@ -24,6 +31,9 @@ inline namespace v1 {
 
 template <class T, class Allocator = std::allocator<T>>
 class vector {
+    static_assert(std::is_same<typename Allocator::value_type, T>::value,
+                  "Allocator::value_type must be T");
+
    public:
     // types
     // clang-format off
@@ -101,6 +111,7 @@ class vector {
         }
         auto n = x.size();
         assign_n_(x.begin_, n);
+        return *this;
     }
 
     vector<T, Allocator>& operator=(vector<T, Allocator>&& x) {
@@ -118,19 +129,21 @@ class vector {
         alloc_ = std::move(x.alloc_);
         x.begin_ = x.end_ = nullptr;
         x.end_cap_ = nullptr;
+        return *this;
     }
 
     vector& operator=(std::initializer_list<T> ilist) {
         // NOTE the allocator is not propagated.
         auto n = ilist.size();
         assign_n_(ilist.begin(), n);
+        return *this;
     }
     template <class InputIterator>
     void assign(InputIterator first, InputIterator last);
     void assign(size_type n, const T& t);
     void assign(std::initializer_list<T>);
 
-    allocator_type get_allocator() const noexcept { return alloc_(); }
+    allocator_type get_allocator() const noexcept { return alloc_; }
 
     // iterators:
     iterator begin() noexcept;
@@ -157,6 +170,11 @@ class vector {
 
     void resize(size_type sz);
     void resize(size_type sz, const T& c);
+    /** As resize(sz), but the new elements are default-initialized: for a
+        trivial T they are left indeterminate (no memset), to be written
+        before they are read, e.g. by read() into data().
+     */
+    void resize_default_init(size_type sz);
 
     size_type capacity() const noexcept { return end_cap_ - begin_; }
 
@@ -192,7 +210,10 @@ class vector {
     iterator insert(const_iterator position, const T& x);
     iterator insert(const_iterator position, T&& x);
     iterator insert(const_iterator position, size_type n, const T& x);
-    template <class InputIterator>
+    // NOTE the check keeps insert(pos, 3, 7) away from this overload.
+    template <class InputIterator,
+              class = typename EnableIf<
+                  !std::is_integral<InputIterator>::value>::type>
     iterator insert(const_iterator position, InputIterator first,
                     InputIterator last);
     iterator insert(const_iterator position, std::initializer_list<T>);
@@ -219,11 +240,35 @@ class vector {
         This is used mostly at construction.
      */
     void allocate_mem_(size_type n);
+    /** Get raw memory for n value_type from the allocator.
+        Every allocation goes through here, so over-aligned T is checked once.
+     */
+    pointer allocate_n_(size_type n);
     /** Deallocate memory. Set data members to nullptr.
      */
     void deallocate_mem_();
     void ensure_capacity_(size_type n);
     size_type suggest_capacity_(size_type at_least_cap);
+    /** Move the elements to a new allocation of exactly new_capacity.
+     */
+    void reallocate_(size_type new_capacity);
+    // memcpy for trivially relocatable T, move (or copy) construction else.
+    static void relocate_n_(pointer first, size_type n, pointer dest,
+                            allocator_type& alloc, TrueType) noexcept;
+    static void relocate_n_(pointer first, size_type n, pointer dest,
+                            allocator_type& alloc, FalseType);
+    // move (or copy) construct n elements to dest, keeping the sources.
+    static void uninitialized_move_n_(pointer first, size_type n, pointer dest,
+                                      allocator_type& alloc);
+    // Tell an allocator with an on_reallocate(bytes) member (e.g.
+    // tracking_allocator) that the elements moved, a no-op for the others.
+    template <class A>
+    static auto notify_reallocate_(A& alloc, size_type bytes, int)
+        -> decltype(alloc.on_reallocate(bytes), void()) {
+        alloc.on_reallocate(bytes);
+    }
+    template <class A>
+    static void notify_reallocate_(A&, size_type, long) {}
 
     template <class... Args>
     void construct_n_at_end_(size_type n, Args&&... args);
@@ -234,6 +279,56 @@ class vector {
     void clear_() noexcept;
     template <typename InputIterator>
     void assign_n_(InputIterator first, size_type n);
+
+    // Where insert_n_ takes the new values from, read once each, in order.
+    struct fill_source_ {
+        const T& value;
+        const T& next() const { return value; }
+    };
+    struct move_source_ {
+        T& value;
+        T&& next() { return std::move(value); }
+    };
+    template <class ForwardIterator>
+    struct iterator_source_ {
+        ForwardIterator it;
+        typename std::iterator_traits<ForwardIterator>::reference next() {
+            return *it++;
+        }
+    };
+
+    bool aliases_(const T& x) const noexcept {
+        return begin_ <= std::addressof(x) && std::addressof(x) < end_;
+    }
+    /** Insert n values from source before position.
+        Reallocates at most once, and then builds the new layout directly.
+     */
+    template <class Source>
+    iterator insert_n_(const_iterator position, size_type n, Source source);
+    // memmove the tail up, construct the new values in the gap.
+    template <class Source>
+    void insert_in_place_(pointer p, size_type n, Source& source, TrueType);
+    // move construct / move assign the tail up, as std::vector does.
+    template <class Source>
+    void insert_in_place_(pointer p, size_type n, Source& source, FalseType);
+    template <class Source>
+    void insert_reallocate_(pointer p, size_type n, Source& source);
+    // relocate [first, p) and [p, last) to dest, leaving a gap of n.
+    static void relocate_around_(pointer first, pointer p, pointer last,
+                                 pointer dest, size_type n,
+                                 allocator_type& alloc, TrueType) noexcept;
+    static void relocate_around_(pointer first, pointer p, pointer last,
+                                 pointer dest, size_type n,
+                                 allocator_type& alloc, FalseType);
+    template <class InputIterator>
+    iterator insert_range_(const_iterator position, InputIterator first,
+                           InputIterator last, std::input_iterator_tag);
+    template <class ForwardIterator>
+    iterator insert_range_(const_iterator position, ForwardIterator first,
+                           ForwardIterator last, std::forward_iterator_tag);
+    // destroy [first, last), then close the gap.
+    void erase_(pointer first, pointer last, TrueType) noexcept;
+    void erase_(pointer first, pointer last, FalseType);
 };
 
 template <class T, class Allocator>
@@ -291,6 +386,43 @@ void vector<T, Allocator>::resize(size_type sz) {
     }
 }
 
+template <class T, class Allocator>
+void vector<T, Allocator>::resize(size_type sz, const T& c) {
+    auto old_size = size();
+    if (sz > old_size) {
+        insert(end(), sz - old_size, c);
+        return;
+    }
+    std::allocator_traits<allocator_type> alloc_trait;
+    for (auto i = sz; i < old_size; ++i) {
+        alloc_trait.destroy(get_alloc_(), --end_);
+    }
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::resize_default_init(size_type sz) {
+    if (sz <= size()) {
+        resize(sz);
+        return;
+    }
+    ensure_capacity_(sz);
+    if (std::is_trivially_default_constructible<T>::value) {
+        end_ = begin_ + sz;
+        return;
+    }
+    for (auto i = size(); i < sz; ++i) {
+        ::new (static_cast<void*>(end_)) T;
+        ++end_;
+    }
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::reserve(size_type n) {
+    if (n > capacity()) {
+        reallocate_(n);
+    }
+}
+
 template <class T, class Allocator>
 typename vector<T, Allocator>::reference vector<T, Allocator>::operator[](
     size_type n) {
@@ -321,14 +453,14 @@ void vector<T, Allocator>::push_back(const T& x) {
 template <class T, class Allocator>
 void vector<T, Allocator>::push_back(T&& x) {
     ensure_capacity_(size() + 1);
-    construct_one_at_end_(x);
+    construct_one_at_end_(std::move(x));
 }
 
 template <class T, class Allocator>
 void vector<T, Allocator>::pop_back() {
+    ASSERT(!empty(), "pop_back on empty vector");
     std::allocator_traits<allocator_type> alloc_trait;
-    alloc_trait.destroy(get_alloc_(), end_);
-    --end_;
+    alloc_trait.destroy(get_alloc_(), --end_);
 }
 
 template <class T, class Allocator>
@@ -345,6 +477,79 @@ void vector<T, Allocator>::clear() noexcept {
     clear_();
 }
 
+template <class T, class Allocator>
+template <class... Args>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::emplace(
+    const_iterator position, Args&&... args) {
+    if (position == end_ && end_ != end_cap_) {
+        construct_one_at_end_(std::forward<Args>(args)...);
+        return end_ - 1;
+    }
+    // args may refer to elements that are about to move.
+    T tmp(std::forward<Args>(args)...);
+    return insert_n_(position, 1, move_source_{tmp});
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(
+    const_iterator position, const T& x) {
+    return insert(position, 1, x);
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(
+    const_iterator position, T&& x) {
+    if (aliases_(x)) {
+        T tmp(std::move(x));
+        return insert_n_(position, 1, move_source_{tmp});
+    }
+    return insert_n_(position, 1, move_source_{x});
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(
+    const_iterator position, size_type n, const T& x) {
+    if (aliases_(x)) {
+        T tmp(x);
+        return insert_n_(position, n, fill_source_{tmp});
+    }
+    return insert_n_(position, n, fill_source_{x});
+}
+
+template <class T, class Allocator>
+template <class InputIterator, class>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(
+    const_iterator position, InputIterator first, InputIterator last) {
+    return insert_range_(
+        position, first, last,
+        typename std::iterator_traits<InputIterator>::iterator_category());
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(
+    const_iterator position, std::initializer_list<T> ilist) {
+    return insert(position, ilist.begin(), ilist.end());
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(
+    const_iterator position) {
+    ASSERT(position != end_, "erase(end())");
+    return erase(position, position + 1);
+}
+
+template <class T, class Allocator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::erase(
+    const_iterator first, const_iterator last) {
+    pointer p = begin_ + (first - begin_);
+    pointer q = begin_ + (last - begin_);
+    ASSERT(begin_ <= p && p <= q && q <= end_, "erase of an invalid range");
+    if (p != q) {
+        erase_(p, q, IsTriviallyRelocatable<T>());
+    }
+    return p;
+}
+
 // private methods
 
 template <class T, class Allocator>
@@ -352,11 +557,28 @@ void vector<T, Allocator>::allocate_mem_(size_type n) {
     ASSERT(begin_ == nullptr && end_ == nullptr,
            "should call this for vector that has no allocation");
 
-    begin_ = end_ =
-        std::allocator_traits<allocator_type>{}.allocate(get_alloc_(), n);
+    begin_ = end_ = allocate_n_(n);
     end_cap_ = begin_ + n;
 }
 
+template <class T, class Allocator>
+typename vector<T, Allocator>::pointer vector<T, Allocator>::allocate_n_(
+    size_type n) {
+#if !defined(__cpp_aligned_new)
+    // Before C++17, operator new ignores alignof(T) > alignof(max_align_t).
+    static_assert(!std::is_same<allocator_type, std::allocator<T>>::value ||
+                      alignof(T) <= alignof(std::max_align_t),
+                  "over-aligned T needs an aligned allocator before C++17");
+#endif
+    pointer p =
+        std::allocator_traits<allocator_type>::allocate(get_alloc_(), n);
+    ASSERT(reinterpret_cast<std::uintptr_t>(static_cast<const void*>(p)) %
+                   alignof(T) ==
+               0,
+           "the allocator returned memory not aligned for T");
+    return p;
+}
+
 template <class T, class Allocator>
 void vector<T, Allocator>::deallocate_mem_() {
     std::allocator_traits<allocator_type>::deallocate(get_alloc_(), begin_,
@@ -370,21 +592,282 @@ void vector<T, Allocator>::ensure_capacity_(size_type n) {
     if (!(capacity() < n)) {
         return;
     }
+    reallocate_(suggest_capacity_(n));
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::reallocate_(size_type new_capacity) {
+    ASSERT(new_capacity >= size(), "reallocate_ would drop elements");
+    LEARN_CPP_TRACE_SCOPE("vector::reallocate");
     auto old_size = size();
-    auto new_capacity = suggest_capacity_(n);
-    std::allocator_traits<allocator_type> alloc_trait;
-    pointer new_begin_ = alloc_trait.allocate(get_alloc_(), new_capacity);
+    pointer new_begin_ = allocate_n_(new_capacity);
     if (begin_ != nullptr) {
-        // NOTE Could use move here
-        std::uninitialized_copy_n(begin_, old_size, new_begin_);
-        clear_();
+        try {
+            relocate_n_(begin_, old_size, new_begin_, get_alloc_(),
+                        IsTriviallyRelocatable<T>());
+        } catch (...) {
+            std::allocator_traits<allocator_type>::deallocate(
+                get_alloc_(), new_begin_, new_capacity);
+            throw;
+        }
+        // the old elements are already destroyed (or forgotten).
         deallocate_mem_();
+        notify_reallocate_(get_alloc_(), old_size * sizeof(T), 0);
     }
     begin_ = new_begin_;
     end_ = begin_ + old_size;
     end_cap_ = begin_ + new_capacity;
 }
 
+template <class T, class Allocator>
+void vector<T, Allocator>::relocate_n_(pointer first, size_type n,
+                                       pointer dest, allocator_type&,
+                                       TrueType) noexcept {
+    if (n != 0) {
+        std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first),
+                    n * sizeof(T));
+    }
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::relocate_n_(pointer first, size_type n,
+                                       pointer dest, allocator_type& alloc,
+                                       FalseType) {
+    uninitialized_move_n_(first, n, dest, alloc);
+    for (size_type i = 0; i < n; ++i) {
+        std::allocator_traits<allocator_type>::destroy(alloc, first + i);
+    }
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::uninitialized_move_n_(pointer first, size_type n,
+                                                 pointer dest,
+                                                 allocator_type& alloc) {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    size_type i = 0;
+    try {
+        for (; i < n; ++i) {
+            alloc_trait::construct(alloc, dest + i,
+                                   std::move_if_noexcept(first[i]));
+        }
+    } catch (...) {
+        for (size_type j = 0; j < i; ++j) {
+            alloc_trait::destroy(alloc, dest + j);
+        }
+        throw;
+    }
+}
+
+template <class T, class Allocator>
+template <class Source>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert_n_(
+    const_iterator position, size_type n, Source source) {
+    pointer p = begin_ + (position - begin_);
+    ASSERT(begin_ <= p && p <= end_, "insert at an invalid position");
+    if (n == 0) {
+        return p;
+    }
+    if (begin_ == nullptr || size_type(end_cap_ - end_) < n) {
+        auto index = p - begin_;
+        insert_reallocate_(p, n, source);
+        return begin_ + index;
+    }
+    insert_in_place_(p, n, source, IsTriviallyRelocatable<T>());
+    return p;
+}
+
+template <class T, class Allocator>
+template <class Source>
+void vector<T, Allocator>::insert_in_place_(pointer p, size_type n,
+                                            Source& source, TrueType) {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    size_type tail = end_ - p;
+    if (tail != 0) {
+        std::memmove(static_cast<void*>(p + n), static_cast<const void*>(p),
+                     tail * sizeof(T));
+    }
+    size_type i = 0;
+    try {
+        for (; i < n; ++i) {
+            alloc_trait::construct(get_alloc_(), p + i, source.next());
+        }
+    } catch (...) {
+        for (size_type j = 0; j < i; ++j) {
+            alloc_trait::destroy(get_alloc_(), p + j);
+        }
+        if (tail != 0) {
+            std::memmove(static_cast<void*>(p),
+                         static_cast<const void*>(p + n), tail * sizeof(T));
+        }
+        throw;
+    }
+    end_ += n;
+}
+
+// NOTE only the basic guarantee here, like std::vector for a middle insert.
+template <class T, class Allocator>
+template <class Source>
+void vector<T, Allocator>::insert_in_place_(pointer p, size_type n,
+                                            Source& source, FalseType) {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    pointer old_end = end_;
+    size_type tail = old_end - p;
+    if (n <= tail) {
+        // the last n elements go to raw memory, the rest shifts by
+        // move assignment, then the gap is assigned.
+        for (pointer q = old_end - n; q != old_end; ++q) {
+            alloc_trait::construct(get_alloc_(), end_, std::move(*q));
+            ++end_;
+        }
+        std::move_backward(p, old_end - n, old_end);
+        for (size_type i = 0; i < n; ++i) {
+            p[i] = source.next();
+        }
+        return;
+    }
+    // the whole tail goes to raw memory, the gap is assigned where there
+    // were elements and constructed after them.
+    uninitialized_move_n_(p, tail, p + n, get_alloc_());
+    size_type i = 0;
+    try {
+        for (; i < tail; ++i) {
+            p[i] = source.next();
+        }
+        for (; i < n; ++i) {
+            alloc_trait::construct(get_alloc_(), p + i, source.next());
+        }
+    } catch (...) {
+        for (size_type j = tail; j < i; ++j) {
+            alloc_trait::destroy(get_alloc_(), p + j);
+        }
+        for (size_type j = 0; j < tail; ++j) {
+            alloc_trait::destroy(get_alloc_(), p + n + j);
+        }
+        throw;
+    }
+    end_ += n;
+}
+
+template <class T, class Allocator>
+template <class Source>
+void vector<T, Allocator>::insert_reallocate_(pointer p, size_type n,
+                                              Source& source) {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    pointer old_begin = begin_;
+    pointer old_end = end_;
+    auto old_size = size();
+    size_type index = p - begin_;
+    size_type new_capacity = suggest_capacity_(old_size + n);
+    pointer new_begin_ = allocate_n_(new_capacity);
+    // the new values first, source may still point into the old buffer.
+    size_type i = 0;
+    try {
+        for (; i < n; ++i) {
+            alloc_trait::construct(get_alloc_(), new_begin_ + index + i,
+                                   source.next());
+        }
+        if (old_begin != nullptr) {
+            relocate_around_(old_begin, p, old_end, new_begin_, n,
+                             get_alloc_(), IsTriviallyRelocatable<T>());
+        }
+    } catch (...) {
+        for (size_type j = 0; j < i; ++j) {
+            alloc_trait::destroy(get_alloc_(), new_begin_ + index + j);
+        }
+        alloc_trait::deallocate(get_alloc_(), new_begin_, new_capacity);
+        throw;
+    }
+    if (begin_ != nullptr) {
+        deallocate_mem_();
+        notify_reallocate_(get_alloc_(), old_size * sizeof(T), 0);
+    }
+    begin_ = new_begin_;
+    end_ = begin_ + old_size + n;
+    end_cap_ = begin_ + new_capacity;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::relocate_around_(pointer first, pointer p,
+                                            pointer last, pointer dest,
+                                            size_type n,
+                                            allocator_type& alloc,
+                                            TrueType) noexcept {
+    relocate_n_(first, p - first, dest, alloc, TrueType());
+    relocate_n_(p, last - p, dest + (p - first) + n, alloc, TrueType());
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::relocate_around_(pointer first, pointer p,
+                                            pointer last, pointer dest,
+                                            size_type n,
+                                            allocator_type& alloc,
+                                            FalseType) {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    size_type front = p - first;
+    // nothing of the old buffer is destroyed until both halves are built.
+    uninitialized_move_n_(first, front, dest, alloc);
+    try {
+        uninitialized_move_n_(p, last - p, dest + front + n, alloc);
+    } catch (...) {
+        for (size_type j = 0; j < front; ++j) {
+            alloc_trait::destroy(alloc, dest + j);
+        }
+        throw;
+    }
+    for (pointer q = first; q != last; ++q) {
+        alloc_trait::destroy(alloc, q);
+    }
+}
+
+template <class T, class Allocator>
+template <class InputIterator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert_range_(
+    const_iterator position, InputIterator first, InputIterator last,
+    std::input_iterator_tag) {
+    // single pass: append, then rotate into place.
+    auto index = position - begin_;
+    auto old_size = size();
+    for (; first != last; ++first) {
+        emplace_back(*first);
+    }
+    std::rotate(begin_ + index, begin_ + old_size, end_);
+    return begin_ + index;
+}
+
+template <class T, class Allocator>
+template <class ForwardIterator>
+typename vector<T, Allocator>::iterator vector<T, Allocator>::insert_range_(
+    const_iterator position, ForwardIterator first, ForwardIterator last,
+    std::forward_iterator_tag) {
+    size_type n = std::distance(first, last);
+    return insert_n_(position, n, iterator_source_<ForwardIterator>{first});
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::erase_(pointer first, pointer last,
+                                  TrueType) noexcept {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    for (pointer q = first; q != last; ++q) {
+        alloc_trait::destroy(get_alloc_(), q);
+    }
+    size_type tail = end_ - last;
+    if (tail != 0) {
+        std::memmove(static_cast<void*>(first), static_cast<const void*>(last),
+                     tail * sizeof(T));
+    }
+    end_ -= last - first;
+}
+
+template <class T, class Allocator>
+void vector<T, Allocator>::erase_(pointer first, pointer last, FalseType) {
+    using alloc_trait = std::allocator_traits<allocator_type>;
+    pointer new_end = std::move(last, end_, first);
+    for (pointer q = new_end; q != end_; ++q) {
+        alloc_trait::destroy(get_alloc_(), q);
+    }
+    end_ = new_end;
+}
+
 template <class T, class Allocator>
 typename vector<T, Allocator>::size_type
 vector<T, Allocator>::suggest_capacity_(size_type at_least_cap) {
@@ -401,7 +884,7 @@ template <class T, class Allocator>
 template <class... Args>
 void vector<T, Allocator>::construct_n_at_end_(size_type n, Args&&... args) {
     std::allocator_traits<allocator_type> alloc_trait;
-    for (int i = 0; i < n; ++i) {
+    for (size_type i = 0; i < n; ++i) {
         alloc_trait.construct(get_alloc_(), end_, std::forward<Args>(args)...);
         ++end_;
     }
@@ -425,6 +908,7 @@ void vector<T, Allocator>::clear_() noexcept {
     for (auto p = begin_; p != end_; ++p) {
         alloc_trait.destroy(get_alloc_(), p);
     }
+    end_ = begin_;
 }
 
 template <class T, class Allocator>
@@ -433,7 +917,7 @@ void vector<T, Allocator>::assign_n_(InputIterator first, size_type n) {
     clear_();
     ensure_capacity_(n);
     for (size_type i = 0; i < n; ++i) {
-        std::allocator_traits<allocator_type>::consturct(get_alloc_(), end_,
+        std::allocator_traits<allocator_type>::construct(get_alloc_(), end_,
                                                          *first);
         ++end_;
         ++first;
@@ -0,0 +1,86 @@
+#ifndef LEARN_CPP_MEMORY_ALIGNED_ALLOCATOR_HPP
+#define LEARN_CPP_MEMORY_ALIGNED_ALLOCATOR_HPP
+
+#include <stdlib.h>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace learn_cpp {
+
+namespace detail {
+
+/**
+   An allocator returning memory aligned to at least Align bytes, e.g. 64 for
+   cache-line aligned SIMD loads. Align is raised to alignof(T) if it is
+   smaller, so over-aligned T are always handled.
+ */
+template <class T, std::size_t Align = 64>
+class aligned_allocator {
+    static_assert(Align != 0 && (Align & (Align - 1)) == 0,
+                  "Align must be a power of two");
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using is_always_equal = std::true_type;
+
+    // Align is a non-type parameter, allocator_traits can not deduce this.
+    template <class U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    static constexpr std::size_t alignment =
+        Align < alignof(T) ? alignof(T) : Align;
+
+    aligned_allocator() noexcept = default;
+
+    template <class U>
+    aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    T* allocate(size_type n) {
+        if (n > std::size_t(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+#if defined(__cpp_aligned_new)
+        return static_cast<T*>(
+            ::operator new(n * sizeof(T), std::align_val_t(alignment)));
+#else
+        void* p = nullptr;
+        // posix_memalign wants at least sizeof(void*).
+        std::size_t align =
+            alignment < sizeof(void*) ? sizeof(void*) : alignment;
+        if (::posix_memalign(&p, align, n * sizeof(T)) != 0) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+#endif
+    }
+
+    void deallocate(T* p, size_type) noexcept {
+#if defined(__cpp_aligned_new)
+        ::operator delete(p, std::align_val_t(alignment));
+#else
+        ::free(p);
+#endif
+    }
+};
+
+template <class T, class U, std::size_t Align>
+bool operator==(const aligned_allocator<T, Align>&,
+                const aligned_allocator<U, Align>&) noexcept {
+    return true;
+}
+
+template <class T, class U, std::size_t Align>
+bool operator!=(const aligned_allocator<T, Align>&,
+                const aligned_allocator<U, Align>&) noexcept {
+    return false;
+}
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
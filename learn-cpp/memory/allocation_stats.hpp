@@ -0,0 +1,272 @@
+#ifndef LEARN_CPP_MEMORY_ALLOCATION_STATS_HPP
+#define LEARN_CPP_MEMORY_ALLOCATION_STATS_HPP
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace learn_cpp {
+namespace detail {
+
+/*
+   Allocation statistics, counted per thread and summed on demand.
+
+   Every thread owns one AllocationCounters record. Only that thread writes
+   it, so an update is a relaxed load + store, no atomic read-modify-write
+   and no shared cache line. Readers (the report) only load.
+
+   Records are never freed: the counts of finished threads stay in the
+   report, and the signal handler can walk the list without locking.
+
+   Live and peak bytes are the exception: memory freed by another thread
+   makes per-thread live counts meaningless, so they are one process-wide
+   counter (a relaxed fetch_add per allocation) and its maximum (a CAS,
+   only when the peak grows).
+ */
+
+// bucket i counts allocations of [2^(i-1), 2^i) bytes, bucket 0 is 0 bytes.
+constexpr int kAllocationBuckets = 65;
+
+struct AllocationCounters {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> bytes_allocated{0};
+    std::atomic<std::uint64_t> bytes_freed{0};
+    std::atomic<std::uint64_t> reallocations{0};
+    std::atomic<std::uint64_t> bytes_relocated{0};
+    std::atomic<std::uint64_t> histogram[kAllocationBuckets] = {};
+    AllocationCounters* next = nullptr;
+};
+
+struct AllocationReport {
+    std::uint64_t threads = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t bytes_allocated = 0;
+    std::uint64_t bytes_freed = 0;
+    std::int64_t live_bytes = 0;
+    // the highest live_bytes seen by any allocation, process-wide.
+    std::int64_t peak_live_bytes = 0;
+    std::uint64_t reallocations = 0;
+    std::uint64_t bytes_relocated = 0;
+    std::uint64_t histogram[kAllocationBuckets] = {};
+};
+
+namespace allocation_stats {
+
+inline std::atomic<AllocationCounters*>& registry_head() {
+    static std::atomic<AllocationCounters*> head{nullptr};
+    return head;
+}
+
+// process-wide, on a cache line of their own.
+struct alignas(64) LiveBytes {
+    std::atomic<std::int64_t> live{0};
+    std::atomic<std::int64_t> peak{0};
+};
+
+inline LiveBytes& live_bytes() {
+    static LiveBytes bytes;
+    return bytes;
+}
+
+inline AllocationCounters* register_thread() {
+    auto* counters = new AllocationCounters();
+    auto& head = registry_head();
+    counters->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(counters->next, counters,
+                                       std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+    return counters;
+}
+
+inline AllocationCounters& local() {
+    thread_local AllocationCounters* counters = register_thread();
+    return *counters;
+}
+
+// single writer, so no read-modify-write is needed.
+template <class T>
+inline void bump(std::atomic<T>& counter, T delta) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+}
+
+inline int bucket_of(std::size_t bytes) noexcept {
+    return bytes == 0 ? 0 : 64 - __builtin_clzll(bytes);
+}
+
+inline void record_allocate(std::size_t bytes) noexcept {
+    auto& c = local();
+    bump<std::uint64_t>(c.allocations, 1);
+    bump<std::uint64_t>(c.bytes_allocated, bytes);
+    bump<std::uint64_t>(c.histogram[bucket_of(bytes)], 1);
+    auto& global = live_bytes();
+    auto delta = static_cast<std::int64_t>(bytes);
+    std::int64_t live =
+        global.live.fetch_add(delta, std::memory_order_relaxed) + delta;
+    std::int64_t peak = global.peak.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !global.peak.compare_exchange_weak(peak, live,
+                                              std::memory_order_relaxed)) {
+    }
+}
+
+inline void record_deallocate(std::size_t bytes) noexcept {
+    auto& c = local();
+    bump<std::uint64_t>(c.deallocations, 1);
+    bump<std::uint64_t>(c.bytes_freed, bytes);
+    live_bytes().live.fetch_sub(static_cast<std::int64_t>(bytes),
+                                std::memory_order_relaxed);
+}
+
+/** A container moved its elements to a new buffer.
+ */
+inline void record_reallocate(std::size_t relocated_bytes) noexcept {
+    auto& c = local();
+    bump<std::uint64_t>(c.reallocations, 1);
+    bump<std::uint64_t>(c.bytes_relocated, relocated_bytes);
+}
+
+/** Sum the counters of all threads. Async-signal-safe.
+ */
+inline AllocationReport collect() noexcept {
+    AllocationReport r;
+    auto* c = registry_head().load(std::memory_order_acquire);
+    for (; c != nullptr; c = c->next) {
+        const auto relaxed = std::memory_order_relaxed;
+        ++r.threads;
+        r.allocations += c->allocations.load(relaxed);
+        r.deallocations += c->deallocations.load(relaxed);
+        r.bytes_allocated += c->bytes_allocated.load(relaxed);
+        r.bytes_freed += c->bytes_freed.load(relaxed);
+        r.reallocations += c->reallocations.load(relaxed);
+        r.bytes_relocated += c->bytes_relocated.load(relaxed);
+        for (int i = 0; i < kAllocationBuckets; ++i) {
+            r.histogram[i] += c->histogram[i].load(relaxed);
+        }
+    }
+    r.live_bytes = live_bytes().live.load(std::memory_order_relaxed);
+    r.peak_live_bytes = live_bytes().peak.load(std::memory_order_relaxed);
+    return r;
+}
+
+// Formatting without stdio or allocation, usable in a signal handler.
+class SignalSafeWriter {
+   public:
+    explicit SignalSafeWriter(int fd) : fd_(fd) {}
+
+    ~SignalSafeWriter() { flush(); }
+
+    SignalSafeWriter& operator<<(const char* s) {
+        while (*s != '\0') {
+            put_(*s++);
+        }
+        return *this;
+    }
+
+    SignalSafeWriter& operator<<(char c) {
+        put_(c);
+        return *this;
+    }
+
+    SignalSafeWriter& operator<<(std::uint64_t value) {
+        char digits[20];
+        int n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        while (n > 0) {
+            put_(digits[--n]);
+        }
+        return *this;
+    }
+
+    SignalSafeWriter& operator<<(std::int64_t value) {
+        if (value < 0) {
+            put_('-');
+            return *this << static_cast<std::uint64_t>(-value);
+        }
+        return *this << static_cast<std::uint64_t>(value);
+    }
+
+    void flush() {
+        std::size_t done = 0;
+        while (done < size_) {
+            ssize_t n = ::write(fd_, buf_ + done, size_ - done);
+            if (n <= 0) {
+                break;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+        size_ = 0;
+    }
+
+   private:
+    int fd_;
+    char buf_[512];
+    std::size_t size_ = 0;
+
+    void put_(char c) {
+        if (size_ == sizeof(buf_)) {
+            flush();
+        }
+        buf_[size_++] = c;
+    }
+};
+
+/** Write the process-wide report to fd. Async-signal-safe.
+ */
+inline void dump(int fd) noexcept {
+    AllocationReport r = collect();
+    SignalSafeWriter out(fd);
+    out << "allocation report (" << r.threads << " threads)\n";
+    out << "  allocations      " << r.allocations << '\n';
+    out << "  deallocations    " << r.deallocations << '\n';
+    out << "  bytes allocated  " << r.bytes_allocated << '\n';
+    out << "  bytes freed      " << r.bytes_freed << '\n';
+    out << "  live bytes       " << r.live_bytes << '\n';
+    out << "  peak live bytes  " << r.peak_live_bytes << '\n';
+    out << "  reallocations    " << r.reallocations << '\n';
+    out << "  bytes relocated  " << r.bytes_relocated << '\n';
+    out << "  size histogram\n";
+    for (int i = 0; i < kAllocationBuckets; ++i) {
+        if (r.histogram[i] == 0) {
+            continue;
+        }
+        std::uint64_t low = i == 0 ? 0 : std::uint64_t(1) << (i - 1);
+        out << "    >= " << low << " B: " << r.histogram[i] << '\n';
+    }
+}
+
+inline std::atomic<int>& report_fd() {
+    static std::atomic<int> fd{STDERR_FILENO};
+    return fd;
+}
+
+inline void on_signal(int) { dump(report_fd().load()); }
+
+/** Dump the report to fd whenever signo (SIGUSR1 by default) is received.
+    Returns false if the handler could not be installed.
+ */
+inline bool install_signal_handler(int signo = SIGUSR1,
+                                   int fd = STDERR_FILENO) {
+    report_fd().store(fd);
+    struct sigaction action = {};
+    action.sa_handler = on_signal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return ::sigaction(signo, &action, nullptr) == 0;
+}
+
+}  // namespace allocation_stats
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef LEARN_CPP_MEMORY_HUGE_PAGE_ALLOCATOR_HPP
+#define LEARN_CPP_MEMORY_HUGE_PAGE_ALLOCATOR_HPP
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace learn_cpp {
+
+namespace detail {
+
+/** Where the memory of an allocation actually came from.
+ */
+enum class page_backing {
+    none,              // nothing allocated yet
+    heap,              // small allocation, ::operator new
+    huge_tlb,          // mmap(MAP_HUGETLB), explicit 2 MB pages
+    transparent_huge,  // mmap + madvise(MADV_HUGEPAGE), THP on demand
+    normal_pages,      // mmap with base pages, every huge page path failed
+};
+
+inline const char* backing_name(page_backing backing) noexcept {
+    switch (backing) {
+        case page_backing::none:
+            return "none";
+        case page_backing::heap:
+            return "heap";
+        case page_backing::huge_tlb:
+            return "huge_tlb";
+        case page_backing::transparent_huge:
+            return "transparent_huge";
+        case page_backing::normal_pages:
+            return "normal_pages";
+    }
+    return "unknown";
+}
+
+/** NUMA placement applied to the large allocations with mbind(2).
+ */
+struct numa_policy {
+    enum class kind { local, bind, interleave };
+
+    kind mode = kind::local;
+    // bit i set means node i.
+    unsigned long nodemask = 0;
+
+    static numa_policy local() noexcept { return numa_policy{}; }
+
+    static numa_policy bind(int node) {
+        if (node < 0 || node >= int(sizeof(unsigned long) * 8)) {
+            throw std::invalid_argument("numa_policy: node out of the mask");
+        }
+        return numa_policy{kind::bind, 1UL << node};
+    }
+
+    static numa_policy interleave(unsigned long nodemask) noexcept {
+        return numa_policy{kind::interleave, nodemask};
+    }
+};
+
+/*
+   Shared by all copies (and rebinds) of one huge_page_allocator, so that
+   the owner of a container can ask its allocator what it got.
+ */
+struct HugePageState {
+    numa_policy policy;
+    std::size_t threshold;
+    std::atomic<page_backing> last_backing{page_backing::none};
+    std::atomic<bool> last_numa_applied{false};
+    std::atomic<std::size_t> bytes[5] = {};
+    // backing of every live mmap'd allocation, needed to keep bytes[] exact.
+    std::mutex mappings_mutex;
+    std::unordered_map<void*, page_backing> mappings;
+
+    HugePageState(numa_policy p, std::size_t t) : policy(p), threshold(t) {}
+};
+
+constexpr std::size_t kHugePageSize = std::size_t(2) << 20;
+
+/**
+   An allocator for large buffers.
+
+   Allocations of at least `threshold` bytes are mmap'd in whole 2 MB units
+   and backed, in order of preference, by explicit huge pages, transparent
+   huge pages or base pages. The NUMA policy is applied before the first
+   touch. Smaller allocations go to ::operator new.
+
+   Which path was taken is recorded, see last_backing() and bytes().
+ */
+template <class T>
+class huge_page_allocator {
+    static_assert(alignof(T) <= 4096, "mmap only guarantees page alignment");
+
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    huge_page_allocator()
+        : huge_page_allocator(numa_policy::local(), kHugePageSize) {}
+
+    explicit huge_page_allocator(numa_policy policy,
+                                 std::size_t threshold = kHugePageSize)
+        : state_(std::make_shared<HugePageState>(policy, threshold)) {}
+
+    template <class U>
+    huge_page_allocator(const huge_page_allocator<U>& x) noexcept
+        : state_(x.state_) {}
+
+    T* allocate(size_type n);
+    void deallocate(T* p, size_type n) noexcept;
+
+    page_backing last_backing() const noexcept {
+        return state_->last_backing.load(std::memory_order_relaxed);
+    }
+
+    /** Whether mbind succeeded for the last large allocation.
+        Fails e.g. without CAP_SYS_NICE in a container, or for a missing node.
+     */
+    bool last_numa_applied() const noexcept {
+        return state_->last_numa_applied.load(std::memory_order_relaxed);
+    }
+
+    /** Bytes currently allocated with the given backing.
+     */
+    std::size_t bytes(page_backing backing) const noexcept {
+        return state_->bytes[static_cast<int>(backing)].load(
+            std::memory_order_relaxed);
+    }
+
+    template <class U>
+    bool operator==(const huge_page_allocator<U>& x) const noexcept {
+        return state_ == x.state_;
+    }
+
+    template <class U>
+    bool operator!=(const huge_page_allocator<U>& x) const noexcept {
+        return !(*this == x);
+    }
+
+   private:
+    template <class U>
+    friend class huge_page_allocator;
+
+    std::shared_ptr<HugePageState> state_;
+
+    static std::size_t round_up_(std::size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    }
+
+    void* map_(std::size_t length, page_backing& backing) noexcept;
+    bool apply_numa_(void* p, std::size_t length) noexcept;
+    void record_(page_backing backing, std::size_t bytes) noexcept;
+};
+
+template <class T>
+T* huge_page_allocator<T>::allocate(size_type n) {
+    if (n > std::size_t(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    std::size_t bytes = n * sizeof(T);
+    if (bytes < state_->threshold) {
+        void* p = ::operator new(bytes, std::align_val_t(alignof(T)));
+        record_(page_backing::heap, bytes);
+        return static_cast<T*>(p);
+    }
+    std::size_t length = round_up_(bytes);
+    page_backing backing = page_backing::none;
+    void* p = map_(length, backing);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    state_->last_numa_applied.store(apply_numa_(p, length),
+                                    std::memory_order_relaxed);
+    try {
+        std::lock_guard<std::mutex> guard(state_->mappings_mutex);
+        state_->mappings.emplace(p, backing);
+    } catch (...) {
+        ::munmap(p, length);
+        throw;
+    }
+    record_(backing, length);
+    return static_cast<T*>(p);
+}
+
+template <class T>
+void huge_page_allocator<T>::deallocate(T* p, size_type n) noexcept {
+    // The path is a function of the size alone, as in allocate().
+    std::size_t bytes = n * sizeof(T);
+    if (bytes < state_->threshold) {
+        ::operator delete(p, std::align_val_t(alignof(T)));
+        state_->bytes[static_cast<int>(page_backing::heap)].fetch_sub(
+            bytes, std::memory_order_relaxed);
+        return;
+    }
+    std::size_t length = round_up_(bytes);
+    page_backing backing = page_backing::normal_pages;
+    {
+        std::lock_guard<std::mutex> guard(state_->mappings_mutex);
+        auto it = state_->mappings.find(p);
+        if (it != state_->mappings.end()) {
+            backing = it->second;
+            state_->mappings.erase(it);
+        }
+    }
+    ::munmap(p, length);
+    state_->bytes[static_cast<int>(backing)].fetch_sub(
+        length, std::memory_order_relaxed);
+}
+
+// private methods
+
+template <class T>
+void* huge_page_allocator<T>::map_(std::size_t length,
+                                   page_backing& backing) noexcept {
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* p = nullptr;
+
+#if defined(MAP_HUGETLB)
+    // 1. explicit huge pages, needs pages reserved in vm.nr_hugepages.
+    int huge_flags = flags | MAP_HUGETLB;
+#if defined(MAP_HUGE_SHIFT)
+    huge_flags |= 21 << MAP_HUGE_SHIFT;
+#endif
+    p = ::mmap(nullptr, length, prot, huge_flags, -1, 0);
+    if (p != MAP_FAILED) {
+        backing = page_backing::huge_tlb;
+        return p;
+    }
+#endif
+
+    // 2. base pages, aligned to 2 MB so that THP can back the whole range.
+    std::size_t padded = length + kHugePageSize;
+    void* raw = ::mmap(nullptr, padded, prot, flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    auto addr = reinterpret_cast<std::uintptr_t>(raw);
+    auto aligned = (addr + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    std::size_t head = aligned - addr;
+    std::size_t tail = padded - head - length;
+    if (head != 0) {
+        ::munmap(raw, head);
+    }
+    if (tail != 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    p = reinterpret_cast<void*>(aligned);
+
+#if defined(MADV_HUGEPAGE)
+    // 3. fails when THP is disabled ("never") or not built in.
+    if (::madvise(p, length, MADV_HUGEPAGE) == 0) {
+        backing = page_backing::transparent_huge;
+        return p;
+    }
+#endif
+    backing = page_backing::normal_pages;
+    return p;
+}
+
+template <class T>
+bool huge_page_allocator<T>::apply_numa_(void* p,
+                                         std::size_t length) noexcept {
+    const numa_policy& policy = state_->policy;
+    if (policy.mode == numa_policy::kind::local) {
+        return true;
+    }
+#if defined(SYS_mbind)
+    int mode = policy.mode == numa_policy::kind::bind ? MPOL_BIND
+                                                      : MPOL_INTERLEAVE;
+    unsigned long mask = policy.nodemask;
+    // maxnode counts bits, and the kernel ignores the last one.
+    long rc = ::syscall(SYS_mbind, p, length, mode, &mask,
+                        sizeof(mask) * 8 + 1, 0);
+    return rc == 0;
+#else
+    return false;
+#endif
+}
+
+template <class T>
+void huge_page_allocator<T>::record_(page_backing backing,
+                                     std::size_t bytes) noexcept {
+    state_->last_backing.store(backing, std::memory_order_relaxed);
+    state_->bytes[static_cast<int>(backing)].fetch_add(
+        bytes, std::memory_order_relaxed);
+}
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
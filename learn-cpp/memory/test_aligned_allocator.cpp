@@ -0,0 +1,87 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "../utility/cache_padded.hpp"
+#include "aligned_allocator.hpp"
+
+using learn_cpp::detail::aligned_allocator;
+using learn_cpp::detail::cache_padded;
+using learn_cpp::detail::kCacheLineSize;
+using learn_cpp::detail::v1::vector;
+
+bool is_aligned(const void* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+struct alignas(128) OverAligned {
+    int value = 0;
+};
+
+void test_aligned_allocator_1();
+void test_aligned_allocator_2();
+void test_cache_padded_1();
+
+int main() {
+    test_aligned_allocator_1();
+    test_aligned_allocator_2();
+    test_cache_padded_1();
+}
+
+// 64-byte aligned float buffers, also after reallocation
+void test_aligned_allocator_1() {
+    vector<float, aligned_allocator<float, 64>> vec1(3);
+    assert(is_aligned(vec1.data(), 64));
+    for (int i = 0; i < 1000; ++i) {
+        vec1.push_back(static_cast<float>(i));
+        assert(is_aligned(vec1.data(), 64));
+    }
+
+    using Rebound = std::allocator_traits<
+        aligned_allocator<float, 64>>::rebind_alloc<double>;
+    static_assert(std::is_same<Rebound, aligned_allocator<double, 64>>::value,
+                  "rebind keeps the alignment");
+    assert(aligned_allocator<float>() == aligned_allocator<double>());
+}
+
+// over-aligned T, with the default allocator and with aligned_allocator
+void test_aligned_allocator_2() {
+    static_assert(aligned_allocator<OverAligned, 16>::alignment == 128,
+                  "alignment is raised to alignof(T)");
+
+    vector<OverAligned> vec1(5);
+    for (int i = 0; i < 100; ++i) {
+        vec1.emplace_back();
+        assert(is_aligned(vec1.data(), alignof(OverAligned)));
+    }
+
+    vector<OverAligned, aligned_allocator<OverAligned, 16>> vec2(5);
+    for (int i = 0; i < 100; ++i) {
+        vec2.emplace_back();
+        assert(is_aligned(vec2.data(), alignof(OverAligned)));
+    }
+}
+
+void test_cache_padded_1() {
+    static_assert(sizeof(cache_padded<int>) == kCacheLineSize, "");
+    static_assert(alignof(cache_padded<int>) == kCacheLineSize, "");
+
+    cache_padded<std::atomic<int>> counter1(5);
+    ++*counter1;
+    assert(counter1->load() == 6);
+
+    cache_padded<int> value1(1);
+    auto value2 = value1;
+    assert(*value2 == 1);
+
+    vector<cache_padded<std::int64_t>> counters(4);
+    for (std::size_t i = 0; i + 1 < counters.size(); ++i) {
+        auto distance = reinterpret_cast<const char*>(&*counters[i + 1]) -
+                        reinterpret_cast<const char*>(&*counters[i]);
+        assert(distance == static_cast<std::ptrdiff_t>(kCacheLineSize));
+    }
+}
@@ -0,0 +1,97 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "huge_page_allocator.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+using learn_cpp::detail::backing_name;
+using learn_cpp::detail::huge_page_allocator;
+using learn_cpp::detail::numa_policy;
+using learn_cpp::detail::page_backing;
+
+void test_huge_page_allocator_1();
+void test_huge_page_allocator_2();
+
+int main() {
+    test_huge_page_allocator_1();
+    test_huge_page_allocator_2();
+}
+
+// small and large allocations take different paths
+void test_huge_page_allocator_1() {
+    huge_page_allocator<int> alloc;
+    assert(alloc.last_backing() == page_backing::none);
+
+    int* small = alloc.allocate(16);
+    assert(alloc.last_backing() == page_backing::heap);
+    assert(alloc.bytes(page_backing::heap) == 16 * sizeof(int));
+    alloc.deallocate(small, 16);
+    assert(alloc.bytes(page_backing::heap) == 0);
+
+    // 3 MB, rounded up to 4 MB.
+    std::size_t n = (3 << 20) / sizeof(int);
+    int* large = alloc.allocate(n);
+    page_backing backing = alloc.last_backing();
+    SHOW(backing_name(backing));
+    assert(backing == page_backing::huge_tlb ||
+           backing == page_backing::transparent_huge ||
+           backing == page_backing::normal_pages);
+    assert(alloc.bytes(backing) == std::size_t(4) << 20);
+    assert(reinterpret_cast<std::uintptr_t>(large) % (2 << 20) == 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        large[i] = static_cast<int>(i);
+    }
+    assert(large[n - 1] == static_cast<int>(n - 1));
+
+    // a rebound copy shares the state.
+    huge_page_allocator<double> alloc2(alloc);
+    assert(alloc2 == alloc);
+    assert(alloc2.last_backing() == backing);
+
+    alloc.deallocate(large, n);
+    assert(alloc.bytes(backing) == 0);
+
+    // the heap path keeps an over-aligned T aligned.
+    struct alignas(256) Line {
+        char bytes[256];
+    };
+    huge_page_allocator<Line> alloc3;
+    Line* lines = alloc3.allocate(3);
+    assert(alloc3.last_backing() == page_backing::heap);
+    assert(reinterpret_cast<std::uintptr_t>(lines) % 256 == 0);
+    alloc3.deallocate(lines, 3);
+}
+
+// used as the Allocator of v1::vector, with a NUMA policy
+void test_huge_page_allocator_2() {
+    using learn_cpp::detail::v1::vector;
+
+    huge_page_allocator<std::int64_t> alloc(numa_policy::bind(0));
+    std::size_t n = std::size_t(1) << 20;  // 8 MB
+    vector<std::int64_t, huge_page_allocator<std::int64_t>> vec1(n, 1, alloc);
+    assert(vec1.size() == n);
+    assert(vec1[n - 1] == 1);
+
+    auto used = vec1.get_allocator();
+    assert(used == alloc);
+    assert(used.last_backing() != page_backing::heap);
+    SHOW(backing_name(used.last_backing()));
+    // mbind is refused in some containers, the memory is usable anyway.
+    SHOW(used.last_numa_applied());
+
+    vec1.push_back(2);
+    assert(vec1[n] == 2);
+
+    bool thrown = false;
+    try {
+        numa_policy::bind(64);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
@@ -0,0 +1,113 @@
+#include <unistd.h>
+
+#include <cassert>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#define LEARN_CPP_TRACK_SHARED_PTR
+#include "../implement-std-library/c++11/shared_ptr.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "tracking_allocator.hpp"
+
+namespace allocation_stats = learn_cpp::detail::allocation_stats;
+using learn_cpp::detail::AllocationReport;
+using learn_cpp::detail::tracking_allocator;
+
+template <class T>
+using TrackedVector =
+    learn_cpp::detail::v1::vector<T, tracking_allocator<T>>;
+
+void test_tracking_allocator_1();
+void test_tracking_allocator_2();
+void test_tracking_allocator_3();
+
+int main() {
+    test_tracking_allocator_1();
+    test_tracking_allocator_2();
+    test_tracking_allocator_3();
+}
+
+// v1::vector growth: allocations, reallocations and relocated bytes
+void test_tracking_allocator_1() {
+    AllocationReport before = allocation_stats::collect();
+    {
+        TrackedVector<int> vec1;
+        for (int i = 0; i < 1024; ++i) {
+            vec1.push_back(i);
+        }
+        // capacities 1, 2, 4, ..., 1024
+        AllocationReport during = allocation_stats::collect();
+        assert(during.allocations - before.allocations == 11);
+        assert(during.reallocations - before.reallocations == 10);
+        // 1 + 2 + ... + 512 elements were moved
+        assert(during.bytes_relocated - before.bytes_relocated ==
+               1023 * sizeof(int));
+        assert(during.live_bytes - before.live_bytes == 1024 * sizeof(int));
+        // 2^12 bytes land in the bucket of [2^12, 2^13)
+        assert(during.histogram[13] - before.histogram[13] == 1);
+    }
+    AllocationReport after = allocation_stats::collect();
+    assert(after.deallocations - before.deallocations == 11);
+    assert(after.live_bytes == before.live_bytes);
+}
+
+// counters of other threads are summed, also after the thread ended
+void test_tracking_allocator_2() {
+    AllocationReport before = allocation_stats::collect();
+    std::thread t([]() {
+        TrackedVector<std::string> vec1(4);
+        vec1.reserve(100);
+    });
+    t.join();
+    AllocationReport after = allocation_stats::collect();
+    assert(after.threads >= before.threads + 1);
+    assert(after.allocations - before.allocations == 2);
+    assert(after.reallocations - before.reallocations == 1);
+    assert(after.live_bytes == before.live_bytes);
+
+    // allocated on one thread, freed on another: live and peak stay exact
+    before = allocation_stats::collect();
+    tracking_allocator<char> alloc;
+    char* block = nullptr;
+    std::thread producer(
+        [&alloc, &block]() { block = alloc.allocate(1 << 20); });
+    producer.join();
+    alloc.deallocate(block, 1 << 20);
+    after = allocation_stats::collect();
+    assert(after.live_bytes == before.live_bytes);
+    assert(after.peak_live_bytes >= before.live_bytes + (1 << 20));
+    assert(after.peak_live_bytes >= after.live_bytes);
+
+    // SharedPtr control blocks
+    using learn_cpp::detail::SharedCountCntrl;
+    using learn_cpp::detail::SharedPtr;
+    before = allocation_stats::collect();
+    {
+        SharedPtr<int> sp1(new int(1));
+        auto sp2 = sp1;
+    }
+    after = allocation_stats::collect();
+    assert(after.allocations - before.allocations == 1);
+    assert(after.bytes_allocated - before.bytes_allocated ==
+           sizeof(SharedCountCntrl<int>));
+    assert(after.deallocations - before.deallocations == 1);
+}
+
+// the report is dumped on a signal
+void test_tracking_allocator_3() {
+    int fds[2];
+    assert(::pipe(fds) == 0);
+    assert(allocation_stats::install_signal_handler(SIGUSR1, fds[1]));
+    std::raise(SIGUSR1);
+    char buf[4096] = {};
+    ssize_t n = ::read(fds[0], buf, sizeof(buf) - 1);
+    assert(n > 0);
+    std::cout << buf;
+    assert(std::strstr(buf, "allocation report") != nullptr);
+    assert(std::strstr(buf, "reallocations") != nullptr);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
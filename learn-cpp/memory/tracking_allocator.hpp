@@ -0,0 +1,95 @@
+#ifndef LEARN_CPP_MEMORY_TRACKING_ALLOCATOR_HPP
+#define LEARN_CPP_MEMORY_TRACKING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+#include "allocation_stats.hpp"
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   Wraps any allocator Inner and records every allocation in the
+   thread-local counters of allocation_stats.hpp.
+
+   Containers that know about it (v1::vector) also report each reallocation
+   and the bytes they relocated through on_reallocate().
+ */
+template <class T, class Inner = std::allocator<T>>
+class tracking_allocator {
+    using inner_traits = std::allocator_traits<Inner>;
+
+   public:
+    using value_type = T;
+    using size_type = typename inner_traits::size_type;
+    using difference_type = typename inner_traits::difference_type;
+    using pointer = typename inner_traits::pointer;
+    using const_pointer = typename inner_traits::const_pointer;
+    using propagate_on_container_copy_assignment =
+        typename inner_traits::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment =
+        typename inner_traits::propagate_on_container_move_assignment;
+    using propagate_on_container_swap =
+        typename inner_traits::propagate_on_container_swap;
+
+    template <class U>
+    struct rebind {
+        using other =
+            tracking_allocator<U,
+                               typename inner_traits::template rebind_alloc<U>>;
+    };
+
+    tracking_allocator() = default;
+
+    explicit tracking_allocator(const Inner& inner) : inner_(inner) {}
+
+    template <class U, class InnerU>
+    tracking_allocator(const tracking_allocator<U, InnerU>& x)
+        : inner_(x.inner()) {}
+
+    pointer allocate(size_type n) {
+        pointer p = inner_traits::allocate(inner_, n);
+        allocation_stats::record_allocate(n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(pointer p, size_type n) noexcept {
+        allocation_stats::record_deallocate(n * sizeof(T));
+        inner_traits::deallocate(inner_, p, n);
+    }
+
+    /** Called by a container after it moved its elements to a new buffer.
+     */
+    void on_reallocate(std::size_t relocated_bytes) noexcept {
+        allocation_stats::record_reallocate(relocated_bytes);
+    }
+
+    tracking_allocator select_on_container_copy_construction() const {
+        return tracking_allocator(
+            inner_traits::select_on_container_copy_construction(inner_));
+    }
+
+    const Inner& inner() const noexcept { return inner_; }
+
+   private:
+    Inner inner_;
+};
+
+template <class T, class InnerT, class U, class InnerU>
+bool operator==(const tracking_allocator<T, InnerT>& x,
+                const tracking_allocator<U, InnerU>& y) {
+    return x.inner() == y.inner();
+}
+
+template <class T, class InnerT, class U, class InnerU>
+bool operator!=(const tracking_allocator<T, InnerT>& x,
+                const tracking_allocator<U, InnerU>& y) {
+    return !(x == y);
+}
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
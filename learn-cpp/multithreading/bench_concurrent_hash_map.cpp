@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "concurrent_hash_map.hpp"
+
+/**
+ * concurrent_hash_map: one shard (a global lock) vs 64 shards, Spinlock vs
+ * std::mutex, for a read-heavy and a write-heavy mix; and batched lookups.
+ *
+ * Usage: bench_concurrent_hash_map.out [operations] [max_threads]
+ *                                      [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::concurrent_hash_map;
+using learn_cpp::detail::do_not_optimize;
+
+constexpr std::uint64_t kKeys = 1 << 16;
+
+// xorshift, one per thread
+struct Rng {
+    std::uint64_t state;
+    std::uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+template <class Map>
+void bench_mix(BenchmarkRunner& runner, const std::string& name,
+               std::size_t shards, unsigned write_percent, std::size_t n,
+               unsigned threads) {
+    Map map(shards);
+    for (std::uint64_t k = 0; k < kKeys; k += 2) {
+        map.insert(k, k);
+    }
+    runner
+        .run_parallel(
+            name + "/writes_" + std::to_string(write_percent) + "%/" +
+                std::to_string(threads),
+            [&map, write_percent, n, threads]() {
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([&map, write_percent, n, threads,
+                                          t]() {
+                        Rng rng{t * 7919 + 1};
+                        std::uint64_t value = 0;
+                        for (std::size_t i = 0; i < n / threads; ++i) {
+                            std::uint64_t r = rng.next();
+                            std::uint64_t key = r % kKeys;
+                            if ((r >> 32) % 100 < write_percent) {
+                                map.insert_or_assign(key, r);
+                            } else {
+                                map.find(key, value);
+                            }
+                        }
+                        do_not_optimize(value);
+                    });
+                }
+                for (auto& w : workers) {
+                    w.join();
+                }
+            })
+        .set_items(n);
+}
+
+void bench_find_many(BenchmarkRunner& runner, std::size_t n) {
+    concurrent_hash_map<std::uint64_t, std::uint64_t> map;
+    for (std::uint64_t k = 0; k < kKeys; ++k) {
+        map.insert(k, k);
+    }
+    const std::size_t batch = 256;
+    std::vector<std::uint64_t> keys(batch);
+    Rng rng{42};
+    for (auto& k : keys) {
+        k = rng.next() % kKeys;
+    }
+    std::vector<std::uint64_t> values(batch);
+    std::unique_ptr<bool[]> found(new bool[batch]);
+    runner
+        .run("64_shards/find",
+             [&]() {
+                 for (std::size_t i = 0; i < n / batch; ++i) {
+                     for (std::size_t j = 0; j < batch; ++j) {
+                         map.find(keys[j], values[j]);
+                     }
+                 }
+                 do_not_optimize(values.data());
+             })
+        .set_items(n / batch * batch);
+    runner
+        .run("64_shards/find_many(256)",
+             [&]() {
+                 for (std::size_t i = 0; i < n / batch; ++i) {
+                     map.find_many(keys.data(), batch, values.data(),
+                                   found.get());
+                 }
+                 do_not_optimize(values.data());
+             })
+        .set_items(n / batch * batch);
+}
+
+int main(int argc, char* argv[]) {
+    using SpinMap = concurrent_hash_map<std::uint64_t, std::uint64_t>;
+    using MutexMap =
+        concurrent_hash_map<std::uint64_t, std::uint64_t,
+                            std::hash<std::uint64_t>,
+                            std::equal_to<std::uint64_t>, std::mutex>;
+
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 2000000);
+    unsigned max_threads = static_cast<unsigned>(options.arg(1, 8));
+    BenchmarkRunner runner("concurrent_hash_map", options);
+
+    for (unsigned write_percent : {5u, 50u}) {
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            bench_mix<SpinMap>(runner, "1_shard+Spinlock", 1, write_percent,
+                               n, threads);
+            bench_mix<SpinMap>(runner, "64_shards+Spinlock", 64,
+                               write_percent, n, threads);
+            bench_mix<MutexMap>(runner, "64_shards+std::mutex", 64,
+                                write_percent, n, threads);
+        }
+    }
+    bench_find_many(runner, n);
+}
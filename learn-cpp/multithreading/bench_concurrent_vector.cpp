@@ -0,0 +1,69 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "concurrent_vector.hpp"
+#include "spinlock.hpp"
+
+/**
+ * Shared appends: concurrent_vector vs v1::vector behind a Spinlock, from 1
+ * to max_threads threads.
+ *
+ * Usage: bench_concurrent_vector.out [appends] [max_threads] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::concurrent_vector;
+using learn_cpp::detail::do_not_optimize;
+
+// what the callers did so far.
+struct LockedVector {
+    Spinlock lock_;
+    learn_cpp::detail::v1::vector<long> vec_;
+
+    void push_back(long x) {
+        lock_.Lock();
+        vec_.push_back(x);
+        lock_.Unlock();
+    }
+};
+
+template <class Vector>
+void bench_append(BenchmarkRunner& runner, const std::string& name,
+                  std::size_t n, unsigned threads) {
+    runner
+        .run_parallel(
+            name + "/append/" + std::to_string(threads),
+            [n, threads]() {
+                Vector vec;
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([&vec, n, threads, t]() {
+                        for (std::size_t i = t; i < n; i += threads) {
+                            vec.push_back(static_cast<long>(i));
+                        }
+                    });
+                }
+                for (auto& w : workers) {
+                    w.join();
+                }
+                do_not_optimize(vec);
+            })
+        .set_items(n);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    unsigned max_threads = static_cast<unsigned>(options.arg(1, 64));
+    BenchmarkRunner runner("concurrent_vector", options);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        bench_append<LockedVector>(runner, "Spinlock+v1::vector", n, threads);
+        bench_append<concurrent_vector<long>>(runner, "concurrent_vector", n,
+                                              threads);
+    }
+}
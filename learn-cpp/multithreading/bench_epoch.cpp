@@ -0,0 +1,120 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/shared_ptr.hpp"
+#include "epoch.hpp"
+
+/**
+ * Reading a shared object: pin an epoch vs copy a SharedPtr.
+ *
+ * Usage: bench_epoch.out [reads] [threads] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::EpochGuard;
+using learn_cpp::detail::SharedPtr;
+
+struct Config {
+    long value = 42;
+};
+
+// run fn(n / threads) on each thread.
+template <class Fn>
+void run_threads(unsigned threads, std::size_t n, Fn fn) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&fn, n, threads]() { fn(n / threads); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+void bench_epoch_read(BenchmarkRunner& runner, std::size_t n,
+                      unsigned threads) {
+    std::atomic<Config*> shared{new Config()};
+    runner
+        .run_parallel(
+            "EpochGuard/read/" + std::to_string(threads),
+            [n, threads, &shared]() {
+                run_threads(threads, n, [&shared](std::size_t reads) {
+                    long sum = 0;
+                    for (std::size_t i = 0; i < reads; ++i) {
+                        EpochGuard guard;
+                        sum += shared.load(std::memory_order_acquire)->value;
+                    }
+                    do_not_optimize(sum);
+                });
+            })
+        .set_items(n);
+    delete shared.load();
+}
+
+void bench_shared_ptr_read(BenchmarkRunner& runner, std::size_t n,
+                           unsigned threads) {
+    SharedPtr<Config> shared(new Config());
+    runner
+        .run_parallel(
+            "SharedPtr/read/" + std::to_string(threads),
+            [n, threads, &shared]() {
+                run_threads(threads, n, [&shared](std::size_t reads) {
+                    long sum = 0;
+                    for (std::size_t i = 0; i < reads; ++i) {
+                        SharedPtr<Config> copy(shared);
+                        sum += copy->value;
+                    }
+                    do_not_optimize(sum);
+                });
+            })
+        .set_items(n);
+}
+
+// readers while one thread keeps replacing the object.
+void bench_epoch_read_write(BenchmarkRunner& runner, std::size_t n,
+                            unsigned threads) {
+    std::atomic<Config*> shared{new Config()};
+    runner
+        .run_parallel(
+            "EpochGuard/read_with_writer/" + std::to_string(threads),
+            [n, threads, &shared]() {
+                std::atomic<bool> done{false};
+                std::thread writer([&shared, &done]() {
+                    while (!done.load(std::memory_order_relaxed)) {
+                        Config* old = shared.exchange(
+                            new Config(), std::memory_order_acq_rel);
+                        learn_cpp::detail::epoch::retire(old);
+                        std::this_thread::yield();
+                    }
+                });
+                run_threads(threads, n, [&shared](std::size_t reads) {
+                    long sum = 0;
+                    for (std::size_t i = 0; i < reads; ++i) {
+                        EpochGuard guard;
+                        sum += shared.load(std::memory_order_acquire)->value;
+                    }
+                    do_not_optimize(sum);
+                });
+                done.store(true);
+                writer.join();
+            })
+        .set_items(n);
+    learn_cpp::detail::epoch::retire(shared.load());
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 10000000);
+    unsigned max_threads = static_cast<unsigned>(options.arg(1, 4));
+    BenchmarkRunner runner("epoch", options);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        bench_epoch_read(runner, n, threads);
+        bench_shared_ptr_read(runner, n, threads);
+    }
+    bench_epoch_read_write(runner, n, max_threads);
+}
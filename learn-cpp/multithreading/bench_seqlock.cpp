@@ -0,0 +1,95 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "seqlock.hpp"
+#include "spinlock.hpp"
+
+/**
+ * Many readers and one slow writer of a small struct: Seqlock vs Spinlock.
+ *
+ * Usage: bench_seqlock.out [reads] [max_threads] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::Seqlock;
+
+struct Stats {
+    std::uint64_t timestamp;
+    std::uint64_t requests;
+    std::uint64_t errors;
+};
+
+struct SpinlockStats {
+    Spinlock lock_;
+    Stats stats_{};
+
+    Stats Load() {
+        lock_.Lock();
+        Stats copy = stats_;
+        lock_.Unlock();
+        return copy;
+    }
+    template <class Fn>
+    void Update(Fn fn) {
+        lock_.Lock();
+        fn(stats_);
+        lock_.Unlock();
+    }
+};
+
+template <class Shared>
+void bench_read(BenchmarkRunner& runner, const std::string& name,
+                std::size_t n, unsigned threads) {
+    runner
+        .run_parallel(
+            name + "/read/" + std::to_string(threads),
+            [n, threads]() {
+                Shared shared;
+                std::atomic<bool> done{false};
+                std::thread writer([&shared, &done]() {
+                    while (!done.load(std::memory_order_relaxed)) {
+                        shared.Update([](Stats& s) {
+                            ++s.timestamp;
+                            ++s.requests;
+                        });
+                        std::this_thread::sleep_for(
+                            std::chrono::microseconds(100));
+                    }
+                });
+                std::vector<std::thread> readers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    readers.emplace_back([&shared, n, threads]() {
+                        std::uint64_t sum = 0;
+                        for (std::size_t i = 0; i < n / threads; ++i) {
+                            sum += shared.Load().requests;
+                        }
+                        do_not_optimize(sum);
+                    });
+                }
+                for (auto& r : readers) {
+                    r.join();
+                }
+                done.store(true);
+                writer.join();
+            })
+        .set_items(n);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 10000000);
+    unsigned max_threads = static_cast<unsigned>(options.arg(1, 8));
+    BenchmarkRunner runner("seqlock", options);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        bench_read<SpinlockStats>(runner, "Spinlock", n, threads);
+        bench_read<Seqlock<Stats>>(runner, "Seqlock", n, threads);
+    }
+}
@@ -0,0 +1,74 @@
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "spinlock.hpp"
+
+/**
+ * Spinlock vs std::mutex, uncontended and contended.
+ *
+ * Usage: bench_spinlock.out [operations] [threads] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+
+template <class Lock>
+void bench_uncontended(BenchmarkRunner& runner, const std::string& name,
+                       std::size_t n) {
+    Lock lock;
+    long counter = 0;
+    runner
+        .run(name + "/uncontended",
+             [n, &lock, &counter]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     lock.lock();
+                     ++counter;
+                     lock.unlock();
+                 }
+                 do_not_optimize(counter);
+             })
+        .set_items(n);
+}
+
+template <class Lock>
+void bench_contended(BenchmarkRunner& runner, const std::string& name,
+                     std::size_t n, unsigned threads) {
+    Lock lock;
+    long counter = 0;
+    runner
+        .run_parallel(
+            name + "/contended/" + std::to_string(threads),
+            [n, threads, &lock, &counter]() {
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back([n, threads, &lock, &counter]() {
+                        for (std::size_t i = 0; i < n / threads; ++i) {
+                            lock.lock();
+                            ++counter;
+                            lock.unlock();
+                        }
+                    });
+                }
+                for (auto& w : workers) {
+                    w.join();
+                }
+                do_not_optimize(counter);
+            })
+        .set_items(n);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    unsigned threads = static_cast<unsigned>(options.arg(1, 4));
+    BenchmarkRunner runner("Spinlock", options);
+
+    bench_uncontended<std::mutex>(runner, "std::mutex", n);
+    bench_uncontended<Spinlock>(runner, "Spinlock", n);
+    bench_contended<std::mutex>(runner, "std::mutex", n, threads);
+    bench_contended<Spinlock>(runner, "Spinlock", n, threads);
+}
@@ -0,0 +1,258 @@
+#ifndef LEARN_CPP_MULTITHREADING_CONCURRENT_HASH_MAP_HPP
+#define LEARN_CPP_MULTITHREADING_CONCURRENT_HASH_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "../utility/cache_padded.hpp"
+#include "spinlock.hpp"
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   A hash map split into shards, each an unordered_map behind its own lock.
+
+   The shard of a key comes from the high bits of its (mixed) hash, the
+   unordered_map inside uses the low bits, so the two do not correlate.
+   Shards sit on their own cache lines, and each one rehashes on its own: a
+   hot shard growing blocks only the keys that hash to it.
+
+   Lock is anything Lockable: Spinlock by default, std::mutex when critical
+   sections can be long or threads outnumber cores.
+
+   insert_many() and find_many() group a batch by shard and take each
+   shard's lock once.
+ */
+template <class K, class V, class Hash = std::hash<K>,
+          class KeyEqual = std::equal_to<K>, class Lock = Spinlock>
+class concurrent_hash_map {
+    struct Shard {
+        mutable Lock lock;
+        std::unordered_map<K, V, Hash, KeyEqual> map;
+    };
+
+   public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using size_type = std::size_t;
+
+    static constexpr size_type kDefaultShards = 64;
+
+    /** shard_count is rounded up to a power of two.
+     */
+    explicit concurrent_hash_map(size_type shard_count = kDefaultShards,
+                                 const Hash& hash = Hash())
+        : hash_(hash) {
+        shard_bits_ = 0;
+        while ((size_type(1) << shard_bits_) < shard_count) {
+            ++shard_bits_;
+        }
+        shards_.reset(new cache_padded<Shard>[shard_count_()]);
+    }
+
+    // not copyable
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    /** Insert if the key is absent. Returns true if inserted.
+     */
+    bool insert(const K& key, const V& value) {
+        Shard& s = shard_for_(key);
+        std::lock_guard<Lock> guard(s.lock);
+        return s.map.emplace(key, value).second;
+    }
+
+    /** Insert or overwrite. Returns true if inserted.
+     */
+    bool insert_or_assign(const K& key, const V& value) {
+        Shard& s = shard_for_(key);
+        std::lock_guard<Lock> guard(s.lock);
+        auto result = s.map.emplace(key, value);
+        if (!result.second) {
+            result.first->second = value;
+        }
+        return result.second;
+    }
+
+    /** Copy the value of key to value. Returns false if absent.
+     */
+    bool find(const K& key, V& value) const {
+        const Shard& s = shard_for_(key);
+        std::lock_guard<Lock> guard(s.lock);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    bool contains(const K& key) const {
+        const Shard& s = shard_for_(key);
+        std::lock_guard<Lock> guard(s.lock);
+        return s.map.count(key) != 0;
+    }
+
+    /** Call fn(V&) on the value of key under the shard lock.
+        Returns false if absent.
+     */
+    template <class Fn>
+    bool update(const K& key, Fn fn) {
+        Shard& s = shard_for_(key);
+        std::lock_guard<Lock> guard(s.lock);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) {
+            return false;
+        }
+        fn(it->second);
+        return true;
+    }
+
+    bool erase(const K& key) {
+        Shard& s = shard_for_(key);
+        std::lock_guard<Lock> guard(s.lock);
+        return s.map.erase(key) != 0;
+    }
+
+    /** Insert items[0, n) that are absent. Returns the number inserted.
+        A batch of 2^32 items or more throws std::length_error.
+     */
+    size_type insert_many(const value_type* items, size_type n) {
+        v1::vector<std::uint32_t> order;
+        v1::vector<std::uint32_t> begin;
+        group_by_shard_(
+            n, [this, items](size_type i) { return shard_of_(items[i].first); },
+            order, begin);
+        size_type inserted = 0;
+        for (size_type k = 0; k < shard_count_(); ++k) {
+            if (begin[k] == begin[k + 1]) {
+                continue;
+            }
+            Shard& s = *shards_[k];
+            std::lock_guard<Lock> guard(s.lock);
+            for (auto j = begin[k]; j < begin[k + 1]; ++j) {
+                const value_type& item = items[order[j]];
+                inserted += s.map.emplace(item.first, item.second).second;
+            }
+        }
+        return inserted;
+    }
+
+    /** Look up keys[0, n): found[i] tells whether values[i] was set.
+        Returns the number found. n is limited as in insert_many().
+     */
+    size_type find_many(const K* keys, size_type n, V* values,
+                        bool* found) const {
+        v1::vector<std::uint32_t> order;
+        v1::vector<std::uint32_t> begin;
+        group_by_shard_(
+            n, [this, keys](size_type i) { return shard_of_(keys[i]); }, order,
+            begin);
+        size_type hits = 0;
+        for (size_type k = 0; k < shard_count_(); ++k) {
+            if (begin[k] == begin[k + 1]) {
+                continue;
+            }
+            const Shard& s = *shards_[k];
+            std::lock_guard<Lock> guard(s.lock);
+            for (auto j = begin[k]; j < begin[k + 1]; ++j) {
+                auto i = order[j];
+                auto it = s.map.find(keys[i]);
+                found[i] = it != s.map.end();
+                if (found[i]) {
+                    values[i] = it->second;
+                    ++hits;
+                }
+            }
+        }
+        return hits;
+    }
+
+    /** Sum of the shard sizes, each read under its lock; not a snapshot.
+     */
+    size_type size() const {
+        size_type n = 0;
+        for (size_type k = 0; k < shard_count_(); ++k) {
+            const Shard& s = *shards_[k];
+            std::lock_guard<Lock> guard(s.lock);
+            n += s.map.size();
+        }
+        return n;
+    }
+
+    size_type shard_count() const noexcept { return shard_count_(); }
+
+    /** Elements in shard k, for checking the distribution.
+     */
+    size_type shard_size(size_type k) const {
+        const Shard& s = *shards_[k];
+        std::lock_guard<Lock> guard(s.lock);
+        return s.map.size();
+    }
+
+   private:
+    std::unique_ptr<cache_padded<Shard>[]> shards_;
+    unsigned shard_bits_;
+    Hash hash_;
+
+    size_type shard_count_() const noexcept {
+        return size_type(1) << shard_bits_;
+    }
+
+    size_type shard_of_(const K& key) const {
+        if (shard_bits_ == 0) {
+            return 0;
+        }
+        // Fibonacci hashing: spread weak hashes (identity for integers)
+        // into the high bits.
+        std::uint64_t h =
+            static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_type>(h >> (64 - shard_bits_));
+    }
+
+    Shard& shard_for_(const K& key) { return *shards_[shard_of_(key)]; }
+
+    const Shard& shard_for_(const K& key) const {
+        return *shards_[shard_of_(key)];
+    }
+
+    // counting sort of [0, n) by shard: the indices of shard k are
+    // order[begin[k], begin[k + 1]). order and begin come in empty; 32 bit
+    // indices keep the scratch vectors small.
+    template <class ShardOf>
+    void group_by_shard_(size_type n, ShardOf shard_of,
+                         v1::vector<std::uint32_t>& order,
+                         v1::vector<std::uint32_t>& begin) const {
+        if (n >= UINT32_MAX) {
+            throw std::length_error("concurrent_hash_map: batch too large");
+        }
+        order.resize(n);
+        begin.resize(shard_count_() + 1);
+        v1::vector<std::uint32_t> shard(n);
+        for (size_type i = 0; i < n; ++i) {
+            shard[i] = static_cast<std::uint32_t>(shard_of(i));
+            ++begin[shard[i] + 1];
+        }
+        for (size_type k = 0; k < shard_count_(); ++k) {
+            begin[k + 1] += begin[k];
+        }
+        v1::vector<std::uint32_t> next(begin);
+        for (size_type i = 0; i < n; ++i) {
+            order[next[shard[i]]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
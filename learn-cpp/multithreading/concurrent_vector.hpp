@@ -0,0 +1,238 @@
+#ifndef LEARN_CPP_MULTITHREADING_CONCURRENT_VECTOR_HPP
+#define LEARN_CPP_MULTITHREADING_CONCURRENT_VECTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace learn_cpp {
+
+namespace detail {
+
+#if defined(DEBUG_CONCURRENT_VECTOR)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/**
+   An append-only vector that many threads can push_back into at once.
+
+   push_back reserves its index with one fetch_add, so writers never wait
+   for each other. Storage is a fixed table of segments of doubling size,
+   segment k holds kFirstSegment << k elements; a segment is allocated once
+   and never moved, so an element stays where it was constructed.
+
+   Every slot has a ready flag, set (release) after the element is
+   constructed. Readers only touch ready slots: for_each() and get() are safe
+   while writers append. Elements cannot be erased or modified through the
+   container while it is shared. If a constructor throws, its index stays a
+   hole that is never ready.
+ */
+template <class T, class Allocator = std::allocator<T>>
+class concurrent_vector {
+    struct slot_ {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::atomic<bool> ready{false};
+
+        T* get() noexcept { return reinterpret_cast<T*>(&storage); }
+        const T* get() const noexcept {
+            return reinterpret_cast<const T*>(&storage);
+        }
+    };
+
+    using slot_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<slot_>;
+    using slot_traits = std::allocator_traits<slot_allocator>;
+
+   public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    static constexpr int kFirstSegmentShift = 3;
+    static constexpr size_type kFirstSegment = size_type(1)
+                                               << kFirstSegmentShift;
+    static constexpr int kMaxSegments = 64 - kFirstSegmentShift;
+
+    concurrent_vector() = default;
+
+    explicit concurrent_vector(const Allocator& a) : alloc_(a) {}
+
+    // not copyable
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    ~concurrent_vector() { clear_(); }
+
+    /** Append, returns the index of the new element.
+     */
+    template <class... Args>
+    size_type emplace_back(Args&&... args) {
+        size_type i = size_.fetch_add(1, std::memory_order_relaxed);
+        int k = segment_of_(i);
+        slot_* segment = get_segment_(k);
+        if (i == segment_base_(k) && k + 1 < kMaxSegments) {
+            // the first writer of a segment prepares the next one, so it
+            // is usually ready before anyone needs it.
+            get_segment_(k + 1);
+        }
+        slot_& s = segment[i - segment_base_(k)];
+        ::new (static_cast<void*>(&s.storage)) T(std::forward<Args>(args)...);
+        s.ready.store(true, std::memory_order_release);
+        return i;
+    }
+
+    size_type push_back(const T& x) { return emplace_back(x); }
+
+    size_type push_back(T&& x) { return emplace_back(std::move(x)); }
+
+    /** Indices handed out so far, some may not be ready yet.
+     */
+    size_type size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /** Whether element i is constructed and visible to this thread.
+     */
+    bool ready(size_type i) const noexcept { return get(i) != nullptr; }
+
+    /** Element i, or nullptr if it is not ready.
+     */
+    const T* get(size_type i) const noexcept {
+        if (i >= size()) {
+            return nullptr;
+        }
+        int k = segment_of_(i);
+        const slot_* segment = segments_[k].load(std::memory_order_acquire);
+        if (segment == nullptr) {
+            return nullptr;
+        }
+        const slot_& s = segment[i - segment_base_(k)];
+        return s.ready.load(std::memory_order_acquire) ? s.get() : nullptr;
+    }
+
+    /** Element i, which must be ready.
+     */
+    const_reference operator[](size_type i) const {
+        const T* p = get(i);
+        ASSERT(p != nullptr, "element is not ready");
+        return *p;
+    }
+
+    /** Call fn(index, element) on the ready elements, in index order,
+        skipping the ones still being constructed.
+     */
+    template <class Fn>
+    void for_each(Fn fn) const {
+        size_type n = size();
+        for (int k = 0; k < kMaxSegments && segment_base_(k) < n; ++k) {
+            const slot_* segment = segments_[k].load(std::memory_order_acquire);
+            if (segment == nullptr) {
+                continue;
+            }
+            size_type base = segment_base_(k);
+            size_type end = std::min(n - base, segment_size_(k));
+            for (size_type j = 0; j < end; ++j) {
+                if (segment[j].ready.load(std::memory_order_acquire)) {
+                    fn(base + j, *segment[j].get());
+                }
+            }
+        }
+    }
+
+    /** Allocate the segments for n elements ahead of time.
+     */
+    void reserve(size_type n) {
+        for (int k = 0; k < kMaxSegments && segment_base_(k) < n; ++k) {
+            get_segment_(k);
+        }
+    }
+
+    size_type capacity() const noexcept {
+        size_type cap = 0;
+        for (int k = 0; k < kMaxSegments; ++k) {
+            if (segments_[k].load(std::memory_order_acquire) != nullptr) {
+                cap += segment_size_(k);
+            }
+        }
+        return cap;
+    }
+
+    /** Destroy everything. Not thread safe.
+     */
+    void clear() {
+        clear_();
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<slot_*> segments_[kMaxSegments] = {};
+    std::atomic<size_type> size_{0};
+    slot_allocator alloc_;
+
+    static size_type segment_size_(int k) noexcept {
+        return kFirstSegment << k;
+    }
+
+    static size_type segment_base_(int k) noexcept {
+        return (kFirstSegment << k) - kFirstSegment;
+    }
+
+    // i + kFirstSegment lies in [kFirstSegment << k, kFirstSegment << (k+1))
+    static int segment_of_(size_type i) noexcept {
+        return 63 - __builtin_clzll(i + kFirstSegment) - kFirstSegmentShift;
+    }
+
+    slot_* get_segment_(int k) {
+        slot_* segment = segments_[k].load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            return segment;
+        }
+        size_type n = segment_size_(k);
+        slot_* fresh = slot_traits::allocate(alloc_, n);
+        for (size_type j = 0; j < n; ++j) {
+            ::new (static_cast<void*>(fresh + j)) slot_();
+        }
+        // lost the race: another thread installed the segment first.
+        if (!segments_[k].compare_exchange_strong(segment, fresh,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+            slot_traits::deallocate(alloc_, fresh, n);
+            return segment;
+        }
+        return fresh;
+    }
+
+    void clear_() noexcept {
+        for (int k = 0; k < kMaxSegments; ++k) {
+            slot_* segment = segments_[k].load(std::memory_order_acquire);
+            if (segment == nullptr) {
+                continue;
+            }
+            size_type n = segment_size_(k);
+            for (size_type j = 0; j < n; ++j) {
+                if (segment[j].ready.load(std::memory_order_relaxed)) {
+                    segment[j].get()->~T();
+                }
+            }
+            slot_traits::deallocate(alloc_, segment, n);
+            segments_[k].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+};
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
@@ -0,0 +1,290 @@
+#ifndef LEARN_CPP_MULTITHREADING_EPOCH_HPP
+#define LEARN_CPP_MULTITHREADING_EPOCH_HPP
+
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace learn_cpp {
+namespace detail {
+
+/*
+   Epoch-based reclamation (EBR) for lock-free structures.
+
+   A reader pins the current global epoch with an EpochGuard for as long as
+   it holds pointers into a structure. A writer unlinks a node, then calls
+   epoch::retire(p, deleter) instead of freeing it. A node retired in epoch e
+   is freed once the global epoch reaches e + 2: the epoch only advances
+   when every pinned thread has seen the current one, so by then no reader
+   that could have seen the node is still pinned.
+
+   Pinning is a store to a thread-local record. The memory barrier it needs
+   is moved to the (rare) epoch advance with membarrier(2) where the kernel
+   supports it; otherwise the reader falls back to a seq_cst fence.
+
+   Every thread has three limbo lists, one per epoch modulo 3. They are freed
+   in batches, every kCollectEvery retires. Records are never freed, a thread
+   that exits leaves its record and limbo lists to be adopted by the next
+   collect() of any thread.
+ */
+
+struct RetiredPtr {
+    void* p;
+    void (*deleter)(void*);
+};
+
+struct alignas(64) EpochRecord {
+    // 0 when not pinned, (epoch << 1) | 1 when pinned.
+    std::atomic<std::uint64_t> state{0};
+    // set by the thread that owns the record, or by a collector adopting it.
+    std::atomic<bool> in_use{false};
+    std::atomic<std::uint64_t> retired{0};
+    std::atomic<std::uint64_t> reclaimed{0};
+    EpochRecord* next = nullptr;
+
+    // only touched by the holder of in_use.
+    unsigned nesting = 0;
+    unsigned retired_since_collect = 0;
+    std::vector<RetiredPtr> limbo[3];
+    std::uint64_t limbo_epoch[3] = {0, 0, 0};
+};
+
+struct EpochStats {
+    std::uint64_t epoch = 0;
+    std::uint64_t threads = 0;
+    std::uint64_t retired = 0;
+    std::uint64_t reclaimed = 0;
+};
+
+namespace epoch {
+
+constexpr unsigned kCollectEvery = 64;
+
+inline std::atomic<std::uint64_t>& global_epoch() {
+    static std::atomic<std::uint64_t> epoch{0};
+    return epoch;
+}
+
+inline std::atomic<EpochRecord*>& registry_head() {
+    static std::atomic<EpochRecord*> head{nullptr};
+    return head;
+}
+
+// whether membarrier(2) can stand in for the readers' fences.
+inline bool asymmetric_fences() {
+    static const bool registered =
+        ::syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED,
+                  0, 0) == 0;
+    return registered;
+}
+
+// on the read side, right after pinning.
+inline void light_fence() {
+    if (asymmetric_fences()) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+// on the advance side: a full fence on every running thread.
+inline void heavy_fence() {
+    if (!asymmetric_fences() ||
+        ::syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) !=
+            0) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+inline EpochRecord* acquire_record() {
+    auto& head = registry_head();
+    for (auto* r = head.load(std::memory_order_acquire); r != nullptr;
+         r = r->next) {
+        bool expected = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true,
+                                              std::memory_order_acquire)) {
+            return r;
+        }
+    }
+    auto* r = new EpochRecord();
+    r->in_use.store(true, std::memory_order_relaxed);
+    r->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(r->next, r, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+    return r;
+}
+
+inline void collect(EpochRecord& self);
+
+struct ThreadRecord {
+    EpochRecord* record = acquire_record();
+
+    ~ThreadRecord() {
+        collect(*record);
+        record->in_use.store(false, std::memory_order_release);
+    }
+};
+
+inline EpochRecord& local() {
+    thread_local ThreadRecord handle;
+    return *handle.record;
+}
+
+inline void enter() {
+    EpochRecord& r = local();
+    if (r.nesting++ == 0) {
+        std::uint64_t e = global_epoch().load(std::memory_order_relaxed);
+        r.state.store((e << 1) | 1, std::memory_order_relaxed);
+        light_fence();
+    }
+}
+
+inline void exit() {
+    EpochRecord& r = local();
+    if (--r.nesting == 0) {
+        r.state.store(0, std::memory_order_release);
+    }
+}
+
+/** Advance the global epoch if every pinned thread is in the current one.
+    Returns false if some thread lags behind.
+ */
+inline bool try_advance() {
+    std::uint64_t e = global_epoch().load(std::memory_order_relaxed);
+    heavy_fence();
+    for (auto* r = registry_head().load(std::memory_order_acquire);
+         r != nullptr; r = r->next) {
+        std::uint64_t s = r->state.load(std::memory_order_relaxed);
+        if ((s & 1) != 0 && (s >> 1) != e) {
+            return false;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    global_epoch().compare_exchange_strong(e, e + 1,
+                                           std::memory_order_acq_rel);
+    return true;
+}
+
+// free limbo list i of r as one batch.
+inline void free_list(EpochRecord& r, int i) {
+    std::vector<RetiredPtr> batch;
+    batch.swap(r.limbo[i]);
+    for (const auto& item : batch) {
+        item.deleter(item.p);
+    }
+    r.reclaimed.store(r.reclaimed.load(std::memory_order_relaxed) +
+                          batch.size(),
+                      std::memory_order_relaxed);
+    // keep the capacity for the next generation.
+    batch.clear();
+    if (r.limbo[i].empty()) {
+        r.limbo[i].swap(batch);
+    }
+}
+
+inline void free_expired(EpochRecord& r, std::uint64_t e) {
+    for (int i = 0; i < 3; ++i) {
+        if (!r.limbo[i].empty() && r.limbo_epoch[i] + 2 <= e) {
+            free_list(r, i);
+        }
+    }
+}
+
+/** Try to advance the epoch, then free what is safe to free: the lists of
+    self, and those of exited threads.
+ */
+inline void collect(EpochRecord& self) {
+    self.retired_since_collect = 0;
+    try_advance();
+    std::uint64_t e = global_epoch().load(std::memory_order_acquire);
+    free_expired(self, e);
+    for (auto* r = registry_head().load(std::memory_order_acquire);
+         r != nullptr; r = r->next) {
+        bool expected = false;
+        if (r != &self && !r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true,
+                                              std::memory_order_acquire)) {
+            free_expired(*r, e);
+            r->in_use.store(false, std::memory_order_release);
+        }
+    }
+}
+
+inline void collect() { collect(local()); }
+
+/** Free p with deleter(p) once no pinned thread can still see it.
+    p must already be unreachable for new readers.
+ */
+inline void retire(void* p, void (*deleter)(void*)) {
+    EpochRecord& r = local();
+    std::uint64_t e = global_epoch().load(std::memory_order_seq_cst);
+    int i = static_cast<int>(e % 3);
+    if (!r.limbo[i].empty() && r.limbo_epoch[i] != e) {
+        // from epoch e - 3 or older, already safe.
+        free_list(r, i);
+    }
+    r.limbo[i].push_back(RetiredPtr{p, deleter});
+    r.limbo_epoch[i] = e;
+    r.retired.store(r.retired.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    if (++r.retired_since_collect >= kCollectEvery) {
+        collect(r);
+    }
+}
+
+template <class T>
+void retire(T* p) {
+    retire(p, [](void* q) { delete static_cast<T*>(q); });
+}
+
+/** Retired pointers of this thread not freed yet.
+ */
+inline std::size_t pending() {
+    EpochRecord& r = local();
+    return r.limbo[0].size() + r.limbo[1].size() + r.limbo[2].size();
+}
+
+inline EpochStats stats() {
+    EpochStats s;
+    s.epoch = global_epoch().load(std::memory_order_relaxed);
+    for (auto* r = registry_head().load(std::memory_order_acquire);
+         r != nullptr; r = r->next) {
+        ++s.threads;
+        s.retired += r->retired.load(std::memory_order_relaxed);
+        s.reclaimed += r->reclaimed.load(std::memory_order_relaxed);
+    }
+    return s;
+}
+
+}  // namespace epoch
+
+/**
+   Pins the current epoch while in scope. Guards nest.
+
+       {
+           EpochGuard guard;
+           Node* node = head.load(std::memory_order_acquire);
+           // node is not freed before guard goes out of scope
+       }
+ */
+class EpochGuard {
+   public:
+    EpochGuard() { epoch::enter(); }
+    ~EpochGuard() { epoch::exit(); }
+
+    // not copyable
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
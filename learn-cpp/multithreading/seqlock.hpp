@@ -0,0 +1,138 @@
+#ifndef LEARN_CPP_MULTITHREADING_SEQLOCK_HPP
+#define LEARN_CPP_MULTITHREADING_SEQLOCK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   A sequence lock around a small trivially copyable T.
+
+   A writer makes the sequence odd, writes, and makes it even again. A
+   reader copies the data between two reads of the sequence and retries if
+   they differ or are odd; it never writes shared memory, so readers do not
+   slow each other down. Writers are serialized by a CAS on the sequence.
+
+   The data is kept in relaxed atomic words, so a torn read is a retry and
+   not a data race. The fences follow Boehm, "Can Seqlocks Get Along With
+   Programming Language Memory Models?" (2012).
+ */
+template <class T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Seqlock copies T as raw bytes");
+
+    static constexpr std::size_t kWords =
+        (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+   public:
+    Seqlock() : Seqlock(T()) {}
+
+    explicit Seqlock(const T& value) { write_words_(value); }
+
+    // not copyable
+    Seqlock(const Seqlock&) = delete;
+    Seqlock& operator=(const Seqlock&) = delete;
+
+    /** A consistent copy of the value.
+     */
+    T Load() const {
+        std::uint64_t buf[kWords];
+        for (unsigned spins = 0;; ++spins) {
+            std::uint64_t s1 = seq_.load(std::memory_order_acquire);
+            if ((s1 & 1) == 0) {
+                for (std::size_t i = 0; i < kWords; ++i) {
+                    buf[i] = words_[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (seq_.load(std::memory_order_relaxed) == s1) {
+                    break;
+                }
+            }
+            backoff_(spins);
+        }
+        T value;
+        std::memcpy(static_cast<void*>(&value), buf, sizeof(T));
+        return value;
+    }
+
+    void Store(const T& value) {
+        std::uint64_t s = lock_();
+        write_words_(value);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    /** Read-modify-write under the write lock: fn(T&).
+     */
+    template <class Fn>
+    void Update(Fn fn) {
+        std::uint64_t s = lock_();
+        T value;
+        std::uint64_t buf[kWords];
+        for (std::size_t i = 0; i < kWords; ++i) {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(static_cast<void*>(&value), buf, sizeof(T));
+        fn(value);
+        write_words_(value);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    /** Even when no write is in progress; grows by 2 per write.
+     */
+    std::uint64_t Sequence() const {
+        return seq_.load(std::memory_order_acquire);
+    }
+
+   private:
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> words_[kWords];
+
+    // make the sequence odd, returns the even value it had.
+    std::uint64_t lock_() {
+        for (unsigned spins = 0;; ++spins) {
+            std::uint64_t s = seq_.load(std::memory_order_relaxed);
+            if ((s & 1) == 0 &&
+                seq_.compare_exchange_weak(s, s + 1,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+                // acquire: see the data of the previous writer.
+                // release fence: our data stores may not move above the
+                // odd sequence.
+                std::atomic_thread_fence(std::memory_order_release);
+                return s;
+            }
+            backoff_(spins);
+        }
+    }
+
+    void write_words_(const T& value) {
+        std::uint64_t buf[kWords] = {};
+        std::memcpy(buf, static_cast<const void*>(&value), sizeof(T));
+        for (std::size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+    }
+
+    // a writer may be descheduled in the middle of a write.
+    static void backoff_(unsigned spins) {
+        if (spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
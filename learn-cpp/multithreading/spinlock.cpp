@@ -2,16 +2,27 @@
 
 #include <atomic>
 
+#include "../utility/trace.hpp"
+
 Spinlock::Spinlock() {}
 
 Spinlock::~Spinlock() {}
 
 void Spinlock::Lock() {
+    if (flag_.test_and_set() == false) {
+        return;
+    }
+    // only the waits are traced
+    LEARN_CPP_TRACE_SCOPE("Spinlock::Lock wait");
     while (flag_.test_and_set() == true) {
         // busy looping
     }
 }
 
+bool Spinlock::TryLock() {
+    return flag_.test_and_set() == false;
+}
+
 void Spinlock::Unlock() {
     flag_.clear();
 }
@@ -21,6 +21,13 @@ class Spinlock {
 
     void Lock();
     void Unlock();
+    // true if the lock was taken.
+    bool TryLock();
+
+    // Lockable, so std::lock_guard and lock-parameterized code accept it.
+    void lock() { Lock(); }
+    void unlock() { Unlock(); }
+    bool try_lock() { return TryLock(); }
 
    private:
     std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
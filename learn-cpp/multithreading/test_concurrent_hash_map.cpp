@@ -0,0 +1,115 @@
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrent_hash_map.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_concurrent_hash_map_1();
+void test_concurrent_hash_map_2();
+void test_concurrent_hash_map_3();
+
+int main() {
+    test_concurrent_hash_map_1();
+    test_concurrent_hash_map_2();
+    test_concurrent_hash_map_3();
+}
+
+void test_concurrent_hash_map_1() {
+    using learn_cpp::detail::concurrent_hash_map;
+
+    concurrent_hash_map<std::string, int> map1(10);
+    assert(map1.shard_count() == 16);
+    assert(map1.insert("a", 1));
+    assert(!map1.insert("a", 2));
+    assert(!map1.insert_or_assign("a", 3));
+    int value = 0;
+    assert(map1.find("a", value) && value == 3);
+    assert(!map1.find("b", value));
+    assert(map1.update("a", [](int& v) { v += 10; }));
+    assert(map1.find("a", value) && value == 13);
+    assert(!map1.update("b", [](int&) {}));
+    assert(map1.contains("a") && !map1.contains("b"));
+    assert(map1.erase("a") && !map1.erase("a"));
+    assert(map1.size() == 0);
+
+    // integer keys (identity hash) still spread over the shards
+    concurrent_hash_map<int, int> map2;
+    for (int i = 0; i < 6400; ++i) {
+        map2.insert(i, i);
+    }
+    for (std::size_t k = 0; k < map2.shard_count(); ++k) {
+        assert(map2.shard_size(k) > 50 && map2.shard_size(k) < 150);
+    }
+}
+
+// batches
+void test_concurrent_hash_map_2() {
+    using learn_cpp::detail::concurrent_hash_map;
+
+    concurrent_hash_map<int, long> map1(8);
+    std::vector<std::pair<int, long>> items;
+    for (int i = 0; i < 1000; ++i) {
+        items.emplace_back(i, i * 10L);
+    }
+    assert(map1.insert_many(items.data(), items.size()) == 1000);
+    assert(map1.insert_many(items.data(), 10) == 0);
+    assert(map1.size() == 1000);
+
+    std::vector<int> keys = {5, 2000, 999, -1, 0};
+    long values[5] = {};
+    bool found[5] = {};
+    assert(map1.find_many(keys.data(), keys.size(), values, found) == 3);
+    assert(found[0] && values[0] == 50);
+    assert(!found[1] && !found[3]);
+    assert(found[2] && values[2] == 9990);
+    assert(found[4] && values[4] == 0);
+}
+// many writers, with both lock types
+template <class Map>
+void hammer(Map& map1) {
+    const int threads = 4;
+    const int per_thread = 5000;
+    // shared counters, keys -1 to -100
+    for (int k = 1; k <= 100; ++k) {
+        map1.insert(-k, 0);
+    }
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&map1, t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                map1.insert(t * per_thread + i, i);
+                map1.update(-(i % 100 + 1), [](int& v) { ++v; });
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    assert(map1.size() == std::size_t(threads * per_thread + 100));
+    int value = 0;
+    assert(map1.find(per_thread + 7, value) && value == 7);
+    long total = 0;
+    for (int k = 1; k <= 100; ++k) {
+        assert(map1.find(-k, value));
+        total += value;
+    }
+    assert(total == threads * per_thread);
+}
+
+void test_concurrent_hash_map_3() {
+    using learn_cpp::detail::concurrent_hash_map;
+
+    concurrent_hash_map<int, int> map1;
+    hammer(map1);
+    concurrent_hash_map<int, int, std::hash<int>, std::equal_to<int>,
+                        std::mutex>
+        map2(4);
+    hammer(map2);
+}
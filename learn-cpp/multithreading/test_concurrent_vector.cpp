@@ -0,0 +1,90 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+void test_concurrent_vector_1();
+void test_concurrent_vector_2();
+
+int main() {
+    test_concurrent_vector_1();
+    test_concurrent_vector_2();
+}
+
+// one thread
+void test_concurrent_vector_1() {
+    using learn_cpp::detail::concurrent_vector;
+
+    concurrent_vector<std::string> vec1;
+    assert(vec1.empty() && vec1.get(0) == nullptr);
+    for (int i = 0; i < 100; ++i) {
+        assert(vec1.push_back(std::to_string(i)) == std::size_t(i));
+    }
+    assert(vec1.size() == 100);
+    // 8 + 16 + 32 + 64, and the next segment is prepared early
+    SHOW(vec1.capacity());
+    assert(vec1.capacity() == 248);
+    const std::string* p = vec1.get(7);
+    for (int i = 0; i < 100; ++i) {
+        assert(vec1[i] == std::to_string(i));
+    }
+    vec1.reserve(10000);
+    assert(vec1.capacity() >= 10000);
+    assert(vec1.get(7) == p);
+    assert(vec1.get(100) == nullptr);
+
+    int count = 0;
+    vec1.for_each([&count](std::size_t i, const std::string& item) {
+        assert(item == std::to_string(i));
+        ++count;
+    });
+    assert(count == 100);
+
+    vec1.clear();
+    assert(vec1.empty() && vec1.capacity() == 0);
+}
+
+// writers append while a reader walks the published elements
+void test_concurrent_vector_2() {
+    using learn_cpp::detail::concurrent_vector;
+
+    const int writers = 4;
+    const int per_writer = 20000;
+    concurrent_vector<long> vec1;
+    std::atomic<bool> done{false};
+
+    std::thread reader([&vec1, &done]() {
+        while (!done.load()) {
+            vec1.for_each([](std::size_t, long item) {
+                assert(item >= 0 && item < writers * per_writer);
+            });
+        }
+    });
+    std::vector<std::thread> threads;
+    for (int t = 0; t < writers; ++t) {
+        threads.emplace_back([&vec1, t]() {
+            for (int i = 0; i < per_writer; ++i) {
+                vec1.push_back(long(t) * per_writer + i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    done.store(true);
+    reader.join();
+
+    assert(vec1.size() == std::size_t(writers * per_writer));
+    std::vector<int> seen(writers * per_writer, 0);
+    vec1.for_each([&seen](std::size_t, long item) { ++seen[item]; });
+    for (int count : seen) {
+        assert(count == 1);
+    }
+}
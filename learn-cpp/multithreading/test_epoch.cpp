@@ -0,0 +1,160 @@
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "epoch.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+namespace epoch = learn_cpp::detail::epoch;
+using learn_cpp::detail::EpochGuard;
+
+void test_epoch_1();
+void test_epoch_2();
+void test_epoch_3();
+
+int main() {
+    SHOW(epoch::asymmetric_fences());
+    test_epoch_1();
+    test_epoch_2();
+    test_epoch_3();
+    SHOW(epoch::stats().epoch);
+}
+
+std::atomic<long> destroyed{0};
+
+struct Tracked {
+    long value;
+    explicit Tracked(long v) : value(v) {}
+    ~Tracked() {
+        value = -1;
+        ++destroyed;
+    }
+};
+
+// retired objects are freed after two epochs, in batches
+void test_epoch_1() {
+    long before = destroyed.load();
+    for (int i = 0; i < 10; ++i) {
+        epoch::retire(new Tracked(i));
+    }
+    assert(epoch::pending() == 10);
+    assert(destroyed.load() == before);
+    for (int i = 0; i < 3 && epoch::pending() != 0; ++i) {
+        epoch::collect();
+    }
+    assert(epoch::pending() == 0);
+    assert(destroyed.load() == before + 10);
+
+    // nested guards, retire while pinned
+    {
+        EpochGuard guard1;
+        EpochGuard guard2;
+        epoch::retire(new Tracked(1));
+        epoch::collect();
+        epoch::collect();
+        epoch::collect();
+        // this thread is pinned in an old epoch now.
+        assert(epoch::pending() == 1);
+    }
+    for (int i = 0; i < 3 && epoch::pending() != 0; ++i) {
+        epoch::collect();
+    }
+    assert(epoch::pending() == 0);
+}
+
+// a pinned reader holds back reclamation
+void test_epoch_2() {
+    std::atomic<int> stage{0};
+    long before = destroyed.load();
+    std::thread reader([&stage]() {
+        EpochGuard guard;
+        stage.store(1);
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+    epoch::retire(new Tracked(2));
+    for (int i = 0; i < 10; ++i) {
+        epoch::collect();
+    }
+    assert(destroyed.load() == before);
+    stage.store(2);
+    reader.join();
+    for (int i = 0; i < 3 && epoch::pending() != 0; ++i) {
+        epoch::collect();
+    }
+    assert(destroyed.load() == before + 1);
+}
+
+// Treiber stack: nodes popped by one thread may still be read by another.
+struct Node {
+    Tracked item;
+    Node* next;
+    explicit Node(long v) : item(v), next(nullptr) {}
+};
+
+void test_epoch_3() {
+    const int threads = 4;
+    const int per_thread = 20000;
+    std::atomic<Node*> head{nullptr};
+    std::atomic<long> popped{0};
+    long before = destroyed.load();
+
+    auto push = [&head](long v) {
+        Node* node = new Node(v);
+        node->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        }
+    };
+    auto pop = [&head]() {
+        EpochGuard guard;
+        Node* node = head.load(std::memory_order_acquire);
+        while (node != nullptr &&
+               !head.compare_exchange_weak(node, node->next,
+                                           std::memory_order_acquire)) {
+        }
+        if (node == nullptr) {
+            return false;
+        }
+        // freed nodes have value -1
+        assert(node->item.value >= 0);
+        epoch::retire(node);
+        return true;
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&push, &pop, &popped, t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                push(long(t) * per_thread + i);
+                if (pop()) {
+                    ++popped;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    while (pop()) {
+        ++popped;
+    }
+    assert(popped.load() == threads * per_thread);
+    // the exited threads' lists are adopted here
+    for (int i = 0; i < 3; ++i) {
+        epoch::collect();
+    }
+    SHOW(epoch::stats().threads);
+    assert(destroyed.load() - before == threads * per_thread);
+    auto stats = epoch::stats();
+    assert(stats.retired == stats.reclaimed);
+}
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "seqlock.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+// an odd size, not a multiple of 8
+struct Stamp {
+    std::uint64_t time;
+    std::uint32_t count;
+    std::uint32_t twice;
+    char tag;
+};
+
+void test_seqlock_1();
+void test_seqlock_2();
+
+int main() {
+    test_seqlock_1();
+    test_seqlock_2();
+}
+
+void test_seqlock_1() {
+    using learn_cpp::detail::Seqlock;
+
+    Seqlock<Stamp> lock1;
+    assert(lock1.Load().time == 0 && lock1.Sequence() == 0);
+    lock1.Store(Stamp{7, 1, 2, 'x'});
+    assert(lock1.Sequence() == 2);
+    Stamp s = lock1.Load();
+    assert(s.time == 7 && s.count == 1 && s.twice == 2 && s.tag == 'x');
+    lock1.Update([](Stamp& v) { ++v.count; });
+    assert(lock1.Load().count == 2 && lock1.Load().tag == 'x');
+
+    Seqlock<int> lock2(5);
+    assert(lock2.Load() == 5);
+}
+
+// readers never see a half-written value
+void test_seqlock_2() {
+    using learn_cpp::detail::Seqlock;
+
+    const int writers = 2;
+    const int per_writer = 20000;
+    Seqlock<Stamp> lock1;
+    std::atomic<bool> done{false};
+    std::atomic<long> reads{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&lock1, &done, &reads]() {
+            std::uint32_t last = 0;
+            while (!done.load()) {
+                Stamp s = lock1.Load();
+                assert(s.twice == 2 * s.count);
+                assert(s.time == 1000ull * s.count);
+                // one reader sees the writes in order
+                assert(s.count >= last);
+                last = s.count;
+                ++reads;
+            }
+        });
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < writers; ++t) {
+        threads.emplace_back([&lock1]() {
+            for (int i = 0; i < per_writer; ++i) {
+                lock1.Update([](Stamp& v) {
+                    ++v.count;
+                    v.twice = 2 * v.count;
+                    v.time = 1000ull * v.count;
+                });
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    done.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    SHOW(reads.load());
+    assert(lock1.Load().count == std::uint32_t(writers * per_writer));
+    assert(lock1.Sequence() == 2ull * writers * per_writer);
+}
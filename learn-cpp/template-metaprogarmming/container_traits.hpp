@@ -0,0 +1,136 @@
+#ifndef LEARN_CPP_TMP_CONTAINER_TRAITS_HPP
+#define LEARN_CPP_TMP_CONTAINER_TRAITS_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace learn_cpp {
+namespace detail {
+
+inline namespace v1 {
+template <class T, class Allocator>
+class vector;
+}  // namespace v1
+
+/**
+   NOTE
+   Manually implemented facilities, see tmp-basics-trait-IsContainer.cpp:
+   - Integral --- std::integral
+   - void_t --- std::void_t (c++17)
+   - IsContainer, whether a type has a begin() method.
+ */
+
+// like std::integral
+template <typename Type, Type val>
+struct Integral {
+    using type = Type;
+    static constexpr Type value = val;
+};
+
+using TrueType = Integral<bool, true>;
+using FalseType = Integral<bool, false>;
+
+// like std::void_t in c++17
+template <typename...>
+using void_t = void;
+
+template <bool b, typename T = void>
+using EnableIf = std::enable_if<b, T>;
+
+template <typename Container, typename = void>
+struct IsContainer : FalseType {};
+
+template <typename Container>
+struct IsContainer<Container,
+                   void_t<decltype(std::declval<Container>().begin())>>
+    : TrueType {};
+
+// std::basic_string has begin(), but it is printed as text, not as elements.
+template <typename T>
+struct IsString : FalseType {};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct IsString<std::basic_string<CharT, Traits, Alloc>> : TrueType {};
+
+// The element type of a container, as seen through its iterator.
+template <typename Container>
+using ElementType = typename std::decay<decltype(
+    *std::declval<const Container&>().begin())>::type;
+
+/**
+   IsContiguousContainer: the elements are stored in one array, data() points
+   to the first one and size() elements follow.
+   There is no way to detect this, so every container is opted in by hand.
+ */
+template <typename Container>
+struct IsContiguousContainer : FalseType {};
+
+template <typename T, typename Alloc>
+struct IsContiguousContainer<std::vector<T, Alloc>> : TrueType {};
+
+// vector<bool> is packed bits.
+template <typename Alloc>
+struct IsContiguousContainer<std::vector<bool, Alloc>> : FalseType {};
+
+template <typename T, std::size_t N>
+struct IsContiguousContainer<std::array<T, N>> : TrueType {};
+
+template <typename CharT, typename Traits, typename Alloc>
+struct IsContiguousContainer<std::basic_string<CharT, Traits, Alloc>>
+    : TrueType {};
+
+template <typename T, typename Alloc>
+struct IsContiguousContainer<vector<T, Alloc>> : TrueType {};
+
+/**
+   IsTriviallyRelocatable: moving a T to a new address and ending the
+   lifetime of the old one can be done with memcpy, and the old bytes are
+   simply forgotten (no destructor call).
+
+   True for trivially copyable types, and for types that only hold pointers
+   to their resources, e.g. v1::vector and std::unique_ptr. It is not true
+   for types pointing into themselves, like std::string with SSO in libstdc++,
+   or std::list with its sentinel node.
+ */
+template <typename T>
+struct IsTriviallyRelocatable
+    : Integral<bool, std::is_trivially_copyable<T>::value> {};
+
+template <typename T, typename Alloc>
+struct IsTriviallyRelocatable<vector<T, Alloc>>
+    : IsTriviallyRelocatable<Alloc> {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::allocator<T>> : TrueType {};
+
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : TrueType {};
+
+// HasReserve: whether c.reserve(n) is valid.
+template <typename Container, typename = void>
+struct HasReserve : FalseType {};
+
+template <typename Container>
+struct HasReserve<Container,
+                  void_t<decltype(std::declval<Container&>().reserve(
+                      std::declval<typename Container::size_type>()))>>
+    : TrueType {};
+
+// HasSize: whether c.size() is valid.
+template <typename Container, typename = void>
+struct HasSize : FalseType {};
+
+template <typename Container>
+struct HasSize<Container,
+               void_t<decltype(std::declval<const Container&>().size())>>
+    : TrueType {};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
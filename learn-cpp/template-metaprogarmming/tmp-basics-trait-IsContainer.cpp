@@ -13,6 +13,9 @@
 
    Add operator<<(std::ostream &, Container).
    Print 1d container and 2d container differently.
+
+   For printing large containers fast, and nested to any depth, see
+   ../utility/container_formatter.hpp.
  */
 
 // like std::integral
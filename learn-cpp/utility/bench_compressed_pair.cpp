@@ -0,0 +1,56 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "compressed_pair.hpp"
+
+/**
+ * CompressedPair vs std::pair, with an empty second member.
+ * EBO makes the array of CompressedPair half the size, so a scan over it
+ * touches half the memory.
+ *
+ * Usage: bench_compressed_pair.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::CompressedPair;
+using learn_cpp::detail::do_not_optimize;
+
+using Empty = std::allocator<int>;
+
+int& first_of(std::pair<int, Empty>& p) { return p.first; }
+
+int& first_of(CompressedPair<int, Empty>& p) { return p.first(); }
+
+template <class Pair>
+void bench_scan(BenchmarkRunner& runner, const std::string& name,
+                std::size_t n) {
+    std::vector<Pair> pairs(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        first_of(pairs[i]) = static_cast<int>(i);
+    }
+    runner
+        .run(name + "/scan",
+             [&pairs]() {
+                 long sum = 0;
+                 for (auto& p : pairs) {
+                     sum += first_of(p);
+                 }
+                 do_not_optimize(sum);
+             })
+        .set_items(n)
+        .set_bytes(n * sizeof(Pair));
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 10000000);
+    BenchmarkRunner runner("CompressedPair", options);
+
+    static_assert(sizeof(CompressedPair<int, Empty>) == sizeof(int), "EBO");
+    bench_scan<std::pair<int, Empty>>(runner, "std::pair", n);
+    bench_scan<CompressedPair<int, Empty>>(runner, "CompressedPair", n);
+}
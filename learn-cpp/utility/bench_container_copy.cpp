@@ -0,0 +1,61 @@
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "container_copy.hpp"
+
+/**
+ * append() on each of its paths, vs a plain push_back loop.
+ *
+ * Usage: bench_container_copy.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::append;
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::copy_path;
+using learn_cpp::detail::copy_path_name;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::select_copy_path;
+
+template <typename T>
+using Vector = learn_cpp::detail::v1::vector<T>;
+
+template <typename Dst, typename Src>
+void run(BenchmarkRunner& runner, const std::string& name, const Src& src) {
+    constexpr copy_path path = select_copy_path<Dst, Src>();
+    runner
+        .run(name + "/push_back_loop",
+             [&src]() {
+                 Dst dst;
+                 for (auto it = src.begin(); it != src.end(); ++it) {
+                     dst.push_back(*it);
+                 }
+                 do_not_optimize(dst);
+             })
+        .set_items(src.size());
+    runner
+        .run(name + "/append(" + copy_path_name(path) + ")",
+             [&src]() {
+                 Dst dst;
+                 append(dst, src);
+                 do_not_optimize(dst);
+             })
+        .set_items(src.size());
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    BenchmarkRunner runner("container_copy", options);
+
+    std::vector<int> src(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        src[i] = static_cast<int>(i);
+    }
+    run<Vector<int>>(runner, "vector<int>->v1::vector<int>", src);
+    run<std::vector<long>>(runner, "vector<int>->vector<long>", src);
+    run<std::deque<int>>(runner, "vector<int>->deque<int>", src);
+}
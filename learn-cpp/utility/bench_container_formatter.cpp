@@ -0,0 +1,114 @@
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "container_formatter.hpp"
+
+/**
+ * Dumping large containers: the per-element operator<< overloads from
+ * tmp-basics-trait-IsContainer.cpp vs ContainerFormatter.
+ *
+ * Usage: bench_container_formatter.out [elements] [output file]
+ *                                      [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::ContainerFormatter;
+using learn_cpp::detail::IsContainer;
+
+// The overloads from tmp-basics-trait-IsContainer.cpp, as the baseline.
+namespace naive {
+
+template <typename Container,
+          typename std::enable_if<
+              IsContainer<Container>::value &&
+                  !IsContainer<typename Container::value_type>::value,
+              int>::type = 0>
+std::ostream &operator<<(std::ostream &os, const Container &container) {
+    os << "{ ";
+    for (auto it1 = container.begin(); it1 != container.end(); ++it1) {
+        os << *it1 << ", ";
+    }
+    os << "}";
+    return os;
+}
+
+template <typename Container,
+          typename std::enable_if<
+              IsContainer<Container>::value &&
+                  IsContainer<typename Container::value_type>::value,
+              int>::type = 0>
+std::ostream &operator<<(std::ostream &os, const Container &container) {
+    os << "{\n";
+    for (auto it1 = container.begin(); it1 != container.end(); ++it1) {
+        os << "    " << *it1 << ",\n";
+    }
+    os << "}";
+    return os;
+}
+
+}  // namespace naive
+
+template <typename Container>
+void run(BenchmarkRunner &runner, const std::string &name,
+         const Container &container, std::ostream &out) {
+    // NOTE the output sizes differ for floating point numbers (precision 6 vs
+    // shortest round-trip), so each side is measured in its own bytes.
+    std::ostringstream oss;
+    naive::operator<<(oss, container);
+    runner
+        .run(name + "/operator<<",
+             [&]() {
+                 naive::operator<<(out, container);
+                 out.flush();
+             })
+        .set_items(container.size())
+        .set_bytes(oss.str().size());
+
+    // the warmup runs size the buffer, the steady state is timed.
+    ContainerFormatter formatter;
+    formatter.append(container);
+    runner
+        .run(name + "/ContainerFormatter",
+             [&]() {
+                 formatter.print(out, container);
+                 out.flush();
+             })
+        .set_items(container.size())
+        .set_bytes(formatter.size());
+}
+
+int main(int argc, char *argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    std::string path = options.args.size() > 1 ? options.args[1] : "/dev/null";
+    std::ofstream out(path, std::ios::binary);
+    BenchmarkRunner runner("container_formatter", options);
+
+    std::mt19937_64 rng(42);
+    std::vector<int> ivec(n);
+    for (auto &x : ivec) {
+        x = static_cast<int>(rng());
+    }
+    run(runner, "1d int", ivec, out);
+
+    std::vector<double> dvec(n / 4);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    for (auto &x : dvec) {
+        x = dist(rng);
+    }
+    run(runner, "1d double", dvec, out);
+
+    std::vector<std::vector<int>> vec2d(n / 1000, std::vector<int>(1000));
+    for (auto &row : vec2d) {
+        for (auto &x : row) {
+            x = static_cast<int>(rng() % 100000);
+        }
+    }
+    run(runner, "2d int", vec2d, out);
+}
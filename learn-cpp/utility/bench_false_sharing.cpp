@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../benchmark/benchmark.hpp"
+#include "cache_padded.hpp"
+
+/**
+ * Per-thread counters, packed next to each other vs one cache line each.
+ * Every thread only touches its own counter, so any slowdown of the packed
+ * layout is false sharing: the line ping-pongs between cores.
+ *
+ * Usage: bench_false_sharing.out [increments per thread] [threads]
+ *                                [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::cache_padded;
+
+std::atomic<long>& counter_of(std::atomic<long>& c) { return c; }
+
+std::atomic<long>& counter_of(cache_padded<std::atomic<long>>& c) {
+    return *c;
+}
+
+template <class Counter>
+void bench_counters(BenchmarkRunner& runner, const std::string& name,
+                    std::size_t n, unsigned threads) {
+    std::vector<Counter> counters(threads);
+    runner
+        .run_parallel(
+            name + "/" + std::to_string(threads),
+            [n, &counters]() {
+                std::vector<std::thread> workers;
+                for (auto& c : counters) {
+                    workers.emplace_back([n, &c]() {
+                        auto& counter = counter_of(c);
+                        for (std::size_t i = 0; i < n; ++i) {
+                            counter.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    });
+                }
+                for (auto& w : workers) {
+                    w.join();
+                }
+            })
+        .set_items(n * threads);
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    unsigned threads = static_cast<unsigned>(
+        options.arg(1, std::max(2u, std::thread::hardware_concurrency())));
+    BenchmarkRunner runner("false_sharing", options);
+
+    bench_counters<std::atomic<long>>(runner, "packed", n, threads);
+    bench_counters<cache_padded<std::atomic<long>>>(runner, "cache_padded", n,
+                                                    threads);
+}
@@ -0,0 +1,158 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "../memory/aligned_allocator.hpp"
+#include "file_loader.hpp"
+
+/**
+ * Loading a file of uint64_t into a v1::vector: ifstream::read, then
+ * load_file() on each backend, with and without O_DIRECT, and with the sum
+ * computed in the per-chunk callback vs after the load.
+ *
+ * The page cache of the file is dropped before every repetition
+ * (posix_fadvise), so the reads go to the disk, unless the file system
+ * keeps everything in memory (tmpfs).
+ *
+ * The load_file() runs use run_parallel_with_setup(): the pread backend
+ * reads on a pool of threads, which --cpu must not squeeze onto one cpu.
+ *
+ * Usage: bench_file_loader.out [MiB] [directory] [harness options]
+ */
+
+using learn_cpp::detail::aligned_allocator;
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::io_backend;
+using learn_cpp::detail::load_file;
+using learn_cpp::detail::LoadOptions;
+
+template <typename T>
+using Vector = learn_cpp::detail::v1::vector<T>;
+template <typename T>
+using AlignedVector =
+    learn_cpp::detail::v1::vector<T, aligned_allocator<T, 4096>>;
+
+int drop_cache(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd != -1) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+    return 0;
+}
+
+std::uint64_t sum(const std::uint64_t* first, const std::uint64_t* last) {
+    std::uint64_t s = 0;
+    for (; first != last; ++first) {
+        s += *first;
+    }
+    return s;
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t mib = options.arg(0, 256);
+    std::string dir = options.args.size() > 1 ? options.args[1] : "/tmp";
+    BenchmarkRunner runner("file_loader", options);
+
+    std::string path =
+        dir + "/bench_file_loader." + std::to_string(::getpid()) + ".bin";
+    std::size_t n = mib * (1 << 20) / sizeof(std::uint64_t);
+    {
+        Vector<std::uint64_t> data(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            data[i] = i;
+        }
+        std::FILE* fp = std::fopen(path.c_str(), "wb");
+        if (fp == nullptr) {
+            std::cerr << "can not write " << path << '\n';
+            return 1;
+        }
+        std::fwrite(data.data(), sizeof(std::uint64_t), n, fp);
+        std::fflush(fp);
+        ::fsync(::fileno(fp));
+        std::fclose(fp);
+    }
+    std::size_t bytes = n * sizeof(std::uint64_t);
+    auto setup = [&path]() { return drop_cache(path); };
+
+    runner
+        .run_with_setup("ifstream::read", setup,
+                        [&path, n](int) {
+                            Vector<std::uint64_t> vec(n);
+                            std::ifstream in(path, std::ios::binary);
+                            in.read(reinterpret_cast<char*>(vec.data()),
+                                    std::streamsize(n * sizeof(vec[0])));
+                            do_not_optimize(vec.data());
+                        })
+        .set_items(n)
+        .set_bytes(bytes);
+
+    for (io_backend backend : {io_backend::io_uring, io_backend::pread}) {
+        std::string name =
+            backend == io_backend::io_uring ? "io_uring" : "pread";
+        LoadOptions load;
+        load.backend = backend;
+        runner
+            .run_parallel_with_setup("load_file/" + name, setup,
+                                     [&path, &load](int) {
+                                         Vector<std::uint64_t> vec;
+                                         load_file(path.c_str(), vec, load);
+                                         do_not_optimize(vec.data());
+                                     })
+            .set_items(n)
+            .set_bytes(bytes);
+        LoadOptions direct = load;
+        direct.direct = true;
+        runner
+            .run_parallel_with_setup(
+                "load_file/" + name + "/direct", setup,
+                [&path, &direct](int) {
+                    AlignedVector<std::uint64_t> vec;
+                    load_file(path.c_str(), vec, direct);
+                    do_not_optimize(vec.data());
+                })
+            .set_items(n)
+            .set_bytes(bytes);
+    }
+
+    LoadOptions load;
+    runner
+        .run_parallel_with_setup(
+            "load_file+sum/after", setup,
+            [&path, &load](int) {
+                Vector<std::uint64_t> vec;
+                load_file(path.c_str(), vec, load);
+                std::uint64_t s = sum(vec.data(), vec.data() + vec.size());
+                do_not_optimize(s);
+            })
+        .set_items(n)
+        .set_bytes(bytes);
+    runner
+        .run_parallel_with_setup(
+            "load_file+sum/per_chunk", setup,
+            [&path, &load](int) {
+                Vector<std::uint64_t> vec;
+                std::uint64_t s = 0;
+                load_file(path.c_str(), vec, load,
+                          [&s](const std::uint64_t* first,
+                               const std::uint64_t* last) {
+                              s += sum(first, last);
+                          });
+                do_not_optimize(s);
+            })
+        .set_items(n)
+        .set_bytes(bytes);
+
+    runner.report();
+    std::remove(path.c_str());
+}
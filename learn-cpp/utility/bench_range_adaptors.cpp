@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "../memory/allocation_stats.hpp"
+#include "../memory/tracking_allocator.hpp"
+#include "range_adaptors.hpp"
+
+/**
+ * filter -> transform -> take over a v1::vector: eager, one vector per
+ * stage, vs the lazy views and a to<> at the end, vs a hand-written loop.
+ * The allocations of one pass are printed after the timings.
+ *
+ * Usage: bench_range_adaptors.out [elements] [harness options]
+ */
+
+namespace views = learn_cpp::detail::ranges::views;
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::tracking_allocator;
+namespace allocation_stats = learn_cpp::detail::allocation_stats;
+namespace ranges = learn_cpp::detail::ranges;
+
+template <typename T>
+using Vector = learn_cpp::detail::v1::vector<T, tracking_allocator<T>>;
+
+bool keep(std::int64_t x) { return x % 3 != 0; }
+std::int64_t map(std::int64_t x) { return x * x + 1; }
+
+Vector<std::int64_t> eager(const Vector<std::int64_t>& src, std::size_t n) {
+    Vector<std::int64_t> filtered;
+    for (auto x : src) {
+        if (keep(x)) {
+            filtered.push_back(x);
+        }
+    }
+    Vector<std::int64_t> mapped;
+    mapped.reserve(filtered.size());
+    for (auto x : filtered) {
+        mapped.push_back(map(x));
+    }
+    Vector<std::int64_t> taken;
+    taken.reserve(n < mapped.size() ? n : mapped.size());
+    for (std::size_t i = 0; i < mapped.size() && i < n; ++i) {
+        taken.push_back(mapped[i]);
+    }
+    return taken;
+}
+
+Vector<std::int64_t> lazy(const Vector<std::int64_t>& src, std::size_t n) {
+    return src | views::filter([](std::int64_t x) { return keep(x); }) |
+           views::transform([](std::int64_t x) { return map(x); }) |
+           views::take(n) | ranges::to<Vector<std::int64_t>>();
+}
+
+Vector<std::int64_t> hand_loop(const Vector<std::int64_t>& src,
+                               std::size_t n) {
+    Vector<std::int64_t> out;
+    for (auto x : src) {
+        if (out.size() == n) {
+            break;
+        }
+        if (keep(x)) {
+            out.push_back(map(x));
+        }
+    }
+    return out;
+}
+
+template <class Fn>
+std::uint64_t allocations_of(Fn fn) {
+    auto before = allocation_stats::collect().allocations;
+    fn();
+    return allocation_stats::collect().allocations - before;
+}
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    BenchmarkRunner runner("range_adaptors", options);
+
+    Vector<std::int64_t> src;
+    src.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        src.push_back(static_cast<std::int64_t>(i));
+    }
+
+    std::string report;
+    for (std::size_t take : {n, n / 100}) {
+        std::string suffix = "/take=" + std::to_string(take);
+        auto run = [&](const std::string& name,
+                       Vector<std::int64_t> (*fn)(
+                           const Vector<std::int64_t>&, std::size_t)) {
+            runner
+                .run(name + suffix,
+                     [&src, take, fn]() {
+                         auto out = fn(src, take);
+                         do_not_optimize(out.data());
+                     })
+                .set_items(n);
+            report += name + suffix + ": " +
+                      std::to_string(allocations_of(
+                          [&src, take, fn]() { fn(src, take); })) +
+                      " allocations\n";
+        };
+        run("eager", eager);
+        run("lazy", lazy);
+        run("hand_loop", hand_loop);
+    }
+    runner.report();
+    std::cout << '\n' << report;
+}
@@ -0,0 +1,69 @@
+#if !defined(LEARN_CPP_TRACE)
+#define LEARN_CPP_TRACE
+#endif
+
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "trace.hpp"
+
+/**
+ * The cost of a traced span and of an instant event, next to the empty
+ * loop.
+ *
+ * Usage: bench_trace.out [events] [harness options]
+ */
+
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+namespace trace = learn_cpp::detail::trace;
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1000000);
+    BenchmarkRunner runner("trace", options);
+
+    runner
+        .run("empty",
+             [n]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     do_not_optimize(i);
+                 }
+             })
+        .set_items(n);
+    runner
+        .run("LEARN_CPP_TRACE_SCOPE",
+             [n]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     LEARN_CPP_TRACE_SCOPE("span");
+                     do_not_optimize(i);
+                 }
+             })
+        .set_items(n);
+    runner
+        .run("LEARN_CPP_TRACE_INSTANT",
+             [n]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     LEARN_CPP_TRACE_INSTANT("instant");
+                     do_not_optimize(i);
+                 }
+             })
+        .set_items(n);
+    runner
+        .run("now",
+             [n]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     do_not_optimize(trace::now());
+                 }
+             })
+        .set_items(n);
+    runner
+        .run("now_ns",
+             [n]() {
+                 for (std::size_t i = 0; i < n; ++i) {
+                     do_not_optimize(trace::now_ns());
+                 }
+             })
+        .set_items(n);
+}
@@ -0,0 +1,130 @@
+#include <cstddef>
+#include <string>
+
+#include "../benchmark/benchmark.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "vector_expression.hpp"
+
+/**
+ * out = a * b + c and out = a * b + c * d - e over double vectors: naive
+ * operators returning a vector each, vs the expression templates of
+ * vector_expression.hpp (into a new vector, and into an existing one), vs a
+ * hand-written loop. MB/s counts the bytes of the operands and the result
+ * once, the traffic of a single fused pass.
+ *
+ * Usage: bench_vector_expression.out [elements] [harness options]
+ */
+
+using learn_cpp::detail::assign;
+using learn_cpp::detail::BenchmarkOptions;
+using learn_cpp::detail::BenchmarkRunner;
+using learn_cpp::detail::do_not_optimize;
+using learn_cpp::detail::evaluate;
+
+using Vector = learn_cpp::detail::v1::vector<double>;
+
+namespace naive {
+
+// the eager operators, one temporary and one pass per operator.
+struct Vec {
+    Vector v;
+};
+
+template <class Op>
+Vec apply(const Vec& l, const Vec& r, Op op) {
+    Vec out;
+    out.v.resize(l.v.size());
+    for (std::size_t i = 0; i < l.v.size(); ++i) {
+        out.v[i] = op(l.v[i], r.v[i]);
+    }
+    return out;
+}
+
+Vec operator+(const Vec& l, const Vec& r) {
+    return apply(l, r, [](double x, double y) { return x + y; });
+}
+
+Vec operator-(const Vec& l, const Vec& r) {
+    return apply(l, r, [](double x, double y) { return x - y; });
+}
+
+Vec operator*(const Vec& l, const Vec& r) {
+    return apply(l, r, [](double x, double y) { return x * y; });
+}
+
+}  // namespace naive
+
+int main(int argc, char* argv[]) {
+    auto options = BenchmarkOptions::parse(argc, argv);
+    std::size_t n = options.arg(0, 1 << 22);
+    BenchmarkRunner runner("vector_expression", options);
+
+    naive::Vec a, b, c, d, e;
+    for (std::size_t i = 0; i < n; ++i) {
+        a.v.push_back(double(i));
+        b.v.push_back(1.0 / double(i + 1));
+        c.v.push_back(double(i % 7));
+        d.v.push_back(0.5);
+        e.v.push_back(double(i % 3));
+    }
+    Vector out(n);
+    std::size_t bytes3 = 4 * n * sizeof(double);
+    std::size_t bytes5 = 6 * n * sizeof(double);
+
+    runner
+        .run("a*b+c/naive",
+             [&]() {
+                 naive::Vec r = a * b + c;
+                 do_not_optimize(r.v.data());
+             })
+        .set_items(n)
+        .set_bytes(bytes3);
+    runner
+        .run("a*b+c/evaluate",
+             [&]() {
+                 Vector r = evaluate(a.v * b.v + c.v);
+                 do_not_optimize(r.data());
+             })
+        .set_items(n)
+        .set_bytes(bytes3);
+    runner
+        .run("a*b+c/assign",
+             [&]() {
+                 assign(out, a.v * b.v + c.v);
+                 do_not_optimize(out.data());
+             })
+        .set_items(n)
+        .set_bytes(bytes3);
+    runner
+        .run("a*b+c/hand_loop",
+             [&]() {
+                 double* p = out.data();
+                 const double* pa = a.v.data();
+                 const double* pb = b.v.data();
+                 const double* pc = c.v.data();
+                 for (std::size_t i = 0; i < n; ++i) {
+                     p[i] = pa[i] * pb[i] + pc[i];
+                 }
+                 do_not_optimize(out.data());
+             })
+        .set_items(n)
+        .set_bytes(bytes3);
+
+    runner
+        .run("a*b+c*d-e/naive",
+             [&]() {
+                 naive::Vec r = a * b + c * d - e;
+                 do_not_optimize(r.v.data());
+             })
+        .set_items(n)
+        .set_bytes(bytes5);
+    runner
+        .run("a*b+c*d-e/assign",
+             [&]() {
+                 assign(out, a.v * b.v + c.v * d.v - e.v);
+                 do_not_optimize(out.data());
+             })
+        .set_items(n)
+        .set_bytes(bytes5);
+    runner.report();
+}
@@ -0,0 +1,57 @@
+#ifndef LEARN_CPP_UTILITY_CACHE_PADDED_HPP
+#define LEARN_CPP_UTILITY_CACHE_PADDED_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace learn_cpp {
+namespace detail {
+
+// NOTE std::hardware_destructive_interference_size is not stable across
+// compiler flags (gcc warns about it in headers), so use a fixed value.
+#if defined(LEARN_CPP_CACHE_LINE_SIZE)
+constexpr std::size_t kCacheLineSize = LEARN_CPP_CACHE_LINE_SIZE;
+#else
+constexpr std::size_t kCacheLineSize = 64;
+#endif
+
+/**
+   Wraps a T so that it occupies whole cache lines on its own.
+   Two cache_padded objects never share a line, which avoids false sharing
+   between e.g. per-thread counters stored in an array.
+ */
+template <class T>
+class alignas(kCacheLineSize) cache_padded {
+   public:
+    cache_padded() = default;
+
+    // NOTE the constraint keeps this from hijacking the copy constructor.
+    template <class Arg, class... Args,
+              typename std::enable_if<
+                  !std::is_same<typename std::decay<Arg>::type,
+                                cache_padded>::value,
+                  int>::type = 0>
+    explicit cache_padded(Arg&& arg, Args&&... args)
+        : value_(std::forward<Arg>(arg), std::forward<Args>(args)...) {}
+
+    T& get() noexcept { return value_; }
+
+    const T& get() const noexcept { return value_; }
+
+    T& operator*() noexcept { return value_; }
+
+    const T& operator*() const noexcept { return value_; }
+
+    T* operator->() noexcept { return &value_; }
+
+    const T* operator->() const noexcept { return &value_; }
+
+   private:
+    T value_;
+};
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef LEARN_CPP_UTILITY_CONTAINER_COPY_HPP
+#define LEARN_CPP_UTILITY_CONTAINER_COPY_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+#include "../template-metaprogarmming/container_traits.hpp"
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   Generic append/copy_into between containers, choosing the fastest path the
+   traits in container_traits.hpp allow:
+   - memcpy: both sides contiguous, same trivially copyable element type.
+     The destination is resized, then the bytes are copied in one call.
+   - reserve_then_copy: the destination has reserve() and the size of the
+     source is known, so there is at most one reallocation.
+   - element_wise: push_back one by one.
+ */
+enum class copy_path { memcpy, reserve_then_copy, element_wise };
+
+inline const char* copy_path_name(copy_path path) noexcept {
+    switch (path) {
+        case copy_path::memcpy:
+            return "memcpy";
+        case copy_path::reserve_then_copy:
+            return "reserve_then_copy";
+        case copy_path::element_wise:
+            return "element_wise";
+    }
+    return "unknown";
+}
+
+template <typename Dst, typename Src>
+struct CanMemcpy
+    : Integral<bool,
+               IsContiguousContainer<Dst>::value &&
+                   IsContiguousContainer<Src>::value &&
+                   std::is_same<ElementType<Dst>, ElementType<Src>>::value &&
+                   std::is_trivially_copyable<ElementType<Dst>>::value> {};
+
+template <typename Dst, typename Src>
+constexpr copy_path select_copy_path() {
+    return CanMemcpy<Dst, Src>::value ? copy_path::memcpy
+           : HasReserve<Dst>::value && HasSize<Src>::value
+               ? copy_path::reserve_then_copy
+               : copy_path::element_wise;
+}
+
+namespace copy_impl {
+
+using MemcpyTag = Integral<copy_path, copy_path::memcpy>;
+using ReserveTag = Integral<copy_path, copy_path::reserve_then_copy>;
+using ElementWiseTag = Integral<copy_path, copy_path::element_wise>;
+
+template <typename Dst, typename Src>
+void append(Dst& dst, const Src& src, MemcpyTag) {
+    std::size_t n = src.size();
+    if (n == 0) {
+        return;
+    }
+    std::size_t old_size = dst.size();
+    // NOTE resize value-initializes the tail before it is overwritten, there
+    // is no portable way to grow a std container without that.
+    dst.resize(old_size + n);
+    std::memcpy(static_cast<void*>(dst.data() + old_size),
+                static_cast<const void*>(src.data()),
+                n * sizeof(ElementType<Src>));
+}
+
+// Copies exactly n elements: src may be dst, whose end() moves with every
+// push_back.
+template <typename Dst, typename It>
+void push_back_n(Dst& dst, It first, std::size_t n) {
+    for (; n != 0; --n, ++first) {
+        dst.push_back(*first);
+    }
+}
+
+template <typename Dst, typename Src>
+void append(Dst& dst, const Src& src, ReserveTag) {
+    std::size_t n = src.size();
+    dst.reserve(dst.size() + n);
+    push_back_n(dst, src.begin(), n);
+}
+
+template <typename Dst, typename Src>
+void append(Dst& dst, const Src& src, ElementWiseTag) {
+    if (static_cast<const void*>(&dst) == static_cast<const void*>(&src)) {
+        auto n = std::distance(src.begin(), src.end());
+        push_back_n(dst, src.begin(), static_cast<std::size_t>(n));
+        return;
+    }
+    for (auto it = src.begin(); it != src.end(); ++it) {
+        dst.push_back(*it);
+    }
+}
+
+}  // namespace copy_impl
+
+/** Append all elements of src at the end of dst; src may be dst itself.
+    Returns the path that was used.
+ */
+template <typename Dst, typename Src>
+copy_path append(Dst& dst, const Src& src) {
+    constexpr copy_path path = select_copy_path<Dst, Src>();
+    copy_impl::append(dst, src, Integral<copy_path, path>());
+    return path;
+}
+
+/** Make dst a copy of src, which may be a different container type.
+    The capacity of dst is kept and reused.
+ */
+template <typename Dst, typename Src>
+copy_path copy_into(Dst& dst, const Src& src) {
+    dst.clear();
+    return append(dst, src);
+}
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
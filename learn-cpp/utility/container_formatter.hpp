@@ -0,0 +1,218 @@
+#ifndef LEARN_CPP_UTILITY_CONTAINER_FORMATTER_HPP
+#define LEARN_CPP_UTILITY_CONTAINER_FORMATTER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "../template-metaprogarmming/container_traits.hpp"
+
+namespace learn_cpp {
+namespace detail {
+
+/**
+   Formats containers (anything IsContainer accepts) into one contiguous
+   buffer, which is then written with a single ostream::write.
+
+   The layout is the one of the operator<< overloads in
+   tmp-basics-trait-IsContainer.cpp, generalized to any depth:
+   - a container of non-containers is printed inline, `{ 1, 2, 3, }`
+   - a container of containers puts one element per line, indented by depth.
+
+   Arithmetic values go through std::to_chars, floating point numbers are
+   printed in their shortest round-trip form. Strings and the one byte
+   character types are printed as text; wide characters and strings are
+   rejected at compile time, they need an encoding first.
+   Anything else falls back to its own operator<<.
+
+   The buffer is kept between calls, so a long-lived formatter stops
+   allocating after the first few dumps.
+ */
+class ContainerFormatter {
+   public:
+    explicit ContainerFormatter(std::size_t reserve = 4096) {
+        buf_.reserve(reserve);
+    }
+
+    /** Append the formatted value to the buffer.
+     */
+    template <typename T>
+    ContainerFormatter& append(const T& value) {
+        append_value_(value, 0);
+        return *this;
+    }
+
+    /** Format value and write it to os, reusing the buffer.
+     */
+    template <typename T>
+    void print(std::ostream& os, const T& value) {
+        clear();
+        append(value);
+        write_to(os);
+    }
+
+    void write_to(std::ostream& os) const {
+        os.write(buf_.data(), static_cast<std::streamsize>(buf_.size()));
+    }
+
+    const char* data() const noexcept { return buf_.data(); }
+
+    std::size_t size() const noexcept { return buf_.size(); }
+
+    const std::string& str() const noexcept { return buf_; }
+
+    void clear() noexcept { buf_.clear(); }
+
+   private:
+    std::string buf_;
+
+    template <typename T>
+    struct IsNested
+        : Integral<bool, IsContainer<T>::value && !IsString<T>::value> {};
+
+    template <typename Container>
+    struct HasNestedElements : IsNested<ElementType<Container>> {};
+
+    void append_text_(const char* s, std::size_t n) { buf_.append(s, n); }
+
+    void indent_(int depth) { buf_.append(4 * depth, ' '); }
+
+    template <typename T>
+    void append_value_(const T& value, int depth) {
+        dispatch_(value, depth, Kind<T>());
+    }
+
+    // tag dispatch
+    struct ArithmeticTag {};
+    struct TextTag {};
+    struct ContainerTag {};
+    struct OtherTag {};
+
+    template <typename T>
+    struct IsCharacter
+        : Integral<bool, std::is_same<T, char>::value ||
+                             std::is_same<T, signed char>::value ||
+                             std::is_same<T, unsigned char>::value ||
+                             std::is_same<T, wchar_t>::value ||
+                             std::is_same<T, char16_t>::value ||
+                             std::is_same<T, char32_t>::value> {};
+
+    template <typename T>
+    struct IsText
+        : Integral<bool, IsString<T>::value || IsCharacter<T>::value ||
+                             std::is_same<T, const char*>::value ||
+                             std::is_same<T, char*>::value ||
+                             std::is_same<T, bool>::value> {};
+
+    template <typename T>
+    using ValueKind = typename std::conditional<std::is_arithmetic<T>::value,
+                                                ArithmeticTag, OtherTag>::type;
+
+    template <typename T>
+    using Kind = typename std::conditional<
+        IsText<T>::value, TextTag,
+        typename std::conditional<IsContainer<T>::value, ContainerTag,
+                                  ValueKind<T>>::type>::type;
+
+    template <typename T>
+    void dispatch_(const T& value, int, ArithmeticTag) {
+        // enough for any integer and the shortest form of any long double.
+        char tmp[64];
+        auto result = std::to_chars(tmp, tmp + sizeof(tmp), value);
+        buf_.append(tmp, result.ptr);
+    }
+
+    template <typename CharT, typename Traits, typename Alloc>
+    void dispatch_(const std::basic_string<CharT, Traits, Alloc>& value, int,
+                   TextTag) {
+        static_assert(sizeof(CharT) == 1,
+                      "wide strings need an encoding, convert them to UTF-8");
+        buf_.append(value.begin(), value.end());
+    }
+
+    void dispatch_(const char* value, int, TextTag) {
+        append_text_(value, std::strlen(value));
+    }
+
+    // the one byte characters, printed as characters like operator<< does
+    void dispatch_(char value, int, TextTag) { buf_.push_back(value); }
+
+    void dispatch_(signed char value, int, TextTag) {
+        buf_.push_back(static_cast<char>(value));
+    }
+
+    void dispatch_(unsigned char value, int, TextTag) {
+        buf_.push_back(static_cast<char>(value));
+    }
+
+    template <typename CharT,
+              typename std::enable_if<IsCharacter<CharT>::value &&
+                                          (sizeof(CharT) > 1),
+                                      int>::type = 0>
+    void dispatch_(CharT, int, TextTag) {
+        static_assert(sizeof(CharT) == 1,
+                      "wide characters need an encoding, convert to UTF-8");
+    }
+
+    // like operator<< without std::boolalpha
+    void dispatch_(bool value, int, TextTag) {
+        buf_.push_back(value ? '1' : '0');
+    }
+
+    template <typename Container>
+    void dispatch_(const Container& container, int depth, ContainerTag) {
+        using Nested = Integral<bool, HasNestedElements<Container>::value>;
+        append_container_(container, depth, Nested());
+    }
+
+    // leaf container, printed inline
+    template <typename Container>
+    void append_container_(const Container& container, int depth, FalseType) {
+        buf_.append("{ ", 2);
+        for (auto it = container.begin(); it != container.end(); ++it) {
+            append_value_(*it, depth + 1);
+            buf_.append(", ", 2);
+        }
+        buf_.push_back('}');
+    }
+
+    // container of containers, one element per line
+    template <typename Container>
+    void append_container_(const Container& container, int depth, TrueType) {
+        buf_.append("{\n", 2);
+        for (auto it = container.begin(); it != container.end(); ++it) {
+            indent_(depth + 1);
+            append_value_(*it, depth + 1);
+            buf_.append(",\n", 2);
+        }
+        indent_(depth);
+        buf_.push_back('}');
+    }
+
+    template <typename T>
+    void dispatch_(const T& value, int, OtherTag) {
+        // NOTE the slow path, only for types without a faster formatting.
+        std::ostringstream oss;
+        oss << value;
+        buf_.append(oss.str());
+    }
+};
+
+/** Print a container with a per-thread formatter, whose buffer is reused.
+ */
+template <typename Container,
+          typename std::enable_if<IsContainer<Container>::value, int>::type = 0>
+std::ostream& print_container(std::ostream& os, const Container& container) {
+    thread_local ContainerFormatter formatter;
+    formatter.print(os, container);
+    return os;
+}
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
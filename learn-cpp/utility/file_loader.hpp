@@ -0,0 +1,556 @@
+#ifndef LEARN_CPP_UTILITY_FILE_LOADER_HPP
+#define LEARN_CPP_UTILITY_FILE_LOADER_HPP
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../implement-std-library/c++11/vector.hpp"
+
+namespace learn_cpp {
+
+namespace detail {
+
+enum class io_backend {
+    automatic,  // io_uring, pread when the kernel refuses io_uring
+    io_uring,   // Linux 5.6 or later
+    pread,      // a pool of threads doing blocking pread(2)
+};
+
+struct LoadOptions {
+    // bytes per read, rounded up to kDirectAlignment with direct; below
+    // 4 GiB
+    std::size_t chunk_bytes = std::size_t(1) << 20;
+    // reads in flight: io_uring queue entries, or pread threads
+    unsigned queue_depth = 8;
+    // O_DIRECT, see load_file()
+    bool direct = false;
+    io_backend backend = io_backend::automatic;
+};
+
+struct LoadStats {
+    std::size_t bytes = 0;
+    std::size_t chunks = 0;
+    // the backend that did the reads, automatic if there were none
+    io_backend backend = io_backend::automatic;
+    // false if the file system refused O_DIRECT
+    bool direct = false;
+};
+
+// buffer, offset and length alignment of O_DIRECT reads.
+constexpr std::size_t kDirectAlignment = 4096;
+
+/**
+   The part of io_uring(7) needed for reads, on the raw syscalls: one
+   submission and one completion ring, no registered buffers, no polling.
+ */
+class IoUring {
+   public:
+    explicit IoUring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(
+            ::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "io_uring_setup");
+        }
+        // IORING_OP_READ came with this feature, in 5.6.
+        if ((params.features & IORING_FEAT_RW_CUR_POS) == 0) {
+            ::close(fd_);
+            throw std::system_error(ENOSYS, std::generic_category(),
+                                    "io_uring without IORING_OP_READ");
+        }
+        try {
+            map_(params);
+        } catch (...) {
+            unmap_();
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    ~IoUring() {
+        unmap_();
+        ::close(fd_);
+    }
+
+    // not copyable
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    unsigned entries() const { return sq_entries_; }
+
+    /** Queue a read, at most entries() before submit_and_wait().
+     */
+    void prepare_read(int fd, void* buf, std::size_t len, std::uint64_t offset,
+                      std::uint64_t user_data) {
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & *sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<std::uint64_t>(buf);
+        sqe.len = static_cast<std::uint32_t>(len);
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+    }
+
+    /** Submit the queued reads, and wait until wait_nr have completed.
+     */
+    void submit_and_wait(unsigned wait_nr) {
+        for (;;) {
+            long r = ::syscall(__NR_io_uring_enter, fd_, pending_, wait_nr,
+                               IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (r >= 0) {
+                pending_ -= static_cast<unsigned>(r);
+                if (pending_ == 0) {
+                    return;
+                }
+            } else if (errno != EINTR && errno != EAGAIN) {
+                throw std::system_error(errno, std::generic_category(),
+                                        "io_uring_enter");
+            }
+        }
+    }
+
+    /** Call fn(user_data, result) for the completed reads, result is the
+        byte count or -errno.
+     */
+    template <class Fn>
+    void for_each_completion(Fn fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+            std::uint64_t user_data = cqe.user_data;
+            int res = cqe.res;
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+            fn(user_data, res);
+        }
+    }
+
+   private:
+    int fd_ = -1;
+    unsigned pending_ = 0;
+    unsigned sq_entries_ = 0;
+    void* sq_ring_ = MAP_FAILED;
+    void* cq_ring_ = MAP_FAILED;
+    std::size_t sq_ring_bytes_ = 0;
+    std::size_t cq_ring_bytes_ = 0;
+    io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_mask_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned* cq_mask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    void* mmap_(std::size_t bytes, off_t offset) {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd_, offset);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "io_uring mmap");
+        }
+        return p;
+    }
+
+    void map_(const io_uring_params& p) {
+        sq_entries_ = p.sq_entries;
+        sq_ring_bytes_ = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cq_ring_bytes_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single && cq_ring_bytes_ > sq_ring_bytes_) {
+            sq_ring_bytes_ = cq_ring_bytes_;
+        }
+        sq_ring_ = mmap_(sq_ring_bytes_, IORING_OFF_SQ_RING);
+        cq_ring_ =
+            single ? sq_ring_ : mmap_(cq_ring_bytes_, IORING_OFF_CQ_RING);
+        sqes_ = static_cast<io_uring_sqe*>(
+            mmap_(p.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+
+        char* sq = static_cast<char*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sq_mask_ = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        char* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cq_mask_ = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+    }
+
+    void unmap_() {
+        if (sqes_ != MAP_FAILED) {
+            ::munmap(sqes_, sq_entries_ * sizeof(io_uring_sqe));
+        }
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_bytes_);
+        }
+        if (sq_ring_ != MAP_FAILED) {
+            ::munmap(sq_ring_, sq_ring_bytes_);
+        }
+    }
+};
+
+/**
+   Reads [0, size) of a file into dst in chunks, several at a time, and
+   calls progress(n) each time the first n bytes are complete. read_size
+   (>= size, dst has room for it) is size rounded up for O_DIRECT.
+
+   If a read or progress() fails, the reads in flight are waited for before
+   the exception leaves: dst is not written to afterwards.
+ */
+class ChunkedReader {
+   public:
+    ChunkedReader(int fd, char* dst, std::size_t size, std::size_t read_size,
+                  std::size_t chunk_bytes)
+        : fd_(fd),
+          dst_(dst),
+          size_(size),
+          read_size_(read_size),
+          chunk_bytes_(chunk_bytes),
+          chunks_((read_size + chunk_bytes - 1) / chunk_bytes) {}
+
+    std::size_t chunks() const { return chunks_; }
+
+    template <class Progress>
+    void read_io_uring(IoUring& ring, Progress& progress) {
+        std::vector<std::size_t> got(chunks_, 0);
+        std::vector<char> done(chunks_, 0);
+        std::size_t next_submit = 0;
+        std::size_t next_done = 0;
+        unsigned in_flight = 0;
+        int error = 0;
+        try {
+            while (next_done < chunks_) {
+                while (error == 0 && in_flight < ring.entries() &&
+                       next_submit < chunks_) {
+                    submit_(ring, next_submit++, 0);
+                    ++in_flight;
+                }
+                if (in_flight == 0) {
+                    break;
+                }
+                ring.submit_and_wait(1);
+                ring.for_each_completion([&](std::uint64_t i, int res) {
+                    if (res == -EINTR || res == -EAGAIN) {
+                        submit_(ring, i, got[i]);
+                        return;
+                    }
+                    if (res < 0 || (res == 0 && !at_eof_(i, got[i]))) {
+                        error = error != 0 ? error : res < 0 ? -res : EIO;
+                        --in_flight;
+                        return;
+                    }
+                    got[i] += static_cast<std::size_t>(res);
+                    if (res != 0 && got[i] < length_(i) &&
+                        !at_eof_(i, got[i])) {
+                        // short read
+                        submit_(ring, i, got[i]);
+                        return;
+                    }
+                    done[i] = 1;
+                    --in_flight;
+                });
+                if (error == 0) {
+                    advance_(done.data(), next_done, progress);
+                }
+            }
+        } catch (...) {
+            drain_(ring, in_flight);
+            throw;
+        }
+        if (error != 0) {
+            throw std::system_error(error, std::generic_category(),
+                                    "load_file: read");
+        }
+    }
+
+    template <class Progress>
+    void read_pread(unsigned threads, Progress& progress) {
+        std::unique_ptr<std::atomic<bool>[]> done(
+            new std::atomic<bool>[chunks_]());
+        std::atomic<std::size_t> next{0};
+        std::atomic<int> error{0};
+        std::atomic<bool> stop{false};
+        std::mutex mutex;
+        std::condition_variable ready;
+
+        auto worker = [&]() {
+            for (std::size_t i; !stop.load(std::memory_order_relaxed) &&
+                                (i = next.fetch_add(1)) < chunks_;) {
+                int e = pread_chunk_(i);
+                std::lock_guard<std::mutex> lock(mutex);
+                if (e != 0) {
+                    int expected = 0;
+                    error.compare_exchange_strong(expected, e);
+                    stop.store(true, std::memory_order_relaxed);
+                }
+                done[i].store(true, std::memory_order_release);
+                ready.notify_all();
+            }
+        };
+        std::vector<std::thread> pool;
+        auto join = [&pool, &stop]() {
+            stop.store(true, std::memory_order_relaxed);
+            for (auto& t : pool) {
+                t.join();
+            }
+        };
+
+        try {
+            // started in here: a thread that fails to start joins the
+            // ones before it.
+            std::size_t n = threads < chunks_ ? threads : chunks_;
+            pool.reserve(n);
+            for (std::size_t t = 0; t < n; ++t) {
+                pool.emplace_back(worker);
+            }
+            for (std::size_t i = 0; i < chunks_; ++i) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [&]() {
+                        return done[i].load(std::memory_order_acquire) ||
+                               error.load() != 0;
+                    });
+                }
+                if (error.load() != 0) {
+                    break;
+                }
+                progress(end_(i));
+            }
+        } catch (...) {
+            join();
+            throw;
+        }
+        join();
+        if (error.load() != 0) {
+            throw std::system_error(error.load(), std::generic_category(),
+                                    "load_file: pread");
+        }
+    }
+
+   private:
+    int fd_;
+    char* dst_;
+    std::size_t size_;
+    std::size_t read_size_;
+    std::size_t chunk_bytes_;
+    std::size_t chunks_;
+
+    std::size_t offset_(std::size_t i) const { return i * chunk_bytes_; }
+
+    std::size_t length_(std::size_t i) const {
+        std::size_t left = read_size_ - offset_(i);
+        return left < chunk_bytes_ ? left : chunk_bytes_;
+    }
+
+    // the bytes of size_ covered up to chunk i
+    std::size_t end_(std::size_t i) const {
+        std::size_t end = offset_(i) + length_(i);
+        return end < size_ ? end : size_;
+    }
+
+    // a read may stop short, or return 0, only past the end of the file.
+    bool at_eof_(std::size_t i, std::size_t got) const {
+        return offset_(i) + got >= size_;
+    }
+
+    void submit_(IoUring& ring, std::uint64_t i, std::size_t got) {
+        ring.prepare_read(fd_, dst_ + offset_(i) + got, length_(i) - got,
+                          offset_(i) + got, i);
+    }
+
+    template <class Progress>
+    void advance_(const char* done, std::size_t& next_done,
+                  Progress& progress) {
+        std::size_t first = next_done;
+        while (next_done < chunks_ && done[next_done]) {
+            ++next_done;
+        }
+        if (next_done != first) {
+            progress(end_(next_done - 1));
+        }
+    }
+
+    static void drain_(IoUring& ring, unsigned in_flight) {
+        while (in_flight != 0) {
+            try {
+                ring.submit_and_wait(1);
+            } catch (...) {
+                // nothing more can be done
+                return;
+            }
+            ring.for_each_completion(
+                [&in_flight](std::uint64_t, int) { --in_flight; });
+        }
+    }
+
+    // errno, 0 on success
+    int pread_chunk_(std::size_t i) const {
+        std::size_t got = 0;
+        while (got < length_(i) && !at_eof_(i, got)) {
+            ssize_t r = ::pread(fd_, dst_ + offset_(i) + got, length_(i) - got,
+                                static_cast<off_t>(offset_(i) + got));
+            if (r < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return errno;
+            }
+            if (r == 0) {
+                return at_eof_(i, got) ? 0 : EIO;
+            }
+            got += static_cast<std::size_t>(r);
+        }
+        return 0;
+    }
+};
+
+/**
+   Replaces the content of vec with the elements stored back to back in
+   the file at path, as mapped_vector reads them (a trailing partial
+   element is ignored). Returns what was done; errors throw
+   std::system_error, and leave the elements of vec unspecified.
+
+   Reads are chunk_bytes long, queue_depth of them in flight, into vec's
+   storage directly. on_chunk(first, last) is called on the calling thread
+   with each new range of complete elements, in file order, while the
+   later chunks are still being read: parsing overlaps I/O.
+
+   With direct, the file is opened with O_DIRECT and bypasses the page
+   cache (the data is read once, and does not evict anything). The storage
+   of vec must then be kDirectAlignment aligned, e.g. with
+   aligned_allocator<T, kDirectAlignment>, or std::invalid_argument is
+   thrown. A file system without O_DIRECT (tmpfs) is read through the page
+   cache, with LoadStats::direct false.
+ */
+template <class T, class Allocator, class OnChunk>
+LoadStats load_file(const char* path, v1::vector<T, Allocator>& vec,
+                    const LoadOptions& options, OnChunk on_chunk) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "load_file stores raw bytes of T");
+    if (options.chunk_bytes == 0 || options.queue_depth == 0) {
+        throw std::invalid_argument("load_file: chunk_bytes, queue_depth");
+    }
+    // the length of an io_uring read is 32 bits, even once rounded up.
+    constexpr std::size_t kMaxChunkBytes =
+        UINT32_MAX / kDirectAlignment * kDirectAlignment;
+    if (options.chunk_bytes > kMaxChunkBytes) {
+        throw std::invalid_argument("load_file: chunk_bytes over 4 GiB");
+    }
+    LoadStats stats;
+    int fd = -1;
+    if (options.direct) {
+        fd = ::open(path, O_RDONLY | O_CLOEXEC | O_DIRECT);
+        stats.direct = fd != -1;
+    }
+    if (fd == -1 && (!options.direct || errno == EINVAL)) {
+        fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    }
+    if (fd == -1) {
+        throw std::system_error(errno, std::generic_category(),
+                                "load_file: open");
+    }
+    std::unique_ptr<int, void (*)(int*)> guard(&fd,
+                                               [](int* p) { ::close(*p); });
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        throw std::system_error(errno, std::generic_category(),
+                                "load_file: fstat");
+    }
+    std::size_t n = static_cast<std::size_t>(st.st_size) / sizeof(T);
+    std::size_t size = n * sizeof(T);
+    std::size_t chunk_bytes = options.chunk_bytes;
+    std::size_t read_size = size;
+    if (options.direct) {
+        auto round_up = [](std::size_t x) {
+            return (x + kDirectAlignment - 1) / kDirectAlignment *
+                   kDirectAlignment;
+        };
+        chunk_bytes = round_up(chunk_bytes);
+        // the last block is read whole, into the capacity past size().
+        read_size = round_up(size);
+    }
+
+    vec.clear();
+    vec.reserve((read_size + sizeof(T) - 1) / sizeof(T));
+    // no value-initialization, the reads overwrite every element.
+    vec.resize_default_init(n);
+    if (options.direct &&
+        reinterpret_cast<std::uintptr_t>(vec.data()) % kDirectAlignment != 0) {
+        throw std::invalid_argument(
+            "load_file: direct needs kDirectAlignment aligned storage");
+    }
+    stats.bytes = size;
+    if (size == 0) {
+        return stats;
+    }
+
+    ChunkedReader reader(fd, reinterpret_cast<char*>(vec.data()), size,
+                         read_size, chunk_bytes);
+    stats.chunks = reader.chunks();
+    std::size_t reported = 0;
+    auto progress = [&vec, &reported, &on_chunk](std::size_t bytes) {
+        std::size_t last = bytes / sizeof(T);
+        if (last != reported) {
+            const T* data = vec.data();
+            on_chunk(data + reported, data + last);
+            reported = last;
+        }
+    };
+
+    std::unique_ptr<IoUring> ring;
+    if (options.backend != io_backend::pread) {
+        try {
+            ring.reset(new IoUring(options.queue_depth));
+        } catch (const std::system_error&) {
+            if (options.backend == io_backend::io_uring) {
+                throw;
+            }
+        }
+    }
+    if (ring) {
+        stats.backend = io_backend::io_uring;
+        reader.read_io_uring(*ring, progress);
+    } else {
+        stats.backend = io_backend::pread;
+        reader.read_pread(options.queue_depth, progress);
+    }
+    return stats;
+}
+
+template <class T, class Allocator>
+LoadStats load_file(const char* path, v1::vector<T, Allocator>& vec,
+                    const LoadOptions& options = LoadOptions()) {
+    return load_file(path, vec, options, [](const T*, const T*) {});
+}
+
+}  // namespace detail
+}  // namespace learn_cpp
+#endif
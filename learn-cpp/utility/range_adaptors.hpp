@@ -0,0 +1,595 @@
+#ifndef LEARN_CPP_UTILITY_RANGE_ADAPTORS_HPP
+#define LEARN_CPP_UTILITY_RANGE_ADAPTORS_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../template-metaprogarmming/container_traits.hpp"
+
+namespace learn_cpp {
+namespace detail {
+namespace ranges {
+
+#if defined(DEBUG_RANGE_ADAPTORS)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/*
+   Lazy range adaptors, a small C++17 subset of std::views:
+
+       auto out = vec | views::filter(is_odd) | views::transform(square)
+                      | views::take(10) | ranges::to<v1::vector>();
+
+   A view holds the view under it and the function, its iterator wraps the
+   iterator under it. Nothing is evaluated until the view is iterated, and
+   then every element goes through the whole chain in one loop, with no
+   intermediate container. A view over a container refers to it: the
+   container must outlive the view, and a temporary container can not be
+   adapted.
+
+   Functions are called through a const reference, from the view. Prefer
+   lambdas to function pointers: a pointer is stored in the view and the
+   call through it is often not inlined, which undoes the fusion. A view
+   knows its size() when everything under it does; to() then reserves
+   exactly once.
+ */
+
+struct view_base {};
+
+template <class R>
+struct IsView : Integral<bool, std::is_base_of<view_base, R>::value> {};
+
+template <class R>
+using iterator_t = decltype(std::declval<const R&>().begin());
+
+template <class R>
+using range_value_t =
+    typename std::iterator_traits<iterator_t<R>>::value_type;
+
+template <class It>
+struct IsRandomAccess
+    : Integral<bool, std::is_base_of<std::random_access_iterator_tag,
+                                     typename std::iterator_traits<
+                                         It>::iterator_category>::value> {};
+
+/** [first, last), sized when It is random access.
+ */
+template <class It>
+class iterator_range : public view_base {
+   public:
+    iterator_range() = default;
+    iterator_range(It first, It last) : first_(first), last_(last) {}
+
+    It begin() const { return first_; }
+    It end() const { return last_; }
+    bool empty() const { return first_ == last_; }
+
+    template <class I = It,
+              class = typename EnableIf<IsRandomAccess<I>::value>::type>
+    std::size_t size() const {
+        return static_cast<std::size_t>(last_ - first_);
+    }
+
+   private:
+    It first_{};
+    It last_{};
+};
+
+/** A view of r: a copy of a view, or the iterators of a container.
+ */
+template <class R>
+typename EnableIf<IsView<R>::value, R>::type all(const R& r) {
+    return r;
+}
+
+template <class C>
+typename EnableIf<!IsView<C>::value && IsContainer<C&>::value,
+                  iterator_range<decltype(std::declval<C&>().begin())>>::type
+all(C& c) {
+    return {c.begin(), c.end()};
+}
+
+template <class R>
+using all_t = decltype(all(std::declval<R>()));
+
+template <class V, class Pred>
+class filter_view : public view_base {
+    using base_iterator = iterator_t<V>;
+
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type =
+            typename std::iterator_traits<base_iterator>::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+            typename std::iterator_traits<base_iterator>::reference;
+        using pointer = void;
+
+        iterator() = default;
+        iterator(base_iterator it, base_iterator last, const Pred* pred)
+            : it_(it), last_(last), pred_(pred) {
+            satisfy_();
+        }
+
+        reference operator*() const { return *it_; }
+
+        iterator& operator++() {
+            ++it_;
+            satisfy_();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.it_ == b.it_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        base_iterator it_{};
+        base_iterator last_{};
+        const Pred* pred_ = nullptr;
+
+        void satisfy_() {
+            while (it_ != last_ && !(*pred_)(*it_)) {
+                ++it_;
+            }
+        }
+    };
+
+    filter_view(V base, Pred pred)
+        : base_(std::move(base)), pred_(std::move(pred)) {}
+
+    // O(n) to the first match, every call.
+    iterator begin() const {
+        return iterator(base_.begin(), base_.end(), &pred_);
+    }
+    iterator end() const { return iterator(base_.end(), base_.end(), &pred_); }
+
+   private:
+    V base_;
+    Pred pred_;
+};
+
+template <class V, class F>
+class transform_view : public view_base {
+    using base_iterator = iterator_t<V>;
+
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using reference = decltype(std::declval<const F&>()(
+            *std::declval<base_iterator>()));
+        using value_type = typename std::decay<reference>::type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator() = default;
+        iterator(base_iterator it, const F* f) : it_(it), f_(f) {}
+
+        reference operator*() const { return (*f_)(*it_); }
+
+        iterator& operator++() {
+            ++it_;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++it_;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.it_ == b.it_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        base_iterator it_{};
+        const F* f_ = nullptr;
+    };
+
+    transform_view(V base, F f) : base_(std::move(base)), f_(std::move(f)) {}
+
+    iterator begin() const { return iterator(base_.begin(), &f_); }
+    iterator end() const { return iterator(base_.end(), &f_); }
+
+    template <class W = V,
+              class = typename EnableIf<HasSize<W>::value>::type>
+    std::size_t size() const {
+        return base_.size();
+    }
+
+   private:
+    V base_;
+    F f_;
+};
+
+template <class V>
+class take_view : public view_base {
+    using base_iterator = iterator_t<V>;
+
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type =
+            typename std::iterator_traits<base_iterator>::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+            typename std::iterator_traits<base_iterator>::reference;
+        using pointer = void;
+
+        iterator() = default;
+        iterator(base_iterator it, base_iterator last, std::size_t n)
+            : it_(it), last_(last), n_(n) {}
+
+        reference operator*() const { return *it_; }
+
+        // the last element does not advance the iterator under it, a
+        // filter_view would look for one more match.
+        iterator& operator++() {
+            if (--n_ != 0) {
+                ++it_;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            bool a_done = a.done_();
+            bool b_done = b.done_();
+            return a_done || b_done ? a_done == b_done : a.it_ == b.it_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        base_iterator it_{};
+        base_iterator last_{};
+        std::size_t n_ = 0;
+
+        bool done_() const { return n_ == 0 || it_ == last_; }
+    };
+
+    take_view(V base, std::size_t n) : base_(std::move(base)), n_(n) {}
+
+    iterator begin() const {
+        return iterator(base_.begin(), base_.end(), n_);
+    }
+    iterator end() const { return iterator(base_.end(), base_.end(), 0); }
+
+    template <class W = V,
+              class = typename EnableIf<HasSize<W>::value>::type>
+    std::size_t size() const {
+        std::size_t n = base_.size();
+        return n < n_ ? n : n_;
+    }
+
+   private:
+    V base_;
+    std::size_t n_;
+};
+
+// it advanced by n, or to last if that comes first.
+template <class It>
+It advance_bounded(It it, std::size_t n, It last, std::true_type) {
+    std::size_t left = static_cast<std::size_t>(last - it);
+    return it + static_cast<std::ptrdiff_t>(n < left ? n : left);
+}
+
+template <class It>
+It advance_bounded(It it, std::size_t n, It last, std::false_type) {
+    for (; n != 0 && it != last; --n) {
+        ++it;
+    }
+    return it;
+}
+
+/** Consecutive iterator_ranges of n elements, the last one may be shorter.
+    n == 0 throws std::invalid_argument.
+ */
+template <class V>
+class chunk_view : public view_base {
+    using base_iterator = iterator_t<V>;
+
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = iterator_range<base_iterator>;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;
+        using pointer = void;
+
+        iterator() = default;
+        iterator(base_iterator it, base_iterator last, std::size_t n)
+            : it_(it), last_(last), n_(n) {
+            next_ = advance_(it_);
+        }
+
+        reference operator*() const { return value_type(it_, next_); }
+
+        iterator& operator++() {
+            it_ = next_;
+            next_ = advance_(it_);
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.it_ == b.it_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        base_iterator it_{};
+        base_iterator next_{};
+        base_iterator last_{};
+        std::size_t n_ = 0;
+
+        base_iterator advance_(base_iterator it) const {
+            return advance_bounded(
+                it, n_, last_,
+                std::integral_constant<
+                    bool, IsRandomAccess<base_iterator>::value>());
+        }
+    };
+
+    chunk_view(V base, std::size_t n) : base_(std::move(base)), n_(n) {
+        if (n == 0) {
+            throw std::invalid_argument("chunk_view: chunks of 0 elements");
+        }
+    }
+
+    iterator begin() const {
+        return iterator(base_.begin(), base_.end(), n_);
+    }
+    iterator end() const { return iterator(base_.end(), base_.end(), n_); }
+
+    template <class W = V,
+              class = typename EnableIf<HasSize<W>::value>::type>
+    std::size_t size() const {
+        return (base_.size() + n_ - 1) / n_;
+    }
+
+   private:
+    V base_;
+    std::size_t n_;
+};
+
+/** Pairs of the elements of two views, as long as the shorter one.
+ */
+template <class V1, class V2>
+class zip_view : public view_base {
+    using base_iterator1 = iterator_t<V1>;
+    using base_iterator2 = iterator_t<V2>;
+
+   public:
+    class iterator {
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using reference = std::pair<
+            typename std::iterator_traits<base_iterator1>::reference,
+            typename std::iterator_traits<base_iterator2>::reference>;
+        using value_type = std::pair<
+            typename std::iterator_traits<base_iterator1>::value_type,
+            typename std::iterator_traits<base_iterator2>::value_type>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        iterator() = default;
+        iterator(base_iterator1 it1, base_iterator2 it2)
+            : it1_(it1), it2_(it2) {}
+
+        reference operator*() const { return reference(*it1_, *it2_); }
+
+        iterator& operator++() {
+            ++it1_;
+            ++it2_;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        // either side at its end is the end.
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.it1_ == b.it1_ || a.it2_ == b.it2_;
+        }
+        friend bool operator!=(const iterator& a, const iterator& b) {
+            return !(a == b);
+        }
+
+       private:
+        base_iterator1 it1_{};
+        base_iterator2 it2_{};
+    };
+
+    zip_view(V1 base1, V2 base2)
+        : base1_(std::move(base1)), base2_(std::move(base2)) {}
+
+    iterator begin() const { return iterator(base1_.begin(), base2_.begin()); }
+    iterator end() const { return iterator(base1_.end(), base2_.end()); }
+
+    template <class W1 = V1, class W2 = V2,
+              class = typename EnableIf<HasSize<W1>::value &&
+                                        HasSize<W2>::value>::type>
+    std::size_t size() const {
+        std::size_t n1 = base1_.size();
+        std::size_t n2 = base2_.size();
+        return n1 < n2 ? n1 : n2;
+    }
+
+   private:
+    V1 base1_;
+    V2 base2_;
+};
+
+// r | closure is closure(r).
+struct adaptor_closure_base {};
+
+template <class R, class C,
+          class = typename EnableIf<
+              std::is_base_of<adaptor_closure_base, C>::value>::type>
+auto operator|(R&& r, const C& closure)
+    -> decltype(closure(std::forward<R>(r))) {
+    return closure(std::forward<R>(r));
+}
+
+template <class Pred>
+struct filter_closure : adaptor_closure_base {
+    Pred pred;
+
+    explicit filter_closure(Pred p) : pred(std::move(p)) {}
+
+    template <class R>
+    filter_view<all_t<R>, Pred> operator()(R&& r) const {
+        return {all(std::forward<R>(r)), pred};
+    }
+};
+
+template <class F>
+struct transform_closure : adaptor_closure_base {
+    F f;
+
+    explicit transform_closure(F fn) : f(std::move(fn)) {}
+
+    template <class R>
+    transform_view<all_t<R>, F> operator()(R&& r) const {
+        return {all(std::forward<R>(r)), f};
+    }
+};
+
+template <template <class> class View>
+struct count_closure : adaptor_closure_base {
+    std::size_t n;
+
+    explicit count_closure(std::size_t count) : n(count) {}
+
+    template <class R>
+    View<all_t<R>> operator()(R&& r) const {
+        return {all(std::forward<R>(r)), n};
+    }
+};
+
+namespace views {
+
+template <class Pred>
+filter_closure<typename std::decay<Pred>::type> filter(Pred&& pred) {
+    return filter_closure<typename std::decay<Pred>::type>(
+        std::forward<Pred>(pred));
+}
+
+template <class F>
+transform_closure<typename std::decay<F>::type> transform(F&& f) {
+    return transform_closure<typename std::decay<F>::type>(
+        std::forward<F>(f));
+}
+
+inline count_closure<take_view> take(std::size_t n) {
+    return count_closure<take_view>(n);
+}
+
+inline count_closure<chunk_view> chunk(std::size_t n) {
+    return count_closure<chunk_view>(n);
+}
+
+template <class R1, class R2>
+zip_view<all_t<R1>, all_t<R2>> zip(R1&& r1, R2&& r2) {
+    return {all(std::forward<R1>(r1)), all(std::forward<R2>(r2))};
+}
+
+}  // namespace views
+
+template <class Container, class V>
+void reserve_for_(Container& out, const V& v, std::true_type) {
+    out.reserve(v.size());
+}
+
+template <class Container, class V>
+void reserve_for_(Container&, const V&, std::false_type) {}
+
+template <class Container>
+struct to_closure : adaptor_closure_base {
+    template <class R>
+    Container operator()(R&& r) const {
+        auto v = all(std::forward<R>(r));
+        using sized = std::integral_constant<
+            bool, HasReserve<Container>::value && HasSize<decltype(v)>::value>;
+        Container out;
+        reserve_for_(out, v, sized());
+        auto last = v.end();
+        for (auto it = v.begin(); it != last; ++it) {
+            out.push_back(*it);
+        }
+        return out;
+    }
+};
+
+template <template <class...> class Container>
+struct to_template_closure : adaptor_closure_base {
+    template <class R>
+    Container<range_value_t<all_t<R>>> operator()(R&& r) const {
+        return to_closure<Container<range_value_t<all_t<R>>>>()(
+            std::forward<R>(r));
+    }
+};
+
+/** The elements of a view in a new Container, e.g. to<std::list<int>>().
+ */
+template <class Container>
+to_closure<Container> to() {
+    return {};
+}
+
+/** The elements of a view in a new Container of its value_type, e.g.
+    to<v1::vector>().
+ */
+template <template <class...> class Container>
+to_template_closure<Container> to() {
+    return {};
+}
+
+#undef ASSERT
+
+}  // namespace ranges
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif
@@ -0,0 +1,124 @@
+#include <array>
+#include <cassert>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "container_copy.hpp"
+
+using learn_cpp::detail::append;
+using learn_cpp::detail::copy_into;
+using learn_cpp::detail::copy_path;
+using learn_cpp::detail::HasReserve;
+using learn_cpp::detail::IsContiguousContainer;
+using learn_cpp::detail::IsTriviallyRelocatable;
+using learn_cpp::detail::select_copy_path;
+
+template <typename T>
+using Vector = learn_cpp::detail::v1::vector<T>;
+
+void test_traits();
+void test_container_copy_1();
+void test_container_copy_2();
+
+int main() {
+    test_traits();
+    test_container_copy_1();
+    test_container_copy_2();
+}
+
+void test_traits() {
+    static_assert(IsContiguousContainer<std::vector<int>>::value, "");
+    static_assert(!IsContiguousContainer<std::vector<bool>>::value, "");
+    static_assert(IsContiguousContainer<std::array<int, 3>>::value, "");
+    static_assert(IsContiguousContainer<std::string>::value, "");
+    static_assert(IsContiguousContainer<Vector<int>>::value, "");
+    static_assert(!IsContiguousContainer<std::list<int>>::value, "");
+    static_assert(!IsContiguousContainer<std::deque<int>>::value, "");
+
+    static_assert(IsTriviallyRelocatable<int>::value, "");
+    static_assert(IsTriviallyRelocatable<Vector<std::string>>::value, "");
+    static_assert(IsTriviallyRelocatable<std::unique_ptr<int>>::value, "");
+    static_assert(!IsTriviallyRelocatable<std::string>::value, "");
+
+    static_assert(HasReserve<std::vector<int>>::value, "");
+    static_assert(HasReserve<Vector<int>>::value, "");
+    static_assert(HasReserve<std::string>::value, "");
+    static_assert(!HasReserve<std::list<int>>::value, "");
+    static_assert(!HasReserve<std::deque<int>>::value, "");
+
+    static_assert(select_copy_path<Vector<int>, std::vector<int>>() ==
+                      copy_path::memcpy,
+                  "");
+    static_assert(select_copy_path<std::vector<long>, std::vector<int>>() ==
+                      copy_path::reserve_then_copy,
+                  "");
+    static_assert(select_copy_path<Vector<std::string>,
+                                   std::vector<std::string>>() ==
+                      copy_path::reserve_then_copy,
+                  "");
+    static_assert(select_copy_path<std::list<int>, std::vector<int>>() ==
+                      copy_path::element_wise,
+                  "");
+}
+
+// every path gives the same result
+void test_container_copy_1() {
+    std::vector<int> src{1, 2, 3, 4, 5};
+
+    Vector<int> dst1{0};
+    assert(append(dst1, src) == copy_path::memcpy);
+    assert(dst1.size() == 6);
+    assert(dst1[0] == 0 && dst1[5] == 5);
+
+    std::vector<long> dst2;
+    assert(append(dst2, src) == copy_path::reserve_then_copy);
+    assert(dst2.size() == 5 && dst2[4] == 5);
+
+    std::list<int> dst3;
+    assert(append(dst3, src) == copy_path::element_wise);
+    assert(dst3.size() == 5 && dst3.back() == 5);
+
+    std::vector<int> empty;
+    assert(append(dst1, empty) == copy_path::memcpy);
+    assert(dst1.size() == 6);
+
+    // appending a container to itself doubles it, on every path
+    assert(append(dst1, dst1) == copy_path::memcpy);
+    assert(dst1.size() == 12 && dst1[6] == 0 && dst1[11] == 5);
+    std::vector<std::string> strings{"a", "b"};
+    assert(append(strings, strings) == copy_path::reserve_then_copy);
+    assert((strings == std::vector<std::string>{"a", "b", "a", "b"}));
+    assert(append(dst3, dst3) == copy_path::element_wise);
+    assert(dst3.size() == 10 && dst3.front() == 1 && dst3.back() == 5);
+}
+
+// copy_into replaces the content, and v1::vector reallocation relocates
+void test_container_copy_2() {
+    std::vector<std::string> src{"a", "bb", "ccc"};
+    Vector<std::string> dst1{"x", "y", "z", "w"};
+    copy_into(dst1, src);
+    assert(dst1.size() == 3);
+    assert(dst1[2] == "ccc");
+
+    Vector<int> dst2{9, 9, 9};
+    copy_into(dst2, std::vector<int>{7, 8});
+    assert(dst2.size() == 2 && dst2[0] == 7 && dst2[1] == 8);
+
+    // v1::vector of v1::vector is trivially relocatable: growing the outer
+    // one memcpys the inner headers.
+    Vector<Vector<int>> nested;
+    for (int i = 0; i < 100; ++i) {
+        nested.emplace_back(std::size_t(3), i);
+    }
+    for (int i = 0; i < 100; ++i) {
+        assert(nested[i].size() == 3 && nested[i][2] == i);
+    }
+
+    Vector<int> reserved;
+    reserved.reserve(100);
+    assert(reserved.capacity() == 100 && reserved.empty());
+}
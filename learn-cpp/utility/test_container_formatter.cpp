@@ -0,0 +1,111 @@
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "container_formatter.hpp"
+
+using learn_cpp::detail::ContainerFormatter;
+using learn_cpp::detail::print_container;
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << '\n'; }
+
+struct Point {
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const Point& p) {
+    return os << '(' << p.x << ' ' << p.y << ')';
+}
+
+void test_container_formatter_1();
+void test_container_formatter_2();
+void test_container_formatter_3();
+
+int main() {
+    test_container_formatter_1();
+    test_container_formatter_2();
+    test_container_formatter_3();
+}
+
+// same layout as the operator<< overloads in tmp-basics-trait-IsContainer.cpp
+void test_container_formatter_1() {
+    ContainerFormatter formatter;
+
+    std::vector<int> ivec{1, 3, 5, 7};
+    formatter.append(ivec);
+    assert(formatter.str() == "{ 1, 3, 5, 7, }");
+
+    formatter.clear();
+    std::vector<std::vector<int>> vec2d = {{1, 2, 4}, {10, 100, 1000}};
+    formatter.append(vec2d);
+    assert(formatter.str() ==
+           "{\n"
+           "    { 1, 2, 4, },\n"
+           "    { 10, 100, 1000, },\n"
+           "}");
+
+    std::ostringstream oss;
+    print_container(oss, ivec);
+    assert(oss.str() == "{ 1, 3, 5, 7, }");
+}
+
+// depth 3, and element types other than int
+void test_container_formatter_2() {
+    ContainerFormatter formatter;
+
+    std::vector<std::vector<std::list<int>>> vec3d = {{{1}, {2, 3}}, {{}}};
+    formatter.append(vec3d);
+    SHOW(formatter.str());
+    assert(formatter.str() ==
+           "{\n"
+           "    {\n"
+           "        { 1, },\n"
+           "        { 2, 3, },\n"
+           "    },\n"
+           "    {\n"
+           "        { },\n"
+           "    },\n"
+           "}");
+
+    formatter.clear();
+    std::vector<std::string> svec{"ab", "c"};
+    formatter.append(svec);
+    assert(formatter.str() == "{ ab, c, }");
+
+    formatter.clear();
+    std::vector<double> dvec{0.5, -2, 0.1};
+    formatter.append(dvec);
+    assert(formatter.str() == "{ 0.5, -2, 0.1, }");
+
+    formatter.clear();
+    std::vector<char> cvec{'x', 'y'};
+    std::vector<bool> bvec{true, false};
+    formatter.append(cvec).append(bvec);
+    assert(formatter.str() == "{ x, y, }{ 1, 0, }");
+
+    // as characters, like operator<<
+    formatter.clear();
+    std::vector<signed char> scvec{'s', 'c'};
+    std::vector<unsigned char> ucvec{'u', 'c'};
+    formatter.append(scvec).append(ucvec);
+    assert(formatter.str() == "{ s, c, }{ u, c, }");
+}
+
+// fall back to operator<< for other types
+void test_container_formatter_3() {
+    ContainerFormatter formatter;
+    std::vector<Point> pvec{{1, 2}, {3, 4}};
+    formatter.append(pvec);
+    assert(formatter.str() == "{ (1 2), (3 4), }");
+
+    // the buffer is reused
+    auto capacity = formatter.str().capacity();
+    formatter.clear();
+    formatter.append(pvec);
+    assert(formatter.str().capacity() == capacity);
+}
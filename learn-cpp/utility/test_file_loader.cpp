@@ -0,0 +1,179 @@
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "../memory/aligned_allocator.hpp"
+#include "file_loader.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+using learn_cpp::detail::aligned_allocator;
+using learn_cpp::detail::io_backend;
+using learn_cpp::detail::kDirectAlignment;
+using learn_cpp::detail::load_file;
+using learn_cpp::detail::LoadOptions;
+using learn_cpp::detail::LoadStats;
+using learn_cpp::detail::v1::vector;
+
+void test_file_loader_1(const std::string& path);
+void test_file_loader_2(const std::string& path);
+void test_file_loader_3(const std::string& path);
+
+int main() {
+    std::string path =
+        "/tmp/test_file_loader." + std::to_string(::getpid()) + ".bin";
+    test_file_loader_1(path);
+    test_file_loader_2(path);
+    test_file_loader_3(path);
+    std::remove(path.c_str());
+}
+
+// n values i * 3, and a trailing partial element
+void write_file(const std::string& path, std::size_t n) {
+    std::FILE* fp = std::fopen(path.c_str(), "wb");
+    assert(fp != nullptr);
+    for (std::uint64_t i = 0; i < n; ++i) {
+        std::uint64_t v = i * 3;
+        std::fwrite(&v, sizeof(v), 1, fp);
+    }
+    std::fwrite("abc", 1, 3, fp);
+    std::fclose(fp);
+}
+
+const char* backend_name(io_backend b) {
+    return b == io_backend::io_uring ? "io_uring"
+           : b == io_backend::pread  ? "pread"
+                                     : "automatic";
+}
+
+template <class Vector>
+void check(const Vector& vec, std::size_t n) {
+    assert(vec.size() == n);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(vec[i] == i * 3);
+    }
+}
+
+// both backends, chunks that split elements, callbacks in order
+void test_file_loader_1(const std::string& path) {
+    const std::size_t n = 100000;
+    write_file(path, n);
+    for (io_backend backend :
+         {io_backend::automatic, io_backend::io_uring, io_backend::pread}) {
+        LoadOptions options;
+        options.chunk_bytes = 1000;
+        options.queue_depth = 3;
+        options.backend = backend;
+        vector<std::uint64_t> vec(5, std::uint64_t(7));
+        std::size_t next = 0;
+        std::size_t calls = 0;
+        LoadStats stats;
+        try {
+            stats = load_file(path.c_str(), vec, options,
+                              [&vec, &next, &calls](const std::uint64_t* first,
+                                                    const std::uint64_t* last) {
+                                  assert(first == vec.data() + next);
+                                  assert(first < last);
+                                  for (; first != last; ++first, ++next) {
+                                      assert(*first == next * 3);
+                                  }
+                                  ++calls;
+                              });
+        } catch (const std::system_error& e) {
+            // a kernel without io_uring
+            assert(backend == io_backend::io_uring);
+            SHOW(e.what());
+            continue;
+        }
+        SHOW(backend_name(stats.backend));
+        SHOW(calls);
+        assert(backend == io_backend::automatic || stats.backend == backend);
+        assert(stats.bytes == n * 8 && !stats.direct);
+        assert(stats.chunks == (n * 8 + 999) / 1000);
+        assert(next == n && calls > 1 && calls <= stats.chunks);
+        check(vec, n);
+    }
+
+    // the defaults
+    vector<std::uint64_t> vec;
+    LoadStats stats = load_file(path.c_str(), vec);
+    assert(stats.chunks == 1);
+    check(vec, n);
+}
+
+// O_DIRECT into aligned storage
+void test_file_loader_2(const std::string& path) {
+    const std::size_t n = 3 * kDirectAlignment / 8 + 5;
+    write_file(path, n);
+    for (io_backend backend : {io_backend::automatic, io_backend::pread}) {
+        LoadOptions options;
+        options.direct = true;
+        options.chunk_bytes = 5000;
+        options.backend = backend;
+        vector<std::uint64_t, aligned_allocator<std::uint64_t, 4096>> vec;
+        LoadStats stats = load_file(path.c_str(), vec, options);
+        SHOW(stats.direct);
+        // rounded up to whole blocks
+        assert(stats.chunks == 2);
+        check(vec, n);
+    }
+}
+
+// errors, empty files
+void test_file_loader_3(const std::string& path) {
+    vector<int> vec(3);
+    bool thrown = false;
+    try {
+        load_file("/nonexistent/file", vec);
+    } catch (const std::system_error& e) {
+        SHOW(e.what());
+        thrown = true;
+    }
+    assert(thrown && vec.size() == 3);
+
+    // a read length must fit the 32 bits of io_uring
+    LoadOptions huge;
+    huge.chunk_bytes = std::size_t(1) << 32;
+    thrown = false;
+    try {
+        load_file(path.c_str(), vec, huge);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && vec.size() == 3);
+
+    write_file(path, 0);
+    vector<std::uint64_t> empty(4);
+    LoadStats stats = load_file(path.c_str(), empty);
+    assert(empty.empty() && stats.bytes == 0 && stats.chunks == 0);
+
+    // the callback throws: the reads in flight finish first
+    const std::size_t n = 200000;
+    write_file(path, n);
+    for (io_backend backend : {io_backend::automatic, io_backend::pread}) {
+        LoadOptions options;
+        options.chunk_bytes = 4096;
+        options.backend = backend;
+        vector<std::uint64_t> vec2;
+        thrown = false;
+        try {
+            load_file(path.c_str(), vec2, options,
+                      [](const std::uint64_t*, const std::uint64_t* last) {
+                          if (last[-1] > 3000) {
+                              throw std::runtime_error("stop");
+                          }
+                      });
+        } catch (const std::runtime_error& e) {
+            thrown = std::string(e.what()) == "stop";
+        }
+        assert(thrown);
+    }
+}
@@ -0,0 +1,165 @@
+#include <cassert>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "range_adaptors.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+namespace ranges = learn_cpp::detail::ranges;
+namespace views = learn_cpp::detail::ranges::views;
+using learn_cpp::detail::HasSize;
+using learn_cpp::detail::IsContainer;
+using learn_cpp::detail::v1::vector;
+
+void test_range_adaptors_1();
+void test_range_adaptors_2();
+void test_range_adaptors_3();
+
+int main() {
+    test_range_adaptors_1();
+    test_range_adaptors_2();
+    test_range_adaptors_3();
+}
+
+// filter -> transform -> take, lazily
+void test_range_adaptors_1() {
+    vector<int> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(i);
+    }
+    int tested = 0;
+    int squared = 0;
+    auto view = vec | views::filter([&tested](int x) {
+                    ++tested;
+                    return x % 3 == 0;
+                }) |
+                views::transform([&squared](int x) {
+                    ++squared;
+                    return x * x;
+                }) |
+                views::take(4);
+    static_assert(IsContainer<decltype(view)>::value, "a view is a range");
+    // nothing happens until it is iterated
+    assert(tested == 0 && squared == 0);
+
+    auto out = view | ranges::to<vector>();
+    static_assert(std::is_same<decltype(out), vector<int>>::value, "");
+    assert(out.size() == 4);
+    assert(out[0] == 0 && out[1] == 9 && out[2] == 36 && out[3] == 81);
+    // up to 9 and no further, each element squared once
+    SHOW(tested);
+    assert(tested == 10 && squared == 4);
+
+    // the same as the eager chain
+    std::vector<int> eager;
+    for (int x : vec) {
+        if (x % 3 == 0 && eager.size() < 4) {
+            eager.push_back(x * x);
+        }
+    }
+    assert(std::vector<int>(out.begin(), out.end()) == eager);
+
+    // a filter does not know its size, so nothing is reserved up front
+    static_assert(!HasSize<decltype(view)>::value, "");
+    auto sized = vec | views::transform([](int x) { return x + 1; }) |
+                 views::take(10);
+    static_assert(HasSize<decltype(sized)>::value, "");
+    assert(sized.size() == 10);
+    auto exact = sized | ranges::to<vector>();
+    assert(exact.size() == 10 && exact.capacity() == 10);
+    assert(exact[9] == 10);
+
+    // writes go through to the container
+    for (int& x : vec | views::take(3)) {
+        x = -x - 1;
+    }
+    assert(vec[0] == -1 && vec[2] == -3 && vec[3] == 3);
+}
+
+// chunk, over random access and list iterators
+void test_range_adaptors_2() {
+    vector<int> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+    }
+    auto chunks = vec | views::chunk(4);
+    assert(chunks.size() == 3);
+    std::vector<std::size_t> sizes;
+    std::vector<int> sums;
+    for (auto chunk : chunks) {
+        int sum = 0;
+        for (int x : chunk) {
+            sum += x;
+        }
+        sizes.push_back(chunk.size());
+        sums.push_back(sum);
+    }
+    assert((sizes == std::vector<std::size_t>{4, 4, 2}));
+    assert((sums == std::vector<int>{6, 22, 17}));
+
+    // chunks of a view, and to<> a full container type
+    std::list<int> list(vec.begin(), vec.end());
+    auto firsts = list | views::filter([](int x) { return x % 2 == 1; }) |
+                  views::chunk(2) | views::transform([](const auto& chunk) {
+                      return *chunk.begin();
+                  });
+    static_assert(!HasSize<decltype(firsts)>::value, "");
+    auto counts = firsts | ranges::to<std::vector<long>>();
+    assert((counts == std::vector<long>{1, 5, 9}));
+
+    const vector<int> empty;
+    auto none = empty | views::chunk(3) | ranges::to<std::vector>();
+    assert(none.empty());
+
+    bool thrown = false;
+    try {
+        auto zero = vec | views::chunk(0);
+        (void)zero;
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// zip
+void test_range_adaptors_3() {
+    vector<int> ids;
+    std::vector<std::string> names = {"a", "b", "c"};
+    for (int i = 0; i < 5; ++i) {
+        ids.push_back(i * 10);
+    }
+    auto zipped = views::zip(ids, names);
+    assert(zipped.size() == 3);
+    auto pairs = zipped | ranges::to<vector>();
+    static_assert(std::is_same<decltype(pairs),
+                               vector<std::pair<int, std::string>>>::value,
+                  "");
+    assert(pairs.size() == 3);
+    assert(pairs[2].first == 20 && pairs[2].second == "c");
+
+    // references into both sides
+    for (auto p : views::zip(ids, names)) {
+        p.first += 1;
+        p.second += "!";
+    }
+    assert(ids[0] == 1 && ids[3] == 30 && names[1] == "b!");
+
+    // zip of views
+    auto doubled = ids | views::transform([](int x) { return 2 * x; });
+    auto odd_names = names | views::filter([](const std::string& s) {
+                         return s != "b!";
+                     });
+    int n = 0;
+    for (auto p : views::zip(doubled, odd_names) | views::take(5)) {
+        assert(p.first == 2 * ids[n]);
+        ++n;
+    }
+    assert(n == 2);
+}
@@ -0,0 +1,124 @@
+#if !defined(LEARN_CPP_TRACE)
+#define LEARN_CPP_TRACE
+#endif
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../implement-std-library/c++11/shared_ptr.hpp"
+#include "../implement-std-library/c++11/vector.hpp"
+#include "trace.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+namespace trace = learn_cpp::detail::trace;
+
+void test_trace_1();
+void test_trace_2();
+void test_trace_3();
+
+int main() {
+    test_trace_1();
+    test_trace_2();
+    test_trace_3();
+}
+
+std::size_t count_events(const char* name) {
+    std::size_t n = 0;
+    trace::for_each_event([name, &n](const trace::Event& e) {
+        n += std::strcmp(e.name, name) == 0;
+    });
+    return n;
+}
+
+// macros, threads
+void test_trace_1() {
+    trace::clear();
+    {
+        LEARN_CPP_TRACE_SCOPE("outer");
+        LEARN_CPP_TRACE_SCOPE("inner");
+        LEARN_CPP_TRACE_INSTANT("tick");
+    }
+    assert(count_events("outer") == 1 && count_events("inner") == 1);
+    assert(count_events("tick") == 1);
+
+    // inner ends first, and lies within outer
+    std::vector<trace::Event> events;
+    trace::for_each_event(
+        [&events](const trace::Event& e) { events.push_back(e); });
+    assert(events.size() == 3);
+    assert(std::strcmp(events[1].name, "inner") == 0);
+    assert(events[2].start <= events[1].start);
+    assert(events[1].start + events[1].duration <=
+           events[2].start + events[2].duration);
+    assert(events[0].phase == 'i' && events[2].phase == 'X');
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 100; ++i) {
+                LEARN_CPP_TRACE_SCOPE("worker");
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    assert(count_events("worker") == 400);
+
+    trace::clear();
+    assert(count_events("worker") == 0 && trace::dropped() == 0);
+}
+
+// the hooks in v1::vector and SharedPtr
+void test_trace_2() {
+    using learn_cpp::detail::SharedPtr;
+    using learn_cpp::detail::v1::vector;
+
+    trace::clear();
+    vector<int> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    std::size_t reallocations = count_events("vector::reallocate");
+    SHOW(reallocations);
+    assert(reallocations > 0 && reallocations < 20);
+
+    {
+        SharedPtr<int> sp1(new int(1));
+        auto sp2 = sp1;
+        sp2.reset();
+        assert(count_events("SharedCount::on_zero_shared") == 0);
+    }
+    assert(count_events("SharedCount::on_zero_shared") == 1);
+}
+
+// overflow and the JSON
+void test_trace_3() {
+    trace::clear();
+    for (std::size_t i = 0; i < trace::kRingSize + 10; ++i) {
+        LEARN_CPP_TRACE_INSTANT("spin \"quoted\"");
+    }
+    assert(trace::dropped() == 10);
+    trace::clear();
+
+    LEARN_CPP_TRACE_INSTANT("a\\b");
+    {
+        LEARN_CPP_TRACE_SCOPE("span");
+    }
+    std::ostringstream out;
+    trace::write_chrome_json(out);
+    std::string json = out.str();
+    std::cout << json;
+    assert(json.find("\"traceEvents\":[") != std::string::npos);
+    assert(json.find("{\"name\":\"a\\\\b\",\"ph\":\"i\"") != std::string::npos);
+    assert(json.find("{\"name\":\"span\",\"ph\":\"X\"") != std::string::npos);
+    assert(json.find(",\"dur\":") != std::string::npos);
+    assert(json.substr(json.size() - 4) == "\n]}\n");
+}
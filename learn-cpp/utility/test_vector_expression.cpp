@@ -0,0 +1,132 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "vector_expression.hpp"
+
+#define SHOW(...) \
+    { std::cout << #__VA_ARGS__ " = " << __VA_ARGS__ << std::endl; }
+
+using learn_cpp::detail::assign;
+using learn_cpp::detail::binary_expr;
+using learn_cpp::detail::evaluate;
+using learn_cpp::detail::IsVectorOperand;
+using learn_cpp::detail::vector_ref;
+using learn_cpp::detail::v1::vector;
+
+void test_vector_expression_1();
+void test_vector_expression_2();
+void test_vector_expression_3();
+
+int main() {
+    test_vector_expression_1();
+    test_vector_expression_2();
+    test_vector_expression_3();
+}
+
+vector<double> iota(std::size_t n, double first) {
+    vector<double> vec;
+    for (std::size_t i = 0; i < n; ++i) {
+        vec.push_back(first + double(i));
+    }
+    return vec;
+}
+
+// a * b + c is a tree, evaluated once
+void test_vector_expression_1() {
+    auto a = iota(100, 1);
+    auto b = iota(100, 2);
+    auto c = iota(100, 3);
+    auto expr = a * b + c;
+    static_assert(
+        std::is_same<decltype(expr),
+                     binary_expr<std::plus<>,
+                                 binary_expr<std::multiplies<>,
+                                             vector_ref<double>,
+                                             vector_ref<double>>,
+                                 vector_ref<double>>>::value,
+        "a * b + c is a compile-time tree");
+    assert(expr.size() == 100);
+    assert(expr[10] == 11.0 * 12.0 + 13.0);
+
+    auto d = evaluate(expr);
+    static_assert(std::is_same<decltype(d), vector<double>>::value, "");
+    assert(d.size() == 100);
+    for (std::size_t i = 0; i < d.size(); ++i) {
+        assert(d[i] == a[i] * b[i] + c[i]);
+    }
+
+    auto e = evaluate((a - b) / 2.0 - -c * 3.0);
+    for (std::size_t i = 0; i < e.size(); ++i) {
+        assert(e[i] == (a[i] - b[i]) / 2.0 + c[i] * 3.0);
+    }
+    auto f = evaluate(1.0 - a);
+    assert(f[0] == 0.0 && f[99] == -99.0);
+}
+
+// assign reuses the buffer, also when out is an operand
+void test_vector_expression_2() {
+    auto a = iota(1000, 0);
+    auto b = iota(1000, 1);
+    vector<double> out = iota(1000, 5);
+    const double* buffer = out.data();
+    assign(out, a * b);
+    assert(out.data() == buffer && out.size() == 1000);
+    assert(out[7] == 7.0 * 8.0);
+
+    assign(a, a * a + a);
+    assert(a[3] == 12.0);
+
+    // a smaller result keeps the capacity
+    auto small = iota(10, 0);
+    assign(out, small + small);
+    assert(out.data() == buffer && out.size() == 10 && out[9] == 18.0);
+
+    vector<double> empty;
+    assign(out, empty * 2.0);
+    assert(out.empty());
+    assign(out, 2.0 - empty + empty);
+    assert(out.empty());
+
+    // an empty vector is not a scalar
+    auto four = iota(4, 1);
+    bool thrown = false;
+    try {
+        assign(out, four + empty);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+// element types follow the usual promotions
+void test_vector_expression_3() {
+    vector<int> i;
+    vector<float> f;
+    for (int k = 0; k < 8; ++k) {
+        i.push_back(k);
+        f.push_back(float(k) / 2);
+    }
+    auto ints = evaluate(i * i - 3);
+    static_assert(std::is_same<decltype(ints), vector<int>>::value, "");
+    assert(ints[2] == 1);
+    auto floats = evaluate(i * f);
+    static_assert(std::is_same<decltype(floats), vector<float>>::value, "");
+    assert(floats[3] == 4.5f);
+    auto doubles = evaluate(f * 0.5);
+    static_assert(std::is_same<decltype(doubles), vector<double>>::value, "");
+
+    // assigned with a conversion
+    vector<std::int64_t> wide;
+    assign(wide, f * 4);
+    SHOW(wide[7]);
+    assert(wide.size() == 8 && wide[7] == 14);
+
+    static_assert(IsVectorOperand<vector<double>>::value, "");
+    static_assert(!IsVectorOperand<vector<std::string>>::value, "");
+    static_assert(!IsVectorOperand<double>::value, "");
+}
@@ -0,0 +1,304 @@
+#ifndef LEARN_CPP_UTILITY_TRACE_HPP
+#define LEARN_CPP_UTILITY_TRACE_HPP
+
+/*
+   Event tracing, compiled in only when LEARN_CPP_TRACE is defined (cmake
+   -DLEARN_CPP_TRACE=ON, or #define before the first include). Otherwise
+   the macros below expand to nothing.
+
+       void work() {
+           LEARN_CPP_TRACE_SCOPE("work");   // a span from here to the '}'
+           LEARN_CPP_TRACE_INSTANT("tick"); // a point in time
+       }
+       learn_cpp::detail::trace::write_chrome_json("trace.json");
+
+   The JSON opens in Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+   Every thread writes into its own ring of kRingSize events: no lock and
+   no shared cache line, the cost of a span is two timestamps and a 32 byte
+   store. Timestamps are rdtsc ticks on x86 (constant rate on current CPUs,
+   about half the cost of clock_gettime), converted to nanoseconds at flush
+   against CLOCK_MONOTONIC; clock_gettime() elsewhere. When a ring is full
+   the oldest events are overwritten and counted in dropped(). Names must
+   be string literals.
+
+   Rings are never freed, the events of finished threads stay until the
+   next clear(); a new thread reuses a free ring. Flush (and clear) while
+   the traced threads are idle: an event that is being written is not
+   synchronized with the reader.
+ */
+
+#if defined(LEARN_CPP_TRACE)
+
+#include <time.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+
+namespace learn_cpp {
+namespace detail {
+namespace trace {
+
+constexpr std::size_t kRingSize = std::size_t(1) << 14;
+
+struct Event {
+    const char* name;
+    // in ticks, see to_ns()
+    std::uint64_t start;
+    std::uint64_t duration;
+    std::uint32_t tid;
+    // 'X' a span, 'i' an instant
+    char phase;
+};
+
+struct alignas(64) Ring {
+    // events ever written, and the first one not cleared.
+    std::atomic<std::uint64_t> head{0};
+    std::atomic<std::uint64_t> start{0};
+    std::atomic<bool> in_use{false};
+    Ring* next = nullptr;
+    Event events[kRingSize];
+};
+
+inline std::uint64_t now_ns() {
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return std::uint64_t(ts.tv_sec) * 1000000000u + std::uint64_t(ts.tv_nsec);
+}
+
+inline std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return now_ns();
+#endif
+}
+
+struct ClockPair {
+    std::uint64_t ticks;
+    std::uint64_t ns;
+};
+
+// taken before the first event.
+inline const ClockPair& clock_origin() {
+    static const ClockPair origin{now(), now_ns()};
+    return origin;
+}
+
+/** Converts ticks to nanoseconds, from the tick rate measured since the
+    first event (at least 1 ms).
+ */
+class TickConverter {
+   public:
+    TickConverter() : origin_(clock_origin()) {
+        std::uint64_t ns = now_ns();
+        while (ns - origin_.ns < 1000000) {
+            ns = now_ns();
+        }
+        std::uint64_t ticks = now();
+        ns_per_tick_ = double(ns - origin_.ns) / double(ticks - origin_.ticks);
+    }
+
+    std::uint64_t to_ns(std::uint64_t ticks) const {
+        double delta = double(std::int64_t(ticks - origin_.ticks));
+        return origin_.ns + std::uint64_t(std::int64_t(delta * ns_per_tick_));
+    }
+
+    std::uint64_t duration_ns(std::uint64_t ticks) const {
+        return std::uint64_t(double(ticks) * ns_per_tick_);
+    }
+
+   private:
+    ClockPair origin_;
+    double ns_per_tick_;
+};
+
+inline std::atomic<Ring*>& registry_head() {
+    static std::atomic<Ring*> head{nullptr};
+    return head;
+}
+
+inline Ring* acquire_ring() {
+    clock_origin();
+    auto& head = registry_head();
+    for (auto* r = head.load(std::memory_order_acquire); r != nullptr;
+         r = r->next) {
+        bool expected = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true,
+                                              std::memory_order_acquire)) {
+            return r;
+        }
+    }
+    auto* r = new Ring();
+    r->in_use.store(true, std::memory_order_relaxed);
+    r->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(r->next, r, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+    }
+    return r;
+}
+
+struct ThreadRing {
+    Ring* ring = acquire_ring();
+    std::uint32_t tid = next_tid();
+
+    ~ThreadRing() { ring->in_use.store(false, std::memory_order_release); }
+
+    static std::uint32_t next_tid() {
+        static std::atomic<std::uint32_t> tid{0};
+        return tid.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+};
+
+inline ThreadRing& local() {
+    thread_local ThreadRing handle;
+    return handle;
+}
+
+inline void record(const char* name, std::uint64_t start,
+                   std::uint64_t duration, char phase) {
+    ThreadRing& t = local();
+    Ring& r = *t.ring;
+    std::uint64_t h = r.head.load(std::memory_order_relaxed);
+    Event& e = r.events[h & (kRingSize - 1)];
+    e.name = name;
+    e.start = start;
+    e.duration = duration;
+    e.tid = t.tid;
+    e.phase = phase;
+    r.head.store(h + 1, std::memory_order_release);
+}
+
+inline void instant(const char* name) { record(name, now(), 0, 'i'); }
+
+/** Records a span from construction to destruction.
+ */
+class Scope {
+   public:
+    explicit Scope(const char* name) : name_(name), start_(now()) {}
+
+    ~Scope() { record(name_, start_, now() - start_, 'X'); }
+
+    // not copyable
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    const char* name_;
+    std::uint64_t start_;
+};
+
+/** Call fn(const Event&) on the recorded events, ring by ring, oldest
+    first.
+ */
+template <class Fn>
+void for_each_event(Fn fn) {
+    for (auto* r = registry_head().load(std::memory_order_acquire);
+         r != nullptr; r = r->next) {
+        std::uint64_t h = r->head.load(std::memory_order_acquire);
+        std::uint64_t first = r->start.load(std::memory_order_relaxed);
+        if (h - first > kRingSize) {
+            first = h - kRingSize;
+        }
+        for (std::uint64_t i = first; i < h; ++i) {
+            fn(r->events[i & (kRingSize - 1)]);
+        }
+    }
+}
+
+/** Events overwritten before they were flushed or cleared.
+ */
+inline std::uint64_t dropped() {
+    std::uint64_t n = 0;
+    for (auto* r = registry_head().load(std::memory_order_acquire);
+         r != nullptr; r = r->next) {
+        std::uint64_t h = r->head.load(std::memory_order_acquire);
+        std::uint64_t first = r->start.load(std::memory_order_relaxed);
+        n += h - first > kRingSize ? h - first - kRingSize : 0;
+    }
+    return n;
+}
+
+/** Forget the recorded events.
+ */
+inline void clear() {
+    for (auto* r = registry_head().load(std::memory_order_acquire);
+         r != nullptr; r = r->next) {
+        r->start.store(r->head.load(std::memory_order_acquire),
+                       std::memory_order_relaxed);
+    }
+}
+
+// microseconds with a fraction, as the format wants.
+inline void write_us_(std::ostream& out, std::uint64_t ns) {
+    char frac[4] = {char('0' + ns / 100 % 10), char('0' + ns / 10 % 10),
+                    char('0' + ns % 10), '\0'};
+    out << ns / 1000 << '.' << frac;
+}
+
+inline void write_string_(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s != '\0'; ++s) {
+        if (*s == '"' || *s == '\\') {
+            out << '\\';
+        }
+        out << *s;
+    }
+    out << '"';
+}
+
+/** The recorded events in the Chrome trace event format.
+ */
+inline void write_chrome_json(std::ostream& out) {
+    TickConverter clock;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for_each_event([&out, &first, &clock](const Event& e) {
+        out << (first ? "\n" : ",\n") << "{\"name\":";
+        write_string_(out, e.name);
+        out << ",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << e.tid
+            << ",\"ts\":";
+        write_us_(out, clock.to_ns(e.start));
+        if (e.phase == 'X') {
+            out << ",\"dur\":";
+            write_us_(out, clock.duration_ns(e.duration));
+        } else {
+            out << ",\"s\":\"t\"";
+        }
+        out << '}';
+        first = false;
+    });
+    out << "\n]}\n";
+}
+
+/** Returns false if the file cannot be written.
+ */
+inline bool write_chrome_json(const char* path) {
+    std::ofstream out(path);
+    write_chrome_json(out);
+    return static_cast<bool>(out);
+}
+
+}  // namespace trace
+}  // namespace detail
+}  // namespace learn_cpp
+
+#define LEARN_CPP_TRACE_CONCAT_(a, b) a##b
+#define LEARN_CPP_TRACE_NAME_(line) LEARN_CPP_TRACE_CONCAT_(trace_scope_, line)
+#define LEARN_CPP_TRACE_SCOPE(name) \
+    ::learn_cpp::detail::trace::Scope LEARN_CPP_TRACE_NAME_(__LINE__)(name)
+#define LEARN_CPP_TRACE_INSTANT(name) \
+    ::learn_cpp::detail::trace::instant(name)
+
+#else
+
+#define LEARN_CPP_TRACE_SCOPE(name) static_cast<void>(0)
+#define LEARN_CPP_TRACE_INSTANT(name) static_cast<void>(0)
+
+#endif
+
+#endif
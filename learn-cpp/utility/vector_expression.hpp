@@ -0,0 +1,241 @@
+#ifndef LEARN_CPP_UTILITY_VECTOR_EXPRESSION_HPP
+#define LEARN_CPP_UTILITY_VECTOR_EXPRESSION_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../implement-std-library/c++11/vector.hpp"
+#include "../template-metaprogarmming/container_traits.hpp"
+
+namespace learn_cpp {
+namespace detail {
+
+#if defined(DEBUG_VECTOR_EXPRESSION)
+#define ASSERT(expr, text) assert(expr)
+#else
+#define ASSERT(expr, text)
+#endif
+
+/*
+   Element-wise arithmetic on v1::vector<T> of arithmetic T, with expression
+   templates:
+
+       v1::vector<double> a, b, c, out;
+       assign(out, a * b + c);        // one loop, out's buffer is reused
+       auto d = evaluate(a * 2.0 - b);
+
+   An operator on vectors does not compute anything, it returns a small
+   object describing the operation (binary_expr<std::plus<>, L, R>), which
+   holds the data pointers of the vectors and the sub-expressions by value.
+   assign() and evaluate() run a single loop out[i] = e[i] over the whole
+   tree: no temporary vector, one pass over memory, and a loop body the
+   compiler inlines and vectorizes (GCC at -O3, with a runtime check that
+   out does not overlap the operands). evaluate() value-initializes the new
+   vector first; assign() into a vector of the right size is the single
+   pass.
+
+   The vectors must outlive the expression, and be of the same size:
+   building an expression over vectors of different sizes (an empty one
+   included) throws std::invalid_argument. Assigning into one of the
+   operands is fine, every element only depends on the operands at the
+   same index.
+ */
+
+struct vector_expression_base {};
+
+// The size() of a scalar: no size of its own, it takes the other side's.
+constexpr std::size_t kScalarSize = static_cast<std::size_t>(-1);
+
+/** CRTP base of the expressions, for the overloads below.
+ */
+template <class E>
+struct vector_expression : vector_expression_base {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+/** A v1::vector as a leaf.
+ */
+template <class T>
+class vector_ref : public vector_expression<vector_ref<T>> {
+   public:
+    using value_type = T;
+
+    template <class Allocator>
+    explicit vector_ref(const v1::vector<T, Allocator>& vec)
+        : data_(vec.data()), size_(vec.size()) {}
+
+    T operator[](std::size_t i) const { return data_[i]; }
+    std::size_t size() const { return size_; }
+
+   private:
+    const T* data_;
+    std::size_t size_;
+};
+
+/** A scalar, the same at every index.
+ */
+template <class T>
+class scalar_expr : public vector_expression<scalar_expr<T>> {
+   public:
+    using value_type = T;
+
+    explicit scalar_expr(T value) : value_(value) {}
+
+    T operator[](std::size_t) const { return value_; }
+    std::size_t size() const { return kScalarSize; }
+
+   private:
+    T value_;
+};
+
+template <class Op, class E>
+class unary_expr : public vector_expression<unary_expr<Op, E>> {
+   public:
+    using value_type = typename std::decay<decltype(
+        Op()(std::declval<typename E::value_type>()))>::type;
+
+    explicit unary_expr(E e) : e_(e) {}
+
+    value_type operator[](std::size_t i) const { return Op()(e_[i]); }
+    std::size_t size() const { return e_.size(); }
+
+   private:
+    E e_;
+};
+
+template <class Op, class L, class R>
+class binary_expr : public vector_expression<binary_expr<Op, L, R>> {
+   public:
+    using value_type = typename std::decay<decltype(
+        Op()(std::declval<typename L::value_type>(),
+             std::declval<typename R::value_type>()))>::type;
+
+    binary_expr(L l, R r) : l_(l), r_(r) {
+        if (l_.size() != r_.size() && l_.size() != kScalarSize &&
+            r_.size() != kScalarSize) {
+            throw std::invalid_argument(
+                "vector_expression: vectors of different sizes");
+        }
+    }
+
+    value_type operator[](std::size_t i) const {
+        return Op()(l_[i], r_[i]);
+    }
+
+    std::size_t size() const {
+        return l_.size() != kScalarSize ? l_.size() : r_.size();
+    }
+
+   private:
+    L l_;
+    R r_;
+};
+
+// IsVectorOperand: a vector or an expression, the things the operators
+// below take.
+template <class T>
+struct IsVectorOperand
+    : Integral<bool, std::is_base_of<vector_expression_base, T>::value> {};
+
+template <class T, class Allocator>
+struct IsVectorOperand<v1::vector<T, Allocator>>
+    : Integral<bool, std::is_arithmetic<T>::value> {};
+
+// The expression for an operand: a leaf for a vector or a scalar.
+template <class E>
+const E& as_expression(const vector_expression<E>& e) {
+    return e.self();
+}
+
+template <class T, class Allocator>
+vector_ref<T> as_expression(const v1::vector<T, Allocator>& vec) {
+    return vector_ref<T>(vec);
+}
+
+template <class T>
+typename EnableIf<std::is_arithmetic<T>::value, scalar_expr<T>>::type
+as_expression(T value) {
+    return scalar_expr<T>(value);
+}
+
+template <class T>
+using expression_t = typename std::decay<decltype(
+    as_expression(std::declval<const T&>()))>::type;
+
+// Either side an operand, the other an operand or a scalar.
+template <class L, class R>
+struct IsVectorOperation
+    : Integral<bool, (IsVectorOperand<L>::value &&
+                      (IsVectorOperand<R>::value ||
+                       std::is_arithmetic<R>::value)) ||
+                         (std::is_arithmetic<L>::value &&
+                          IsVectorOperand<R>::value)> {};
+
+template <class Op, class L, class R>
+using binary_t = typename EnableIf<
+    IsVectorOperation<L, R>::value,
+    binary_expr<Op, expression_t<L>, expression_t<R>>>::type;
+
+template <class L, class R>
+binary_t<std::plus<>, L, R> operator+(const L& l, const R& r) {
+    return {as_expression(l), as_expression(r)};
+}
+
+template <class L, class R>
+binary_t<std::minus<>, L, R> operator-(const L& l, const R& r) {
+    return {as_expression(l), as_expression(r)};
+}
+
+template <class L, class R>
+binary_t<std::multiplies<>, L, R> operator*(const L& l, const R& r) {
+    return {as_expression(l), as_expression(r)};
+}
+
+template <class L, class R>
+binary_t<std::divides<>, L, R> operator/(const L& l, const R& r) {
+    return {as_expression(l), as_expression(r)};
+}
+
+template <class E>
+typename EnableIf<IsVectorOperand<E>::value,
+                  unary_expr<std::negate<>, expression_t<E>>>::type
+operator-(const E& e) {
+    return unary_expr<std::negate<>, expression_t<E>>(as_expression(e));
+}
+
+/** out = e, element-wise, in one loop. out is resized to e.size() and
+    keeps its buffer when the capacity is enough.
+ */
+template <class T, class Allocator, class E>
+void assign(v1::vector<T, Allocator>& out, const vector_expression<E>& e) {
+    const E& expr = e.self();
+    std::size_t n = expr.size();
+    if (out.size() != n) {
+        out.resize(n);
+    }
+    T* p = out.data();
+    for (std::size_t i = 0; i < n; ++i) {
+        p[i] = static_cast<T>(expr[i]);
+    }
+}
+
+/** A new vector holding e.
+ */
+template <class E>
+v1::vector<typename E::value_type> evaluate(const vector_expression<E>& e) {
+    v1::vector<typename E::value_type> out;
+    out.reserve(e.self().size());
+    assign(out, e);
+    return out;
+}
+
+#undef ASSERT
+
+}  // namespace detail
+}  // namespace learn_cpp
+
+#endif